@@ -0,0 +1,119 @@
+# Copyright (c) 2026 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import argparse
+import math
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+
+addToPath('../')
+
+from common import ObjectList
+from common import MemConfig
+
+# this script drives a MultiChannelMemCtrl, which serves all the DRAM
+# channels behind a single port, with random traffic, and drains the
+# system every period so that the controller has to wait for the
+# responses of every channel before it reports being drained
+
+parser = argparse.ArgumentParser()
+
+parser.add_argument("--mem-type", default="DDR4_2400_8x8",
+                    choices=ObjectList.mem_list.get_names(),
+                    help = "type of memory to use for every channel")
+
+parser.add_argument("--channels", type=int, default=4,
+                    help = "Number of channels of the controller")
+
+parser.add_argument("--rd_perc", type=int, default=70,
+                    help = "Percentage of read commands")
+
+parser.add_argument("--periods", type=int, default=8,
+                    help = "Number of periods to simulate, the system is \
+                          drained at the end of each")
+
+args = parser.parse_args()
+
+intf = ObjectList.mem_list.get(args.mem_type)
+if not issubclass(intf, m5.objects.DRAMInterface):
+    fatal("MultiChannelMemCtrl only supports DRAM interfaces")
+if args.channels < 1 or args.channels & (args.channels - 1):
+    fatal("The number of channels must be a power of two")
+
+system = System(membus = IOXBar(width = 32))
+system.clk_domain = SrcClockDomain(clock = '2.0GHz',
+                                   voltage_domain =
+                                   VoltageDomain(voltage = '1V'))
+
+mem_range = AddrRange('256MB')
+system.mem_ranges = [mem_range]
+system.mmap_using_noreserve = True
+
+# interleave the channels at the granularity of a cache line, as
+# MemConfig does for separate controllers
+line_size = 64
+intlv_bits = int(math.log(args.channels, 2))
+channels = [MemConfig.create_mem_intf(intf, mem_range, i, intlv_bits,
+                                      line_size, 0)
+            for i in range(args.channels)]
+for channel in channels:
+    channel.null = True
+
+system.mem_ctrl = MultiChannelMemCtrl(dram = channels[0],
+                                      extra_channels = channels[1:])
+system.mem_ctrl.port = system.membus.mem_side_ports
+
+system.tgen = PyTrafficGen()
+system.tgen.port = system.membus.cpu_side_ports
+system.system_port = system.membus.cpu_side_ports
+
+# stay in each period long enough for all the channels to be busy, and
+# issue requests faster than a single channel can serve them
+period = 10000000
+itt = 1000
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+def traffic():
+    yield system.tgen.createRandom(period * args.periods,
+                                   0, mem_range.end, line_size,
+                                   itt, itt, args.rd_perc, 0)
+    yield system.tgen.createExit(0)
+
+system.tgen.start(traffic())
+
+for i in range(args.periods):
+    exit_event = m5.simulate(period)
+    if exit_event.getCause() != "simulate() limit reached":
+        break
+    m5.drain()
+
+print("Simulated %d channels for %d periods" % (args.channels, i + 1))
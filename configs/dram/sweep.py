@@ -78,6 +78,10 @@ parser.add_argument("--addr-map",
                     choices=ObjectList.dram_addr_map_list.get_names(),
                     default="RoRaBaCoCh", help = "DRAM address map policy")
 
+parser.add_argument("--check-frfcfs-index", action="store_true",
+                    help = "Check every scheduling decision against a scan \
+                          of the whole queue")
+
 args = parser.parse_args()
 
 # at the moment we stay with the default open-adaptive page policy,
@@ -119,6 +123,8 @@ system.mem_ctrls[0].dram.null = True
 # Set the address mapping based on input argument
 system.mem_ctrls[0].dram.addr_mapping = args.addr_map
 
+system.mem_ctrls[0].dram.check_frfcfs_index = args.check_frfcfs_index
+
 # stay in each state for 0.25 ms, long enough to warm things up, and
 # short enough to avoid hitting a refresh
 period = 250000000
@@ -0,0 +1,97 @@
+# Copyright (c) 2026 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script stresses a DRAM controller with the many streams of a
+# MultiStreamTrafficGen. The system is drained at the end of every
+# interval, and optionally checkpointed, while the streams have requests
+# in flight.
+
+import argparse
+import os
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser(
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("--streams", type=int, default=256,
+                    help="Number of streams")
+parser.add_argument("--pattern", default="random",
+                    choices=["linear", "random"],
+                    help="Access pattern of the streams")
+parser.add_argument("--read-percent", type=int, default=70,
+                    help="Percentage of reads")
+parser.add_argument("--period", type=int, default=64,
+                    help="Cycles between two requests of a stream")
+parser.add_argument("--max-outstanding", type=int, default=4,
+                    help="Maximum number of outstanding requests per stream")
+parser.add_argument("--intervals", type=int, default=4,
+                    help="Number of intervals to simulate")
+parser.add_argument("--interval", type=int, default=10000000,
+                    help="Length of an interval in ticks")
+parser.add_argument("--checkpoint-dir", default=None,
+                    help="Take a checkpoint in this directory after the "
+                         "first interval")
+
+args = parser.parse_args()
+
+system = System(membus = SystemXBar())
+system.clk_domain = SrcClockDomain(clock = '2GHz',
+                                   voltage_domain = VoltageDomain())
+system.mem_ranges = [AddrRange('512MB')]
+system.mmap_using_noreserve = True
+
+system.tgen = MultiStreamTrafficGen(
+    num_streams = args.streams, pattern = args.pattern,
+    mem_size = '512MB', read_percent = args.read_percent,
+    period = args.period, max_outstanding = args.max_outstanding)
+system.tgen.port = system.membus.cpu_side_ports
+
+system.mem_ctrl = MemCtrl(dram = DDR4_2400_8x8(range = system.mem_ranges[0]))
+system.mem_ctrl.dram.null = True
+system.mem_ctrl.port = system.membus.mem_side_ports
+
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+for i in range(args.intervals):
+    exit_event = m5.simulate(args.interval)
+    if exit_event.getCause() != "simulate() limit reached":
+        m5.fatal("Unexpected exit: %s" % exit_event.getCause())
+
+    # the generator only reports being drained once all the requests of
+    # its streams are back
+    m5.drain()
+    if i == 0 and args.checkpoint_dir:
+        m5.checkpoint(os.path.join(args.checkpoint_dir, "cpt.%d" %
+                                   m5.curTick()))
+
+print("Simulated %d streams for %d intervals" % (args.streams, args.intervals))
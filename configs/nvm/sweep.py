@@ -72,6 +72,9 @@ parser.add_argument("--mode", default="NVM",
                     choices=nvm_generators.keys(),
                     help = "NVM: Random traffic")
 
+parser.add_argument("--nvm-xpbuffer-entries", type=int, default=0,
+                    help = "Lines in the NVM write-combining buffer")
+
 parser.add_argument("--addr-map",
                     choices=ObjectList.dram_addr_map_list.get_names(),
                     default="RoRaBaCoCh", help = "NVM address map policy")
@@ -115,6 +118,9 @@ system.mem_ctrls[0].dram.null = True
 # Set the address mapping based on input argument
 system.mem_ctrls[0].dram.addr_mapping = args.addr_map
 
+# Merge NVM writes in the write-combining buffer if requested
+system.mem_ctrls[0].dram.xpbuffer_entries = args.nvm_xpbuffer_entries
+
 # stay in each state for 0.25 ms, long enough to warm things up, and
 # short enough to avoid hitting a refresh
 period = 250000000
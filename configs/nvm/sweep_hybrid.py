@@ -82,6 +82,9 @@ parser.add_argument("--mode", default="HYBRID",
                     choices=hybrid_generators.keys(),
                     help = "Hybrid: Random DRAM + NVM traffic")
 
+parser.add_argument("--nvm-xpbuffer-entries", type=int, default=0,
+                    help = "Lines in the NVM write-combining buffer")
+
 parser.add_argument("--addr-map",
                     choices=ObjectList.dram_addr_map_list.get_names(),
                     default="RoRaBaCoCh", help = "NVM address map policy")
@@ -132,6 +135,9 @@ system.mem_ctrls[0].nvm.null = True
 system.mem_ctrls[0].dram.addr_mapping = args.addr_map
 system.mem_ctrls[0].nvm.addr_mapping = args.addr_map
 
+# Merge NVM writes in the write-combining buffer if requested
+system.mem_ctrls[0].nvm.xpbuffer_entries = args.nvm_xpbuffer_entries
+
 # stay in each state for 0.25 ms, long enough to warm things up, and
 # short enough to avoid hitting a refresh
 period = 250000000
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_HYPERLOGLOG_HH__
+#define __BASE_HYPERLOGLOG_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+
+namespace gem5
+{
+
+/**
+ * HyperLogLog estimator of the number of distinct values inserted in
+ * it (Flajolet et al., AofA'07), using a fixed amount of memory.
+ *
+ * The hash of a value selects one of 2^precision registers, and the
+ * register keeps the maximum number of leading zeros seen in the rest
+ * of the hash, plus one. The relative standard error of the estimate
+ * is about 1.04 / sqrt(2^precision).
+ *
+ * The harmonic sum of the registers is kept up to date on every
+ * insertion, so that the estimate can be read after every insertion
+ * at no cost.
+ */
+class HyperLogLog
+{
+  public:
+    /**
+     * @param _precision Log2 of the number of registers, from 4 to 18
+     */
+    explicit HyperLogLog(unsigned _precision)
+        : precision(_precision), registers(1ULL << precision, 0),
+          inverseSum(registers.size()), zeros(registers.size())
+    {
+        assert(precision >= 4 && precision <= 18);
+    }
+
+    /** Number of registers, i.e., bytes used by the estimator */
+    size_t size() const { return registers.size(); }
+
+    /**
+     * Add a value to the set.
+     *
+     * @param value The value
+     */
+    void
+    insert(uint64_t value)
+    {
+        const uint64_t hash = mix(value);
+        const uint64_t index = hash >> (64 - precision);
+        const uint64_t rest = hash << precision;
+        const uint8_t rank = rest ? 64 - findMsbSet(rest) :
+            64 - precision + 1;
+
+        uint8_t &reg = registers[index];
+        if (rank > reg) {
+            if (reg == 0)
+                zeros--;
+            inverseSum += std::ldexp(1.0, -rank) - std::ldexp(1.0, -reg);
+            reg = rank;
+        }
+    }
+
+    /**
+     * Estimate the number of distinct values added to the set.
+     *
+     * @return The estimate
+     */
+    double
+    estimate() const
+    {
+        const double m = registers.size();
+        const double raw = alpha() * m * m / inverseSum;
+
+        // Use linear counting on the empty registers for small sets
+        if (raw <= 2.5 * m && zeros > 0)
+            return m * std::log(m / zeros);
+        return raw;
+    }
+
+    /** Remove all values from the set */
+    void
+    clear()
+    {
+        std::fill(registers.begin(), registers.end(), 0);
+        inverseSum = registers.size();
+        zeros = registers.size();
+    }
+
+  private:
+    /** Spread the bits of a value, as addresses are far from random */
+    static uint64_t
+    mix(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    /** Bias correction constant */
+    double
+    alpha() const
+    {
+        switch (registers.size()) {
+          case 16:
+            return 0.673;
+          case 32:
+            return 0.697;
+          case 64:
+            return 0.709;
+          default:
+            return 0.7213 / (1.0 + 1.079 / registers.size());
+        }
+    }
+
+    const unsigned precision;
+
+    std::vector<uint8_t> registers;
+
+    /** Sum of 2^-register over all registers */
+    double inverseSum;
+
+    /** Number of registers still at 0 */
+    uint64_t zeros;
+};
+
+} // namespace gem5
+
+#endif // __BASE_HYPERLOGLOG_HH__
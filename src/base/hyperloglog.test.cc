@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "base/hyperloglog.hh"
+
+using namespace gem5;
+
+/** An empty set is estimated empty */
+TEST(HyperLogLogTest, Empty)
+{
+    HyperLogLog hll(12);
+
+    ASSERT_EQ(hll.size(), 4096);
+    ASSERT_EQ(hll.estimate(), 0);
+}
+
+/** Inserting the same values again does not change the estimate */
+TEST(HyperLogLogTest, Duplicates)
+{
+    HyperLogLog hll(12);
+
+    for (uint64_t i = 0; i < 1000; i++)
+        hll.insert(i * 64);
+    const double estimate = hll.estimate();
+    for (uint64_t i = 0; i < 1000; i++)
+        hll.insert(i * 64);
+
+    ASSERT_EQ(hll.estimate(), estimate);
+}
+
+/** The estimates are within a few standard errors of the cardinality */
+TEST(HyperLogLogTest, Accuracy)
+{
+    const unsigned precision = 12;
+    const double error = 1.04 / std::sqrt(1 << precision);
+    HyperLogLog hll(precision);
+
+    uint64_t inserted = 0;
+    for (uint64_t count : {100, 1000, 10000, 100000, 1000000}) {
+        for (; inserted < count; inserted++)
+            hll.insert(inserted * 4096);
+        ASSERT_NEAR(hll.estimate(), count, 4 * error * count);
+    }
+}
+
+/** Clearing the set resets the estimate */
+TEST(HyperLogLogTest, Clear)
+{
+    HyperLogLog hll(8);
+
+    for (uint64_t i = 0; i < 10000; i++)
+        hll.insert(i);
+    hll.clear();
+
+    ASSERT_EQ(hll.estimate(), 0);
+    hll.insert(1);
+    ASSERT_NEAR(hll.estimate(), 1, 0.01);
+}
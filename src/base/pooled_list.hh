@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_POOLED_LIST_HH__
+#define __BASE_POOLED_LIST_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gem5
+{
+
+/**
+ * Doubly linked list whose nodes come from a pool shared by a set of
+ * lists. The pool allocates its nodes in chunks up front and recycles
+ * them, so that adding an element to a list does not go to the heap,
+ * and moving an element from one list to another of the same pool
+ * (splice) does not copy it.
+ *
+ * A list without a pool allocates its nodes on the heap.
+ *
+ * @tparam T Type of the elements in the list
+ */
+template <typename T>
+class PooledList
+{
+  private:
+    struct Node
+    {
+        Node *prev;
+        Node *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T *item() { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    template <bool IsConst>
+    class Iterator
+    {
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T *, T *>;
+        using reference = std::conditional_t<IsConst, const T &, T &>;
+
+        Iterator() : node(nullptr) {}
+        explicit Iterator(Node *_node) : node(_node) {}
+
+        /** Allow converting an iterator to a const iterator */
+        template <bool C = IsConst, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false> &other) : node(other.node) {}
+
+        reference operator*() const { return *node->item(); }
+        pointer operator->() const { return node->item(); }
+
+        Iterator &operator++() { node = node->next; return *this; }
+        Iterator &operator--() { node = node->prev; return *this; }
+
+        Iterator
+        operator++(int)
+        {
+            Iterator it = *this;
+            node = node->next;
+            return it;
+        }
+
+        Iterator
+        operator--(int)
+        {
+            Iterator it = *this;
+            node = node->prev;
+            return it;
+        }
+
+        bool operator==(const Iterator &other) const
+        { return node == other.node; }
+        bool operator!=(const Iterator &other) const
+        { return node != other.node; }
+
+      private:
+        Node *node;
+
+        friend class PooledList;
+        friend class Iterator<!IsConst>;
+    };
+
+  public:
+    using value_type = T;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /**
+     * Pool of list nodes. A pool has to outlive the lists using it.
+     */
+    class Pool
+    {
+      public:
+        /**
+         * @param capacity Number of nodes to allocate up front
+         * @param chunk_size Number of nodes to add when the pool is empty
+         */
+        Pool(size_t capacity, size_t chunk_size)
+            : freeNodes(nullptr), chunkSize(chunk_size ? chunk_size : 1),
+              _capacity(0), _inUse(0)
+        {
+            if (capacity)
+                grow(capacity);
+        }
+
+        Pool(const Pool &) = delete;
+        Pool &operator=(const Pool &) = delete;
+
+        /** Number of nodes owned by the pool */
+        size_t capacity() const { return _capacity; }
+
+        /** Number of nodes currently used by a list */
+        size_t inUse() const { return _inUse; }
+
+      private:
+        /** Add nodes to the free list */
+        void
+        grow(size_t nodes)
+        {
+            chunks.emplace_back(new Node[nodes]);
+            Node *chunk = chunks.back().get();
+            for (size_t i = 0; i < nodes; i++) {
+                chunk[i].next = freeNodes;
+                freeNodes = &chunk[i];
+            }
+            _capacity += nodes;
+        }
+
+        Node *
+        get()
+        {
+            if (!freeNodes)
+                grow(chunkSize);
+            Node *node = freeNodes;
+            freeNodes = node->next;
+            _inUse++;
+            return node;
+        }
+
+        void
+        put(Node *node)
+        {
+            assert(_inUse > 0);
+            node->next = freeNodes;
+            freeNodes = node;
+            _inUse--;
+        }
+
+        std::vector<std::unique_ptr<Node[]>> chunks;
+        Node *freeNodes;
+        const size_t chunkSize;
+        size_t _capacity;
+        size_t _inUse;
+
+        friend class PooledList;
+    };
+
+    explicit PooledList(Pool *pool = nullptr) : _pool(pool), _size(0)
+    {
+        resetHead();
+    }
+
+    /** Copies the elements of a list, using the same pool */
+    PooledList(const PooledList &other) : _pool(other._pool), _size(0)
+    {
+        resetHead();
+        for (const auto &item : other)
+            push_back(item);
+    }
+
+    PooledList(PooledList &&other) : _pool(other._pool), _size(0)
+    {
+        resetHead();
+        if (!other.empty()) {
+            head.next = other.head.next;
+            head.prev = other.head.prev;
+            head.next->prev = &head;
+            head.prev->next = &head;
+            _size = other._size;
+            other.resetHead();
+            other._size = 0;
+        }
+    }
+
+    PooledList &operator=(const PooledList &) = delete;
+    PooledList &operator=(PooledList &&) = delete;
+
+    ~PooledList() { clear(); }
+
+    Pool *pool() const { return _pool; }
+
+    /**
+     * Change the pool of the list. The list has to be empty.
+     *
+     * @param pool The pool to use, nullptr to use the heap
+     */
+    void
+    setPool(Pool *pool)
+    {
+        assert(empty());
+        _pool = pool;
+    }
+
+    iterator begin() { return iterator(head.next); }
+    iterator end() { return iterator(&head); }
+    const_iterator begin() const { return const_iterator(head.next); }
+    const_iterator
+    end() const
+    {
+        return const_iterator(const_cast<Node *>(&head));
+    }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+
+    T &front() { assert(!empty()); return *head.next->item(); }
+    const T &front() const { assert(!empty()); return *head.next->item(); }
+    T &back() { assert(!empty()); return *head.prev->item(); }
+    const T &back() const { assert(!empty()); return *head.prev->item(); }
+
+    template <typename... Args>
+    T &
+    emplace_back(Args&&... args)
+    {
+        Node *node = _pool ? _pool->get() : new Node;
+        new (node->storage) T(std::forward<Args>(args)...);
+        link(&head, node);
+        return *node->item();
+    }
+
+    void push_back(const T &item) { emplace_back(item); }
+
+    void pop_front() { erase(begin()); }
+
+    /**
+     * Remove an element from the list.
+     *
+     * @param pos Iterator to the element
+     * @return Iterator to the next element
+     */
+    iterator
+    erase(const_iterator pos)
+    {
+        assert(pos != end());
+        Node *node = pos.node;
+        Node *next = node->next;
+        unlink(node);
+        node->item()->~T();
+        if (_pool)
+            _pool->put(node);
+        else
+            delete node;
+        return iterator(next);
+    }
+
+    void
+    clear()
+    {
+        while (!empty())
+            pop_front();
+    }
+
+    /**
+     * Move an element of a list of the same pool before a position of
+     * this list, without copying it.
+     *
+     * @param pos Position to move the element to
+     * @param other List the element is in, can be this list
+     * @param it The element to move
+     */
+    void
+    splice(const_iterator pos, PooledList &other, const_iterator it)
+    {
+        assert(_pool == other._pool);
+        assert(it != other.end());
+        Node *node = it.node;
+        if (node == pos.node)
+            return;
+        other.unlink(node);
+        link(pos.node, node);
+    }
+
+    /**
+     * Move a range of elements of a list of the same pool before a
+     * position of this list, without copying them.
+     *
+     * @param pos Position to move the elements to, not in the range
+     * @param other List the elements are in
+     * @param first First element to move
+     * @param last Element after the last one to move
+     */
+    void
+    splice(const_iterator pos, PooledList &other, const_iterator first,
+           const_iterator last)
+    {
+        while (first != last)
+            splice(pos, other, first++);
+    }
+
+  private:
+    void
+    resetHead()
+    {
+        head.next = &head;
+        head.prev = &head;
+    }
+
+    /** Insert a node before another one */
+    void
+    link(Node *pos, Node *node)
+    {
+        node->next = pos;
+        node->prev = pos->prev;
+        pos->prev->next = node;
+        pos->prev = node;
+        _size++;
+    }
+
+    void
+    unlink(Node *node)
+    {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        assert(_size > 0);
+        _size--;
+    }
+
+    Pool *_pool;
+
+    /** Sentinel of the circular list, its item is never constructed */
+    Node head;
+
+    size_t _size;
+};
+
+} // namespace gem5
+
+#endif // __BASE_POOLED_LIST_HH__
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/pooled_list.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+std::vector<int>
+toVector(const PooledList<int> &list)
+{
+    return std::vector<int>(list.begin(), list.end());
+}
+
+} // anonymous namespace
+
+/** A new list is empty and takes no node from its pool */
+TEST(PooledListTest, Empty)
+{
+    PooledList<int>::Pool pool(4, 2);
+    PooledList<int> list(&pool);
+
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(list.size(), 0);
+    ASSERT_EQ(list.begin(), list.end());
+    ASSERT_EQ(pool.capacity(), 4);
+    ASSERT_EQ(pool.inUse(), 0);
+}
+
+/** Elements are kept in insertion order and returned to the pool */
+TEST(PooledListTest, PushPop)
+{
+    PooledList<int>::Pool pool(4, 2);
+    {
+        PooledList<int> list(&pool);
+        for (int i = 0; i < 3; i++)
+            list.push_back(i);
+
+        ASSERT_EQ(toVector(list), std::vector<int>({0, 1, 2}));
+        ASSERT_EQ(list.front(), 0);
+        ASSERT_EQ(list.back(), 2);
+        ASSERT_EQ(pool.inUse(), 3);
+
+        list.pop_front();
+        ASSERT_EQ(toVector(list), std::vector<int>({1, 2}));
+        ASSERT_EQ(pool.inUse(), 2);
+    }
+    ASSERT_EQ(pool.inUse(), 0);
+}
+
+/** The pool grows by chunks once its initial nodes are used */
+TEST(PooledListTest, Grow)
+{
+    PooledList<int>::Pool pool(2, 3);
+    PooledList<int> list(&pool);
+    for (int i = 0; i < 3; i++)
+        list.push_back(i);
+
+    ASSERT_EQ(pool.capacity(), 5);
+    ASSERT_EQ(pool.inUse(), 3);
+
+    // freed nodes are reused before growing again
+    list.clear();
+    for (int i = 0; i < 5; i++)
+        list.push_back(i);
+    ASSERT_EQ(pool.capacity(), 5);
+}
+
+/** Erasing returns the next element */
+TEST(PooledListTest, Erase)
+{
+    PooledList<int> list;
+    for (int i = 0; i < 6; i++)
+        list.push_back(i);
+
+    auto it = list.begin();
+    while (it != list.end()) {
+        if (*it % 2)
+            it = list.erase(it);
+        else
+            it++;
+    }
+    ASSERT_EQ(toVector(list), std::vector<int>({0, 2, 4}));
+    ASSERT_EQ(list.size(), 3);
+}
+
+/** Splicing moves elements between lists without using more nodes */
+TEST(PooledListTest, Splice)
+{
+    PooledList<int>::Pool pool(8, 8);
+    PooledList<int> from(&pool);
+    PooledList<int> to(&pool);
+    for (int i = 0; i < 5; i++)
+        from.push_back(i);
+    to.push_back(10);
+
+    to.splice(to.end(), from, from.begin());
+    ASSERT_EQ(toVector(from), std::vector<int>({1, 2, 3, 4}));
+    ASSERT_EQ(toVector(to), std::vector<int>({10, 0}));
+
+    auto last = std::find(from.begin(), from.end(), 3);
+    to.splice(to.begin(), from, from.begin(), last);
+    ASSERT_EQ(toVector(from), std::vector<int>({3, 4}));
+    ASSERT_EQ(toVector(to), std::vector<int>({1, 2, 10, 0}));
+    ASSERT_EQ(from.size(), 2);
+    ASSERT_EQ(to.size(), 4);
+    ASSERT_EQ(pool.inUse(), 6);
+}
+
+/** Copies use the same pool, moves take over the nodes */
+TEST(PooledListTest, CopyMove)
+{
+    PooledList<int>::Pool pool(8, 8);
+    PooledList<int> list(&pool);
+    list.push_back(1);
+    list.push_back(2);
+
+    PooledList<int> copy(list);
+    ASSERT_EQ(copy.pool(), &pool);
+    ASSERT_EQ(toVector(copy), toVector(list));
+    ASSERT_EQ(pool.inUse(), 4);
+
+    PooledList<int> moved(std::move(copy));
+    ASSERT_TRUE(copy.empty());
+    ASSERT_EQ(toVector(moved), std::vector<int>({1, 2}));
+    ASSERT_EQ(pool.inUse(), 4);
+
+    moved.push_back(3);
+    ASSERT_EQ(*--moved.end(), 3);
+}
@@ -0,0 +1,72 @@
+# Copyright (c) 2026 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.objects.ClockedObject import ClockedObject
+
+class MultiStreamPattern(ScopedEnum): vals = [ 'linear', 'random' ]
+
+class MultiStreamTrafficGen(ClockedObject):
+    """
+    This ClockedObject hosts many independent streams of synthetic memory
+    requests behind a single port. Each stream accesses its own slice of
+    the memory, and issues a request every period cycles while it has less
+    than max_outstanding requests in flight. It is meant to stress large
+    memory systems with hundreds of streams without a traffic generator
+    per stream.
+    """
+    type = 'MultiStreamTrafficGen'
+    cxx_header = "cpu/testers/traffic_gen/multi_stream_gen.hh"
+    cxx_class = "gem5::MultiStreamTrafficGen"
+
+    system = Param.System(Parent.any, 'System this generator is a part of')
+
+    port = RequestPort('Port that should be connected to other components')
+
+    num_streams = Param.Unsigned(64, 'Number of streams')
+
+    pattern = Param.MultiStreamPattern('random', 'Whether the streams'
+                            ' access their slice of memory linearly or at'
+                            ' random')
+
+    start_addr = Param.Addr(0, 'Start address of the memory accessed by the'
+                            ' streams')
+
+    mem_size = Param.MemorySize('Size of the memory accessed by the streams,'
+                            ' split evenly between them')
+
+    block_size = Param.Unsigned(64, 'Size of the requests in bytes')
+
+    read_percent = Param.Percent(100, 'Percentage of reads')
+
+    period = Param.Cycles(1, 'Cycles between two requests of a stream')
+
+    max_outstanding = Param.Unsigned(16, 'Maximum number of outstanding'
+                            ' requests per stream')
+
+    max_requests = Param.UInt64(0, 'Number of requests of each stream before'
+                            ' the simulation is over, 0 for no limit')
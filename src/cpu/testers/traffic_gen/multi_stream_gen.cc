@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/multi_stream_gen.hh"
+
+#include <algorithm>
+
+#include "base/cast.hh"
+#include "base/intmath.hh"
+#include "base/random.hh"
+#include "base/trace.hh"
+#include "debug/Drain.hh"
+#include "sim/serialize.hh"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+MultiStreamTrafficGen::MultiStreamTrafficGen(
+        const MultiStreamTrafficGenParams &params) :
+    ClockedObject(params),
+    generateEvent([this]{ generate(); }, name()),
+    system(params.system),
+    requestorId(system->getRequestorId(this)),
+    port(name() + ".port", this),
+    numStreams(params.num_streams),
+    pattern(params.pattern),
+    blockSize(params.block_size),
+    startAddr(params.start_addr),
+    blocksPerStream(params.num_streams ?
+                    params.mem_size / params.num_streams /
+                    params.block_size : 0),
+    readPercent(params.read_percent),
+    period(params.period),
+    maxOutstanding(params.max_outstanding),
+    maxRequests(params.max_requests),
+    rngState(numStreams),
+    nextBlock(numStreams, 0),
+    outstanding(numStreams, 0),
+    issued(numStreams, 0),
+    numReady(numStreams),
+    totalOutstanding(0),
+    streamsPerCycle(period ? divCeil(numStreams, (unsigned)period) : 0),
+    genBlocks(streamsPerCycle),
+    genWrites(streamsPerCycle),
+    waitingRetry(false),
+    stats(this, numStreams)
+{
+    fatal_if(numStreams == 0, "%s needs at least one stream\n", name());
+    fatal_if(period == 0, "%s needs a period of at least a cycle\n",
+             name());
+    fatal_if(maxOutstanding == 0,
+             "%s needs at least one outstanding request per stream\n",
+             name());
+    fatal_if(blockSize == 0 || blockSize > system->cacheLineSize(),
+             "%s block size (%d) must be between 1 and the cache line "
+             "size (%d)\n", name(), blockSize, system->cacheLineSize());
+    fatal_if(blocksPerStream == 0,
+             "%s has less than a block of memory per stream\n", name());
+
+    // Seed the streams from the simulator's generator, so that they
+    // follow its seed, and keep the xorshift states non-zero
+    for (auto &state : rngState)
+        state = random_mt.random<uint64_t>() | 1;
+}
+
+MultiStreamTrafficGen::~MultiStreamTrafficGen()
+{
+    for (auto pkt : sendQueue) {
+        delete pkt->popSenderState();
+        delete pkt;
+    }
+}
+
+Port &
+MultiStreamTrafficGen::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name != "port") {
+        return ClockedObject::getPort(if_name, idx);
+    } else {
+        return port;
+    }
+}
+
+void
+MultiStreamTrafficGen::startup()
+{
+    scheduleGenerate();
+}
+
+void
+MultiStreamTrafficGen::generate()
+{
+    // The streams issue in turn over the cycles of a period
+    const unsigned begin = std::min<uint64_t>(
+        numStreams, curCycle() % period * streamsPerCycle);
+    const unsigned end = std::min(numStreams, begin + streamsPerCycle);
+    const unsigned count = end - begin;
+
+    // Advance the xorshift64* generators of all the streams of the
+    // cycle, even those that cannot issue, in a loop without branches
+    // that the compiler can vectorize
+    for (unsigned i = 0; i < count; i++) {
+        uint64_t x = rngState[begin + i];
+        x ^= x >> 12;
+        x ^= x << 25;
+        x ^= x >> 27;
+        rngState[begin + i] = x;
+        const uint64_t r = x * 0x2545f4914f6cdd1dULL;
+
+        // Scale the number to the blocks of a stream, with the high half
+        // of its product with the number of blocks, and its low bits to
+        // a percentage for the type of the request
+        uint64_t block, low;
+        mulUnsigned<uint64_t>(block, low, r, blocksPerStream);
+        genBlocks[i] = block;
+        genWrites[i] = ((r & 0xffff) * 100 >> 16) >= readPercent;
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        const unsigned stream = begin + i;
+        if (streamDone(stream))
+            continue;
+        if (outstanding[stream] >= maxOutstanding) {
+            stats.stalls[stream]++;
+            continue;
+        }
+
+        uint64_t block = genBlocks[i];
+        if (pattern == MultiStreamPattern::linear) {
+            block = nextBlock[stream];
+            nextBlock[stream] = block + 1 == blocksPerStream ? 0 : block + 1;
+        }
+        const Addr addr =
+            startAddr + (stream * blocksPerStream + block) * blockSize;
+        const bool is_write = genWrites[i];
+
+        RequestPtr req = std::make_shared<Request>(addr, blockSize, 0,
+                                                   requestorId);
+        // Give each stream a PC of its own, so that PC-based prefetchers
+        // tell the streams apart
+        req->setPC((((Addr)requestorId << 32) | stream) << 2);
+
+        PacketPtr pkt = new Packet(req, is_write ? MemCmd::WriteReq :
+                                                   MemCmd::ReadReq);
+        uint8_t* pkt_data = new uint8_t[blockSize];
+        pkt->dataDynamic(pkt_data);
+        if (is_write)
+            std::fill_n(pkt_data, blockSize, (uint8_t)stream);
+        pkt->pushSenderState(new StreamState(stream, curTick()));
+        sendQueue.push_back(pkt);
+
+        issued[stream]++;
+        outstanding[stream]++;
+        totalOutstanding++;
+        if (outstanding[stream] == maxOutstanding || streamDone(stream))
+            numReady--;
+    }
+
+    sendPackets();
+    scheduleGenerate();
+}
+
+void
+MultiStreamTrafficGen::scheduleGenerate()
+{
+    // Responses reschedule the generation when streams are stalled, no
+    // request is generated while draining
+    if (numReady > 0 && !generateEvent.scheduled() &&
+        drainState() == DrainState::Running) {
+        schedule(generateEvent, nextCycle());
+    }
+}
+
+void
+MultiStreamTrafficGen::sendPackets()
+{
+    while (!waitingRetry && !sendQueue.empty()) {
+        if (!port.sendTimingReq(sendQueue.front())) {
+            waitingRetry = true;
+            break;
+        }
+        sendQueue.pop_front();
+    }
+}
+
+bool
+MultiStreamTrafficGen::recvTimingResp(PacketPtr pkt)
+{
+    StreamState *state = safe_cast<StreamState *>(pkt->popSenderState());
+    const unsigned stream = state->stream;
+
+    if (pkt->isRead()) {
+        stats.reads[stream]++;
+        stats.bytesRead[stream] += pkt->getSize();
+    } else {
+        stats.writes[stream]++;
+        stats.bytesWritten[stream] += pkt->getSize();
+    }
+    stats.totalLatency[stream] += curTick() - state->issueTick;
+
+    if (outstanding[stream] == maxOutstanding && !streamDone(stream))
+        numReady++;
+    outstanding[stream]--;
+    totalOutstanding--;
+
+    delete state;
+    delete pkt;
+
+    checkDrain();
+
+    if (maxRequests != 0 && numReady == 0 && totalOutstanding == 0) {
+        exitSimLoop(name() + " is finished with its streams.\n");
+        return true;
+    }
+
+    scheduleGenerate();
+    return true;
+}
+
+void
+MultiStreamTrafficGen::recvReqRetry()
+{
+    assert(waitingRetry);
+    waitingRetry = false;
+    sendPackets();
+}
+
+void
+MultiStreamTrafficGen::checkDrain()
+{
+    if (drainState() == DrainState::Draining && sendQueue.empty() &&
+        totalOutstanding == 0) {
+        DPRINTF(Drain, "%s done draining\n", name());
+        signalDrainDone();
+    }
+}
+
+DrainState
+MultiStreamTrafficGen::drain()
+{
+    // stop issuing, the queued requests are still sent as the port
+    // allows it
+    if (generateEvent.scheduled())
+        deschedule(generateEvent);
+
+    if (sendQueue.empty() && totalOutstanding == 0)
+        return DrainState::Drained;
+    return DrainState::Draining;
+}
+
+void
+MultiStreamTrafficGen::drainResume()
+{
+    scheduleGenerate();
+}
+
+void
+MultiStreamTrafficGen::serialize(CheckpointOut &cp) const
+{
+    // the generator is drained, so no request is in flight and only the
+    // progress of the streams has to be kept
+    assert(sendQueue.empty() && totalOutstanding == 0);
+
+    SERIALIZE_CONTAINER(rngState);
+    SERIALIZE_CONTAINER(nextBlock);
+    SERIALIZE_CONTAINER(issued);
+}
+
+void
+MultiStreamTrafficGen::unserialize(CheckpointIn &cp)
+{
+    UNSERIALIZE_CONTAINER(rngState);
+    UNSERIALIZE_CONTAINER(nextBlock);
+    UNSERIALIZE_CONTAINER(issued);
+
+    fatal_if(rngState.size() != numStreams || nextBlock.size() != numStreams
+             || issued.size() != numStreams,
+             "%s checkpoint has a different number of streams\n", name());
+
+    numReady = 0;
+    for (unsigned stream = 0; stream < numStreams; stream++) {
+        if (!streamDone(stream))
+            numReady++;
+    }
+}
+
+MultiStreamTrafficGen::StatGroup::StatGroup(MultiStreamTrafficGen *parent,
+                                            unsigned num_streams) :
+    statistics::Group(parent),
+    ADD_STAT(reads, statistics::units::Count::get(),
+             "Number of reads of each stream"),
+    ADD_STAT(writes, statistics::units::Count::get(),
+             "Number of writes of each stream"),
+    ADD_STAT(bytesRead, statistics::units::Byte::get(),
+             "Number of bytes read by each stream"),
+    ADD_STAT(bytesWritten, statistics::units::Byte::get(),
+             "Number of bytes written by each stream"),
+    ADD_STAT(totalLatency, statistics::units::Tick::get(),
+             "Total latency of the requests of each stream"),
+    ADD_STAT(avgLatency, statistics::units::Rate<
+                statistics::units::Tick, statistics::units::Count>::get(),
+             "Average latency of the requests of each stream"),
+    ADD_STAT(stalls, statistics::units::Count::get(),
+             "Number of times each stream could not issue a request as "
+             "it had too many requests outstanding")
+{
+    reads.init(num_streams);
+    writes.init(num_streams);
+    bytesRead.init(num_streams);
+    bytesWritten.init(num_streams);
+    totalLatency.init(num_streams);
+    stalls.init(num_streams);
+
+    avgLatency.precision(2);
+    avgLatency = totalLatency / (reads + writes);
+}
+
+} // namespace gem5
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_TESTERS_TRAFFIC_GEN_MULTI_STREAM_GEN_HH__
+#define __CPU_TESTERS_TRAFFIC_GEN_MULTI_STREAM_GEN_HH__
+
+/**
+ * @file multi_stream_gen.hh
+ * Contains the description of the class MultiStreamTrafficGen, a
+ * simobject that hosts many independent streams of synthetic memory
+ * requests behind a single port.
+ */
+
+#include <deque>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "enums/MultiStreamPattern.hh"
+#include "mem/packet.hh"
+#include "mem/port.hh"
+#include "params/MultiStreamTrafficGen.hh"
+#include "sim/clocked_object.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+/**
+ * A MultiStreamTrafficGen generates the requests of many streams from
+ * a single event, rather than having one traffic generator and one
+ * event per stream. Each stream accesses its own slice of the memory,
+ * either linearly or at random, and issues a request every period
+ * cycles while it has less than a maximum of requests outstanding. The
+ * streams are spread over the cycles of a period, so that the same
+ * number of streams issue in every cycle.
+ *
+ * The state of the streams is held in arrays, and the random numbers of
+ * the streams that issue in a cycle are generated in one loop that the
+ * compiler can vectorize.
+ */
+class MultiStreamTrafficGen : public ClockedObject
+{
+  private:
+
+    class GenPort : public RequestPort
+    {
+      private:
+
+        MultiStreamTrafficGen *owner;
+
+      public:
+
+        GenPort(const std::string& name, MultiStreamTrafficGen *owner) :
+            RequestPort(name, owner), owner(owner)
+        {}
+
+      protected:
+
+        bool recvTimingResp(PacketPtr pkt) override
+        { return owner->recvTimingResp(pkt); }
+
+        void recvReqRetry() override { owner->recvReqRetry(); }
+    };
+
+    /** Carries the stream of a request to its response */
+    struct StreamState : public Packet::SenderState
+    {
+        StreamState(unsigned _stream, Tick issue_tick) :
+            stream(_stream), issueTick(issue_tick)
+        {}
+
+        const unsigned stream;
+
+        /** Tick when the request was generated */
+        const Tick issueTick;
+    };
+
+    void startup() override;
+
+    /**
+     * Generate the requests of the streams that issue in this cycle,
+     * and send them.
+     */
+    void generate();
+
+    /** Schedule the next generation, if a stream can issue */
+    void scheduleGenerate();
+
+    /** Send the queued requests until the port is blocked */
+    void sendPackets();
+
+    /**
+     * Signal that the generator is drained if it is draining and no
+     * request is queued or outstanding anymore.
+     */
+    void checkDrain();
+
+    bool recvTimingResp(PacketPtr pkt);
+
+    void recvReqRetry();
+
+    /** Whether a stream is done, i.e., it issued all of its requests */
+    bool
+    streamDone(unsigned stream) const
+    {
+        return maxRequests != 0 && issued[stream] >= maxRequests;
+    }
+
+    EventFunctionWrapper generateEvent;
+
+    System *const system;
+
+    const RequestorID requestorId;
+
+    GenPort port;
+
+    const unsigned numStreams;
+
+    const MultiStreamPattern pattern;
+
+    /** Size of a request, in bytes */
+    const unsigned blockSize;
+
+    /** Start address of the memory slice of the first stream */
+    const Addr startAddr;
+
+    /** Number of blocks of the memory slice of a stream */
+    const uint64_t blocksPerStream;
+
+    const unsigned readPercent;
+
+    /** Cycles between two requests of a stream */
+    const Cycles period;
+
+    /** Maximum number of outstanding requests of a stream */
+    const unsigned maxOutstanding;
+
+    /** Number of requests of a stream, 0 for no limit */
+    const uint64_t maxRequests;
+
+    /** State of the random number generator of each stream */
+    std::vector<uint64_t> rngState;
+
+    /** Index of the next block of each stream, for linear streams */
+    std::vector<uint64_t> nextBlock;
+
+    /** Number of outstanding requests of each stream */
+    std::vector<unsigned> outstanding;
+
+    /** Number of requests issued by each stream */
+    std::vector<uint64_t> issued;
+
+    /**
+     * Number of streams that can issue, i.e., that are not done and
+     * have less than the maximum of requests outstanding
+     */
+    unsigned numReady;
+
+    /** Number of outstanding requests of all the streams */
+    unsigned totalOutstanding;
+
+    /**
+     * Number of streams that issue in a cycle. The streams of a cycle
+     * are consecutive, so that their state is contiguous.
+     */
+    const unsigned streamsPerCycle;
+
+    /**
+     * Scratch arrays of the random blocks of the streams of a cycle,
+     * and of whether they write.
+     */
+    std::vector<uint64_t> genBlocks;
+    std::vector<uint8_t> genWrites;
+
+    /** Requests waiting to be sent */
+    std::deque<PacketPtr> sendQueue;
+
+    /** Set when the port refused a request, until it asks for a retry */
+    bool waitingRetry;
+
+    struct StatGroup : public statistics::Group
+    {
+        StatGroup(MultiStreamTrafficGen *parent, unsigned num_streams);
+
+        /** Per stream stats */
+        statistics::Vector reads;
+        statistics::Vector writes;
+        statistics::Vector bytesRead;
+        statistics::Vector bytesWritten;
+        statistics::Vector totalLatency;
+        statistics::Formula avgLatency;
+        /** Times a stream could not issue as it had too many requests */
+        statistics::Vector stalls;
+    } stats;
+
+  public:
+
+    MultiStreamTrafficGen(const MultiStreamTrafficGenParams &params);
+
+    ~MultiStreamTrafficGen();
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+    /**
+     * Stop generating requests, and wait for the queued and outstanding
+     * ones to complete.
+     */
+    DrainState drain() override;
+
+    void drainResume() override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+};
+
+} // namespace gem5
+
+#endif // __CPU_TESTERS_TRAFFIC_GEN_MULTI_STREAM_GEN_HH__
@@ -50,36 +50,72 @@ namespace gem5
 {
 
 TraceGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
 {
+    if (ColumnarTraceInputStream::isColumnarTrace(filename)) {
+        columnarTrace.reset(new ColumnarTraceInputStream(filename));
+    } else {
+        trace.reset(new ProtoInputStream(filename));
+        readAhead.reset(new ProtoReadAhead<ProtoMessage::Packet>(
+            *trace, ReadAheadMessages));
+    }
     init();
 }
 
 void
 TraceGen::InputStream::init()
 {
+    if (columnarTrace) {
+        // The header was read when opening the trace
+        const Tick tick_freq = columnarTrace->header().tickFreq;
+        if (tick_freq != sim_clock::Frequency) {
+            panic("Trace was recorded with a different tick frequency "
+                  "%d\n", tick_freq);
+        }
+        return;
+    }
+
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from trace\n");
     } else if (header_msg.tick_freq() != sim_clock::Frequency) {
         panic("Trace was recorded with a different tick frequency %d\n",
               header_msg.tick_freq());
     }
+
+    // Parse the packets in the background from now on
+    readAhead->start();
 }
 
 void
 TraceGen::InputStream::reset()
 {
-    trace.reset();
-    init();
+    if (columnarTrace) {
+        columnarTrace->reset();
+    } else {
+        readAhead->stop();
+        trace->reset();
+        init();
+    }
 }
 
 bool
 TraceGen::InputStream::read(TraceElement& element)
 {
+    if (columnarTrace) {
+        PacketTraceRecord record;
+        if (!columnarTrace->read(record))
+            return false;
+        element.cmd = record.cmd;
+        element.addr = record.addr;
+        element.blocksize = record.size;
+        element.tick = record.tick;
+        element.flags = record.flags;
+        return true;
+    }
+
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (readAhead->read(pkt_msg)) {
         element.cmd = pkt_msg.cmd();
         element.addr = pkt_msg.addr();
         element.blocksize = pkt_msg.size();
@@ -44,10 +44,14 @@
 #ifndef __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 #define __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 
+#include <memory>
+
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "base_gen.hh"
 #include "mem/packet.hh"
+#include "proto/columnar_trace.hh"
+#include "proto/packet.pb.h"
 #include "proto/protoio.hh"
 
 namespace gem5
@@ -111,8 +115,17 @@ class TraceGen : public BaseGen
 
       private:
 
+        /// Number of messages to parse ahead of the generator
+        static constexpr size_t ReadAheadMessages = 4096;
+
         /// Input file stream for the protobuf trace
-        ProtoInputStream trace;
+        std::unique_ptr<ProtoInputStream> trace;
+
+        /// Parses the protobuf trace in a background thread
+        std::unique_ptr<ProtoReadAhead<ProtoMessage::Packet>> readAhead;
+
+        /// Input file stream for the trace, when it is columnar
+        std::unique_ptr<ColumnarTraceInputStream> columnarTrace;
 
       public:
 
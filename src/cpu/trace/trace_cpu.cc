@@ -37,6 +37,9 @@
 
 #include "cpu/trace/trace_cpu.hh"
 
+#include <algorithm>
+#include <functional>
+
 #include "base/compiler.hh"
 #include "sim/sim_exit.hh"
 
@@ -270,18 +273,19 @@ TraceCPU::ElasticDataGen::init()
     if (debug::TraceCPUData) {
         printReadyList();
     }
-    auto free_itr = readyList.begin();
+    const ReadyNode& first_node = readyList.front();
     DPRINTF(TraceCPUData,
             "Execute tick of the first dependency free node %lli is %d.\n",
-            free_itr->seqNum, free_itr->execTick);
+            first_node.seqNum, first_node.execTick);
     // Return the execute tick of the earliest ready node so that an event
     // can be scheduled to call execute()
-    return (free_itr->execTick);
+    return first_node.execTick;
 }
 
 void
 TraceCPU::ElasticDataGen::adjustInitTraceOffset(Tick& offset)
 {
+    // Shifting all the ticks keeps the order of the heap
     for (auto& free_node : readyList) {
         free_node.execTick -= offset;
     }
@@ -330,8 +334,8 @@ TraceCPU::ElasticDataGen::readNextWindow()
         addDepsOnParent(new_node, new_node->regDep);
 
         num_read++;
-        // Add to map
-        depGraph[new_node->seqNum] = new_node;
+        // Add to the graph
+        depGraph.insert(new_node);
         if (new_node->robDep.empty() && new_node->regDep.empty()) {
             // Source dependencies are already complete, check if resources
             // are available and issue. The execution time is approximated
@@ -352,13 +356,13 @@ TraceCPU::ElasticDataGen::addDepsOnParent(GraphNode *new_node, T& dep_list)
     auto dep_it = dep_list.begin();
     while (dep_it != dep_list.end()) {
         // We look up the valid dependency, i.e. the parent of this node
-        auto parent_itr = depGraph.find(*dep_it);
-        if (parent_itr != depGraph.end()) {
+        GraphNode* parent = depGraph.find(*dep_it);
+        if (parent) {
             // If the parent is found, it is yet to be executed. Append a
             // pointer to the new node to the dependents list of the parent
             // node.
-            parent_itr->second->dependents.push_back(new_node);
-            auto num_depts = parent_itr->second->dependents.size();
+            parent->dependents.push_back(new_node);
+            auto num_depts = parent->dependents.size();
             elasticStats.maxDependents = std::max<double>(num_depts,
                                         elasticStats.maxDependents.value());
             dep_it++;
@@ -401,16 +405,13 @@ TraceCPU::ElasticDataGen::execute()
         }
     }
     // Proceed to execute from readyList
-    auto graph_itr = depGraph.begin();
-    auto free_itr = readyList.begin();
     // Iterate through readyList until the next free node has its execute
     // tick later than curTick or the end of readyList is reached
-    while (free_itr->execTick <= curTick() && free_itr != readyList.end()) {
+    while (!readyList.empty() && readyList.front().execTick <= curTick()) {
 
         // Get pointer to the node to be executed
-        graph_itr = depGraph.find(free_itr->seqNum);
-        assert(graph_itr != depGraph.end());
-        GraphNode* node_ptr = graph_itr->second;
+        GraphNode* node_ptr = depGraph.find(readyList.front().seqNum);
+        assert(node_ptr);
 
         // If there is a retryPkt send that else execute the load
         if (retryPkt) {
@@ -436,9 +437,14 @@ TraceCPU::ElasticDataGen::execute()
         // as a retry from cache will bring the control to execute(). The
         // first node in readyList then, will be the failed node.
         if (retryPkt) {
+            readyList.front().awaitingRetry = true;
             break;
         }
 
+        // After executing the node, remove it from readyList, before its
+        // dependents are added to it.
+        popReadyList();
+
         // Proceed to remove dependencies for the successfully executed node.
         // If it is a load which is not strictly ordered and we sent a
         // request for it successfully, we do not yet mark any register
@@ -451,30 +457,29 @@ TraceCPU::ElasticDataGen::execute()
                     "Node seq. num %lli sent. Waking up dependents..\n",
                     node_ptr->seqNum);
 
-            auto child_itr = (node_ptr->dependents).begin();
-            while (child_itr != (node_ptr->dependents).end()) {
+            // Keep the children that still depend on the load at the
+            // front of the dependents, in order
+            auto& dependents = node_ptr->dependents;
+            auto kept_itr = dependents.begin();
+            for (auto child : dependents) {
                 // ROB dependency of a store on a load must not be removed
                 // after load is sent but after response is received
-                if (!(*child_itr)->isStore() &&
-                    (*child_itr)->removeRobDep(node_ptr->seqNum)) {
+                if (!child->isStore() &&
+                    child->removeRobDep(node_ptr->seqNum)) {
 
                     // Check if the child node has become dependency free
-                    if ((*child_itr)->robDep.empty() &&
-                        (*child_itr)->regDep.empty()) {
+                    if (child->robDep.empty() && child->regDep.empty()) {
 
                         // Source dependencies are complete, check if
                         // resources are available and issue
-                        checkAndIssue(*child_itr);
+                        checkAndIssue(child);
                     }
-                    // Remove this child for the sent load and point to new
-                    // location of the element following the erased element
-                    child_itr = node_ptr->dependents.erase(child_itr);
                 } else {
-                    // This child is not dependency-free, point to the next
-                    // child
-                    child_itr++;
+                    // This child is not dependency-free, keep it
+                    *kept_itr++ = child;
                 }
             }
+            dependents.erase(kept_itr, dependents.end());
         } else {
             // If it is a strictly ordered load mark its dependents as complete
             // as we do not send a request for this case. If it is a store or a
@@ -493,8 +498,6 @@ TraceCPU::ElasticDataGen::execute()
             }
         }
 
-        // After executing the node, remove from readyList and delete node.
-        readyList.erase(free_itr);
         // If it is a cacheable load which was sent, don't delete
         // just yet.  Delete it in completeMemAccess() after the
         // response is received. If it is an strictly ordered
@@ -509,13 +512,11 @@ TraceCPU::ElasticDataGen::execute()
             (node_ptr->dependents).clear();
             // Update the stat for numOps simulated
             owner.updateNumOps(node_ptr->robNum);
+            // remove from graph
+            depGraph.erase(node_ptr->seqNum);
             // delete node
             delete node_ptr;
-            // remove from graph
-            depGraph.erase(graph_itr);
         }
-        // Point to first node to continue to next iteration of while loop
-        free_itr = readyList.begin();
     } // end of while loop
 
     // Print readyList, sizes of queues and resource status after updating
@@ -545,7 +546,7 @@ TraceCPU::ElasticDataGen::execute()
     // list is empty then check if the next pending node has resources
     // available to issue. If yes, then schedule an event for the next cycle.
     if (!readyList.empty()) {
-        Tick next_event_tick = std::max(readyList.begin()->execTick,
+        Tick next_event_tick = std::max(readyList.front().execTick,
                                         curTick());
         DPRINTF(TraceCPUData, "Attempting to schedule @%lli.\n",
                 next_event_tick);
@@ -664,8 +665,8 @@ TraceCPU::ElasticDataGen::checkAndIssue(const GraphNode* node_ptr, bool first)
                 node_ptr->seqNum);
         // Compute the execute tick by adding the compute delay for the node
         // and add the ready node to the ready list
-        addToSortedReadyList(node_ptr->seqNum,
-                             owner.clockEdge() + node_ptr->compDelay);
+        addToReadyList(node_ptr->seqNum,
+                       owner.clockEdge() + node_ptr->compDelay);
         // Account for the resources taken up by this issued node.
         hwResource.occupy(node_ptr);
         return true;
@@ -697,9 +698,8 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
     } else {
         // If it is a load response then release the dependents waiting on it.
         // Get pointer to the completed load
-        auto graph_itr = depGraph.find(pkt->req->getReqInstSeqNum());
-        assert(graph_itr != depGraph.end());
-        GraphNode* node_ptr = graph_itr->second;
+        GraphNode* node_ptr = depGraph.find(pkt->req->getReqInstSeqNum());
+        assert(node_ptr);
 
         // Release resources occupied by the load
         hwResource.release(node_ptr);
@@ -717,10 +717,10 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
         (node_ptr->dependents).clear();
         // Update the stat for numOps completed
         owner.updateNumOps(node_ptr->robNum);
+        // remove from graph
+        depGraph.erase(node_ptr->seqNum);
         // delete node
         delete node_ptr;
-        // remove from graph
-        depGraph.erase(graph_itr);
     }
 
     if (debug::TraceCPUData) {
@@ -743,7 +743,7 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
         // are pending nodes in the depFreeQueue. The checking is done in the
         // execute() control flow, so schedule an event to go via that flow.
         Tick next_event_tick = readyList.empty() ? owner.clockEdge(Cycles(1)) :
-            std::max(readyList.begin()->execTick, owner.clockEdge(Cycles(1)));
+            std::max(readyList.front().execTick, owner.clockEdge(Cycles(1)));
         DPRINTF(TraceCPUData, "Attempting to schedule @%lli.\n",
                 next_event_tick);
         owner.schedDcacheNextEvent(next_event_tick);
@@ -751,83 +751,95 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
 }
 
 void
-TraceCPU::ElasticDataGen::addToSortedReadyList(NodeSeqNum seq_num,
-                                               Tick exec_tick)
+TraceCPU::ElasticDataGen::addToReadyList(NodeSeqNum seq_num, Tick exec_tick)
 {
     ReadyNode ready_node;
     ready_node.seqNum = seq_num;
     ready_node.execTick = exec_tick;
+    ready_node.awaitingRetry = false;
 
-    // Iterator to readyList
-    auto itr = readyList.begin();
-
-    // If the readyList is empty, simply insert the new node at the beginning
-    // and return
-    if (itr == readyList.end()) {
-        readyList.insert(itr, ready_node);
-        elasticStats.maxReadyListSize =
-            std::max<double>(readyList.size(),
-                             elasticStats.maxReadyListSize.value());
-        return;
-    }
-
-    // If the new node has its execution tick equal to the first node in the
-    // list then go to the next node. If the first node in the list failed
-    // to execute, its position as the first is thus maintained.
-    if (retryPkt) {
-        if (retryPkt->req->getReqInstSeqNum() == itr->seqNum)
-            itr++;
-    }
-
-    // Increment the iterator and compare the node pointed to by it to the new
-    // node till the position to insert the new node is found.
-    bool found = false;
-    while (!found && itr != readyList.end()) {
-        // If the execution tick of the new node is less than the node then
-        // this is the position to insert
-        if (exec_tick < itr->execTick) {
-            found = true;
-        // If the execution tick of the new node is equal to the node then
-        // sort in ascending order of sequence numbers
-        } else if (exec_tick == itr->execTick) {
-            // If the sequence number of the new node is less than the node
-            // then this is the position to insert
-            if (seq_num < itr->seqNum) {
-                found = true;
-            // Else go to next node
-            } else {
-                itr++;
-            }
-        } else {
-            // If the execution tick of the new node is greater than the node
-            // then go to the next node.
-            itr++;
-        }
-    }
-    readyList.insert(itr, ready_node);
+    readyList.push_back(ready_node);
+    std::push_heap(readyList.begin(), readyList.end(),
+                   std::greater<ReadyNode>());
     // Update the stat for max size reached of the readyList
     elasticStats.maxReadyListSize = std::max<double>(readyList.size(),
                                         elasticStats.maxReadyListSize.value());
 }
 
+void
+TraceCPU::ElasticDataGen::popReadyList()
+{
+    assert(!readyList.empty());
+    std::pop_heap(readyList.begin(), readyList.end(),
+                  std::greater<ReadyNode>());
+    readyList.pop_back();
+}
+
 void
 TraceCPU::ElasticDataGen::printReadyList()
 {
-    auto itr = readyList.begin();
-    if (itr == readyList.end()) {
+    if (readyList.empty()) {
         DPRINTF(TraceCPUData, "readyList is empty.\n");
         return;
     }
     DPRINTF(TraceCPUData, "Printing readyList:\n");
-    while (itr != readyList.end()) {
-        auto graph_itr = depGraph.find(itr->seqNum);
-        [[maybe_unused]] GraphNode* node_ptr = graph_itr->second;
+    // Print the nodes in the order they execute in
+    std::vector<ReadyNode> sorted_list(readyList);
+    std::sort_heap(sorted_list.begin(), sorted_list.end(),
+                   std::greater<ReadyNode>());
+    for (auto itr = sorted_list.rbegin(); itr != sorted_list.rend(); itr++) {
+        [[maybe_unused]] GraphNode* node_ptr = depGraph.find(itr->seqNum);
         DPRINTFR(TraceCPUData, "\t%lld(%s), %lld\n", itr->seqNum,
             node_ptr->typeToStr(), itr->execTick);
-        itr++;
     }
 }
 
+void
+TraceCPU::ElasticDataGen::NodeWindow::insert(GraphNode* node)
+{
+    const NodeSeqNum seq_num = node->seqNum;
+    if (empty()) {
+        oldest = seq_num;
+    } else {
+        panic_if(seq_num < next, "Trace node %lli is out of order.\n",
+                 seq_num);
+        if (seq_num - oldest >= ring.size())
+            grow(seq_num - oldest + 1);
+    }
+    ring[seq_num & (ring.size() - 1)] = node;
+    next = seq_num + 1;
+    numNodes++;
+}
+
+void
+TraceCPU::ElasticDataGen::NodeWindow::erase(NodeSeqNum seq_num)
+{
+    assert(find(seq_num));
+    ring[seq_num & (ring.size() - 1)] = nullptr;
+    numNodes--;
+
+    // Move the start of the window to the oldest remaining node
+    if (empty()) {
+        oldest = next;
+    } else if (seq_num == oldest) {
+        while (!ring[oldest & (ring.size() - 1)])
+            oldest++;
+    }
+}
+
+void
+TraceCPU::ElasticDataGen::NodeWindow::grow(NodeSeqNum span)
+{
+    size_t size = ring.size();
+    while (size < span)
+        size *= 2;
+    std::vector<GraphNode*> new_ring(size, nullptr);
+    for (NodeSeqNum seq_num = oldest; seq_num != next; seq_num++)
+        new_ring[seq_num & (size - 1)] = ring[seq_num & (ring.size() - 1)];
+    ring.swap(new_ring);
+}
+
+
 TraceCPU::ElasticDataGen::HardwareResource::HardwareResource(
         uint16_t max_rob, uint16_t max_stores, uint16_t max_loads) :
     sizeROB(max_rob),
@@ -1197,6 +1209,7 @@ TraceCPU::DcachePort::recvReqRetry()
 TraceCPU::ElasticDataGen::InputStream::InputStream(
         const std::string& filename, const double time_multiplier) :
     trace(filename),
+    readAhead(trace, ReadAheadRecords),
     timeMultiplier(time_multiplier),
     microOpCount(0)
 {
@@ -1214,19 +1227,29 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
         // when the data dependency trace was captured in the o3cpu model
         windowSize = header_msg.window_size();
     }
+
+    // Parse the records in the background from now on
+    readAhead.start();
 }
 
 void
 TraceCPU::ElasticDataGen::InputStream::reset()
 {
+    readAhead.stop();
     trace.reset();
+
+    // Skip the header, which was checked when opening the trace
+    ProtoMessage::InstDepRecordHeader header_msg;
+    trace.read(header_msg);
+
+    readAhead.start();
 }
 
 bool
 TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
 {
     ProtoMessage::InstDepRecord pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (readAhead.read(pkt_msg)) {
         // Required fields
         element->seqNum = pkt_msg.seq_num();
         element->type = pkt_msg.type();
@@ -1379,11 +1402,22 @@ TraceCPU::ElasticDataGen::GraphNode::typeToStr() const
 }
 
 TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
 {
+    if (ColumnarTraceInputStream::isColumnarTrace(filename)) {
+        columnarTrace.reset(new ColumnarTraceInputStream(filename));
+        const Tick tick_freq = columnarTrace->header().tickFreq;
+        if (tick_freq != sim_clock::Frequency) {
+            panic("Trace %s was recorded with a different tick frequency %d\n",
+                  filename, tick_freq);
+        }
+        return;
+    }
+
+    trace.reset(new ProtoInputStream(filename));
+
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from %s\n", filename);
 
         if (header_msg.tick_freq() != sim_clock::Frequency) {
@@ -1396,14 +1430,30 @@ TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
 void
 TraceCPU::FixedRetryGen::InputStream::reset()
 {
-    trace.reset();
+    if (columnarTrace)
+        columnarTrace->reset();
+    else
+        trace->reset();
 }
 
 bool
 TraceCPU::FixedRetryGen::InputStream::read(TraceElement* element)
 {
+    if (columnarTrace) {
+        PacketTraceRecord record;
+        if (!columnarTrace->read(record))
+            return false;
+        element->cmd = record.cmd;
+        element->addr = record.addr;
+        element->blocksize = record.size;
+        element->tick = record.tick;
+        element->flags = record.flags;
+        element->pc = record.pc;
+        return true;
+    }
+
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (trace->read(pkt_msg)) {
         element->cmd = pkt_msg.cmd();
         element->addr = pkt_msg.addr();
         element->blocksize = pkt_msg.size();
@@ -40,15 +40,17 @@
 
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <queue>
 #include <set>
-#include <unordered_map>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "cpu/base.hh"
 #include "debug/TraceCPUData.hh"
 #include "debug/TraceCPUInst.hh"
 #include "params/TraceCPU.hh"
+#include "proto/columnar_trace.hh"
 #include "proto/inst_dep_record.pb.h"
 #include "proto/packet.pb.h"
 #include "proto/protoio.hh"
@@ -375,7 +377,10 @@ class TraceCPU : public BaseCPU
         {
           private:
             // Input file stream for the protobuf trace
-            ProtoInputStream trace;
+            std::unique_ptr<ProtoInputStream> trace;
+
+            // Input file stream for the trace, when it is columnar
+            std::unique_ptr<ColumnarTraceInputStream> columnarTrace;
 
           public:
             /**
@@ -651,6 +656,85 @@ class TraceCPU : public BaseCPU
 
             /** The tick at which the ready node must be executed */
             Tick execTick;
+
+            /** Whether the request of the node is waiting for a retry */
+            bool awaitingRetry;
+
+            /**
+             * Order the ready nodes by execute tick, then by sequence
+             * number, except the node waiting for a retry which is first.
+             */
+            bool
+            operator>(const ReadyNode& other) const
+            {
+                if (awaitingRetry != other.awaitingRetry)
+                    return other.awaitingRetry;
+                if (execTick != other.execTick)
+                    return execTick > other.execTick;
+                return seqNum > other.seqNum;
+            }
+        };
+
+        /**
+         * The NodeWindow holds the nodes of the dependency graph, indexed
+         * by sequence number. Nodes are read from the trace in increasing
+         * order of sequence number, so they are held in a ring indexed by
+         * the sequence number modulo its size, that spans the sequence
+         * numbers from the oldest node in the graph to the newest one. The
+         * ring grows when an old node stays in the graph for long.
+         */
+        class NodeWindow
+        {
+          public:
+            NodeWindow() : ring(16, nullptr), oldest(0), next(0), numNodes(0)
+            {}
+
+            /**
+             * Add a node to the window.
+             *
+             * @param node The node, newer than all the nodes in the window
+             */
+            void insert(GraphNode* node);
+
+            /**
+             * Remove a node from the window.
+             *
+             * @param seq_num Sequence number of the node
+             */
+            void erase(NodeSeqNum seq_num);
+
+            /**
+             * Look up a node of the window.
+             *
+             * @param seq_num Sequence number of the node
+             * @return The node, or nullptr if it is not in the window
+             */
+            GraphNode*
+            find(NodeSeqNum seq_num) const
+            {
+                if (seq_num < oldest || seq_num >= next)
+                    return nullptr;
+                return ring[seq_num & (ring.size() - 1)];
+            }
+
+            size_t size() const { return numNodes; }
+
+            bool empty() const { return numNodes == 0; }
+
+          private:
+            /** Grow the ring to a power of two that fits a span */
+            void grow(NodeSeqNum span);
+
+            /** Nodes indexed by sequence number, nullptr if not held */
+            std::vector<GraphNode*> ring;
+
+            /** Sequence number of the oldest node in the window */
+            NodeSeqNum oldest;
+
+            /** Sequence number after the newest node in the window */
+            NodeSeqNum next;
+
+            size_t numNodes;
         };
 
         /**
@@ -761,9 +845,15 @@ class TraceCPU : public BaseCPU
         class InputStream
         {
           private:
+            /** Number of records to parse ahead of the generator */
+            static constexpr size_t ReadAheadRecords = 4096;
+
             /** Input file stream for the protobuf trace */
             ProtoInputStream trace;
 
+            /** Parses the records of the trace in a background thread */
+            ProtoReadAhead<ProtoMessage::InstDepRecord> readAhead;
+
             /**
              * A multiplier for the compute delays in the trace to modulate
              * the Trace CPU frequency either up or down. The Trace CPU's
@@ -882,7 +972,7 @@ class TraceCPU : public BaseCPU
 
         /**
          * This is the main execute function which consumes nodes from the
-         * sorted readyList. First attempt to issue the pending dependency-free
+         * readyList. First attempt to issue the pending dependency-free
          * nodes held in the depFreeQueue. Insert the ready-to-issue nodes into
          * the readyList. Then iterate through the readyList and when a node
          * has its execute tick equal to curTick(), execute it. If the node is
@@ -904,13 +994,15 @@ class TraceCPU : public BaseCPU
         PacketPtr executeMemReq(GraphNode* node_ptr);
 
         /**
-         * Add a ready node to the readyList. When inserting, ensure the nodes
-         * are sorted in ascending order of their execute ticks.
+         * Add a ready node to the readyList.
          *
          * @param seq_num seq. num of ready node
          * @param exec_tick the execute tick of the ready node
          */
-        void addToSortedReadyList(NodeSeqNum seq_num, Tick exec_tick);
+        void addToReadyList(NodeSeqNum seq_num, Tick exec_tick);
+
+        /** Remove the first node of the readyList. */
+        void popReadyList();
 
         /** Print readyList for debugging using debug flag TraceCPUData. */
         void printReadyList();
@@ -991,7 +1083,7 @@ class TraceCPU : public BaseCPU
         HardwareResource hwResource;
 
         /** Store the depGraph of GraphNodes */
-        std::unordered_map<NodeSeqNum, GraphNode*> depGraph;
+        NodeWindow depGraph;
 
         /**
          * Queue of dependency-free nodes that are pending issue because
@@ -1002,8 +1094,11 @@ class TraceCPU : public BaseCPU
          */
         std::queue<const GraphNode*> depFreeQueue;
 
-        /** List of nodes that are ready to execute */
-        std::list<ReadyNode> readyList;
+        /**
+         * Heap of nodes that are ready to execute, the first of which is
+         * the next node to execute in the order of ReadyNode.
+         */
+        std::vector<ReadyNode> readyList;
 
       protected:
         // Defining the a stat group
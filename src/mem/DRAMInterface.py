@@ -67,6 +67,20 @@ class DRAMInterface(MemInterface):
     # performance being lower when enabled
     enable_dram_powerdown = Param.Bool(False, "Enable powerdown states")
 
+    # Idle ranks normally go through the refresh state machine every tREFI.
+    # This stops scheduling refresh events for ranks that have nothing but
+    # refreshes to do until the controller gets a request for them, and
+    # accounts for the refreshes in between when the rank is next used or
+    # stats are dumped. Refresh timing, power state times and energy are
+    # unchanged.
+    lazy_refresh = Param.Bool(False, "Defer the refreshes of idle ranks")
+
+    # The FR-FCFS scheduler looks up the queued packets per bank. This
+    # makes it also go through the whole queue for every decision and
+    # check that both agree, which is only useful for testing
+    check_frfcfs_index = Param.Bool(False, "Check the FR-FCFS decisions "
+                                    "against a scan of the queue")
+
     # For power modelling we need to know if the DRAM has a DLL or not
     dll = Param.Bool(True, "DRAM has DLL or not")
 
@@ -66,6 +66,16 @@ class NVMInterface(MemInterface):
     two_cycle_rdwr = Param.Bool(False,
                      "Two cycles required to send read and write commands")
 
+    # NVM DIMM could merge writes in a write-combining buffer before
+    # writing them to the media, which is accessed at a coarser
+    # granularity than the burst size, a depth of zero disables it
+    xpbuffer_entries = Param.Unsigned(0, "Lines in the write-combining "
+                                      "buffer, 0 to disable it")
+    xpbuffer_line_size = Param.MemorySize("256B", "Media access "
+                                          "granularity")
+    xpbuffer_wear_lines = Param.Unsigned(65536, "Maximum number of lines "
+                                         "tracked for the wear stats")
+
 
     def controller(self):
         """
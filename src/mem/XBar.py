@@ -144,6 +144,18 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MiB', "Maximum capacity of snoop filter")
 
+    # A bounded snoop filter tracks at most max_capacity worth of
+    # lines in a set-associative array, and asks the caches above to
+    # evict the lines it evicts. Evicted lines stay in a victim buffer
+    # until the caches above have evicted them, and requests that find
+    # no room are retried. An unbounded one only uses max_capacity as
+    # a sanity check.
+    bounded = Param.Bool(False, "Evict lines beyond max_capacity")
+    assoc = Param.Unsigned(16, "Associativity of a bounded snoop filter")
+    victim_entries = Param.Unsigned(16, "Evicted lines a bounded snoop "
+                                    "filter tracks until the caches above "
+                                    "have evicted them")
+
 # We use a coherent crossbar to connect multiple requestors to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
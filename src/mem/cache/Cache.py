@@ -39,12 +39,14 @@
 from m5.params import *
 from m5.proxy import *
 from m5.SimObject import SimObject
+from m5.util import fatal
 
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.Compressors import BaseCacheCompressor
 from m5.objects.Prefetcher import BasePrefetcher
 from m5.objects.ReplacementPolicies import *
 from m5.objects.Tags import *
+from m5.objects.XBar import BaseXBar
 
 # Enum for cache clusivity, currently mostly inclusive or mostly
 # exclusive.
@@ -146,12 +148,48 @@ class BaseCache(ClockedObject):
     clusivity = Param.Clusivity('mostly_incl',
                                 "Clusivity with upstream cache")
 
+    # A cache in the persistence domain (e.g. with eADR) completes the
+    # cache clean requests to the PoC that do not invalidate (e.g. clwb)
+    # in its flush engine rather than forwarding them to the memory.
+    # Invalidating ones (e.g. clflush) are still forwarded and snooped,
+    # but are acknowledged without waiting for the dirty data to reach
+    # the memory. The caches above a cache in the persistence domain
+    # must be in it as well.
+    persist_domain = Param.Bool(False, "Cache is in the persistence domain")
+
     # The write allocator enables optimizations for streaming write
     # accesses by first coalescing writes and then avoiding allocation
     # in the current cache. Typically, this would be enabled in the
     # data cache.
     write_allocator = Param.WriteAllocator(NULL, "Write allocator")
 
+    def upstreamCaches(self):
+        """The caches directly above this one, through any crossbars"""
+        caches = []
+        peers = [self.cpu_side.peer]
+        while peers:
+            peer = peers.pop()
+            if peer is None:
+                continue
+            if isinstance(peer.simobj, BaseCache):
+                caches.append(peer.simobj)
+            elif isinstance(peer.simobj, BaseXBar):
+                peers.extend(port.peer for port in
+                             peer.simobj.cpu_side_ports.elements)
+        return caches
+
+    def getCCParams(self):
+        # A volatile cache above a cache in the persistence domain would
+        # hold data reported as persistent. Each cache in the domain
+        # checks the caches directly above it, so the whole domain is
+        # checked.
+        if self.persist_domain:
+            for cache in self.upstreamCaches():
+                if not cache.persist_domain:
+                    fatal("%s is in the persistence domain, but %s above "
+                          "it is not", self, cache)
+        return super().getCCParams()
+
 class Cache(BaseCache):
     type = 'Cache'
     cxx_header = 'mem/cache/cache.hh'
@@ -80,8 +80,10 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
     : ClockedObject(p),
       cpuSidePort (p.name + ".cpu_side_port", this, "CpuSidePort"),
       memSidePort(p.name + ".mem_side_port", this, "MemSidePort"),
-      mshrQueue("MSHRs", p.mshrs, 0, p.demand_mshr_reserve, p.name),
+      mshrQueue("MSHRs", p.mshrs, 0, p.demand_mshr_reserve,
+                p.tgts_per_mshr, p.name),
       writeBuffer("write buffer", p.write_buffers, p.mshrs, p.name),
+      writesFirst(false),
       tags(p.tags),
       compressor(p.compressor),
       prefetcher(p.prefetcher),
@@ -134,6 +136,9 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
         "Compressed cache %s does not have a compression algorithm", name());
     if (compressor)
         compressor->setCache(this);
+
+    if (p.persist_domain)
+        flushEngine = std::make_unique<FlushEngine>(*this);
 }
 
 BaseCache::~BaseCache()
@@ -651,9 +656,9 @@ BaseCache::recvAtomic(PacketPtr pkt)
         // until the point of reference.
         DPRINTF(CacheVerbose, "%s: packet %s found block: %s\n",
                 __func__, pkt->print(), blk->print());
-        PacketPtr wb_pkt = writecleanBlk(blk, pkt->req->getDest(), pkt->id);
-        writebacks.push_back(wb_pkt);
-        pkt->setSatisfied();
+        writebacks.push_back(cleanDirtyBlk(blk, pkt));
+        if (!earlyCleanAck(pkt))
+            pkt->setSatisfied();
     }
 
     // handle writebacks resulting from the access here to ensure they
@@ -853,9 +858,13 @@ BaseCache::getNextQueueEntry()
     MSHR *miss_mshr  = mshrQueue.getNext();
     WriteQueueEntry *wq_entry = writeBuffer.getNext();
 
+    if (writesFirst && writeBuffer.nextReadyTime() == MaxTick)
+        writesFirst = false;
+
     // If we got a write buffer request ready, first priority is a
-    // full write buffer, otherwise we favour the miss requests
-    if (wq_entry && (writeBuffer.isFull() || !miss_mshr)) {
+    // full write buffer, or writes that a snoop filter below waits
+    // for, otherwise we favour the miss requests
+    if (wq_entry && (writeBuffer.isFull() || writesFirst || !miss_mshr)) {
         // need to search MSHR queue for conflicting earlier miss.
         MSHR *conflict_mshr = mshrQueue.findPending(wq_entry);
 
@@ -1243,6 +1252,21 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
             blk ? "hit " + blk->print() : "miss");
 
     if (pkt->req->isCacheMaintenance()) {
+        if (flushEngine && pkt->isClean() && pkt->req->isToPOC()) {
+            // A cache clean to the PoC is a flush to the persistence
+            // domain. One that does not invalidate completes here
+            // unless an access to the block is outstanding and has to
+            // be ordered with it. An invalidating one must still reach
+            // all the copies of the block, and is only acknowledged
+            // early (see cleanDirtyBlk).
+            if (!pkt->isInvalidate() &&
+                !mshrQueue.findMatch(pkt->getBlockAddr(blkSize),
+                                     pkt->isSecure())) {
+                return persistFlush(pkt, blk, lat, tag_latency);
+            }
+            flushEngine->forwardedFlushes++;
+        }
+
         // A cache maintenance operation is always forwarded to the
         // memory below even if the block is found in dirty state.
 
@@ -1782,6 +1806,21 @@ BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
     return pkt;
 }
 
+PacketPtr
+BaseCache::cleanDirtyBlk(CacheBlk *blk, PacketPtr pkt)
+{
+    if (!earlyCleanAck(pkt))
+        return writecleanBlk(blk, pkt->req->getDest(), pkt->id);
+
+    // In the persistence domain the data is persistent as soon as it
+    // leaves the cache, so the clean is acknowledged without waiting
+    // for it. The write is not paired with the clean at the PoC, and
+    // only updates the copies on its way to the memory.
+    PacketPtr wb_pkt = writecleanBlk(blk, 0, 0);
+    wb_pkt->setWriteThrough();
+    return wb_pkt;
+}
+
 
 void
 BaseCache::memWriteback()
@@ -1915,7 +1954,8 @@ BaseCache::sendMSHRQueuePacket(MSHR* mshr)
     // as forwarded packets may already have existing state
     pkt->pushSenderState(mshr);
 
-    if (pkt->isClean() && blk && blk->isSet(CacheBlk::DirtyBit)) {
+    if (pkt->isClean() && blk && blk->isSet(CacheBlk::DirtyBit) &&
+        !earlyCleanAck(pkt)) {
         // A cache clean opearation is looking for a dirty block. Mark
         // the packet so that the destination xbar can determine that
         // there will be a follow-up write packet as well.
@@ -1953,10 +1993,8 @@ BaseCache::sendMSHRQueuePacket(MSHR* mshr)
             // until the point of reference.
             DPRINTF(CacheVerbose, "%s: packet %s found block: %s\n",
                     __func__, pkt->print(), blk->print());
-            PacketPtr wb_pkt = writecleanBlk(blk, pkt->req->getDest(),
-                                             pkt->id);
             PacketList writebacks;
-            writebacks.push_back(wb_pkt);
+            writebacks.push_back(cleanDirtyBlk(blk, pkt));
             doWritebacks(writebacks, 0);
         }
 
@@ -2502,6 +2540,85 @@ BaseCache::CacheStats::regStats()
     dataContractions.flags(nozero | nonan);
 }
 
+bool
+BaseCache::persistFlush(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
+                        Cycles tag_latency)
+{
+    // This cache and everything below it is in the persistence domain,
+    // and so are the caches above it, hence the data of the block is
+    // persistent wherever it is. A flush that does not invalidate
+    // leaves all the copies of the block as they are, so it does not
+    // have to reach any other cache.
+    assert(!pkt->isInvalidate());
+    const bool dirty = blk && blk->isSet(CacheBlk::DirtyBit);
+    lat = calculateTagOnlyLatency(pkt->headerDelay, tag_latency);
+
+    DPRINTF(Cache, "%s: %s completed in the persistence domain\n",
+            __func__, pkt->print());
+
+    // the block is no longer of interest to the caller, in particular
+    // no WriteClean must follow the flush
+    blk = nullptr;
+
+    flushEngine->flushed(clockEdge(lat), dirty);
+    return true;
+}
+
+BaseCache::FlushEngine::FlushEngine(BaseCache &c)
+    : statistics::Group(&c, "flushEngine"),
+      epochFlushes(0),
+      ADD_STAT(flushes, statistics::units::Count::get(),
+               "Number of flushes completed in the persistence domain"),
+      ADD_STAT(dirtyFlushes, statistics::units::Count::get(),
+               "Number of flushes to blocks with dirty data"),
+      ADD_STAT(forwardedFlushes, statistics::units::Count::get(),
+               "Number of flushes forwarded as they invalidate or the "
+               "block had an outstanding access"),
+      ADD_STAT(epochs, statistics::units::Count::get(),
+               "Number of persist epochs"),
+      ADD_STAT(flushLatency, statistics::units::Tick::get(),
+               "Ticks from the flush arrival to its acknowledge"),
+      ADD_STAT(flushesPerEpoch, statistics::units::Count::get(),
+               "Number of flushes per persist epoch"),
+      ADD_STAT(occupancy, statistics::units::Count::get(),
+               "Number of flushes in flight when a flush arrives")
+{
+}
+
+void
+BaseCache::FlushEngine::regStats()
+{
+    statistics::Group::regStats();
+
+    flushLatency.init(16);
+    flushesPerEpoch.init(16);
+    occupancy.init(16);
+}
+
+void
+BaseCache::FlushEngine::flushed(Tick done_at, bool dirty)
+{
+    // retire the flushes acknowledged by now, if none is left the
+    // requestor has seen the previous epoch as persistent
+    while (!inFlight.empty() && inFlight.top() <= curTick())
+        inFlight.pop();
+
+    if (inFlight.empty() && epochFlushes) {
+        epochs++;
+        flushesPerEpoch.sample(epochFlushes);
+        epochFlushes = 0;
+    }
+
+    occupancy.sample(inFlight.size());
+    inFlight.push(done_at);
+    epochFlushes++;
+
+    flushes++;
+    if (dirty)
+        dirtyFlushes++;
+    flushLatency.sample(done_at - curTick());
+}
+
 void
 BaseCache::regProbePoints()
 {
@@ -48,7 +48,11 @@
 
 #include <cassert>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
 #include <string>
+#include <vector>
 
 #include "base/addr_range.hh"
 #include "base/compiler.hh"
@@ -346,6 +350,14 @@ class BaseCache : public ClockedObject
     /** Write/writeback buffer */
     WriteQueue writeBuffer;
 
+    /**
+     * Send the writes before the misses, until the write buffer has
+     * nothing left to send. Set when a snoop filter below asks for
+     * blocks to be evicted, as the misses may have to wait for the
+     * resulting writebacks to free room in the snoop filter.
+     */
+    bool writesFirst;
+
     /** Tag and data Storage */
     BaseTags *tags;
 
@@ -480,6 +492,31 @@ class BaseCache : public ClockedObject
     Cycles calculateAccessLatency(const CacheBlk* blk, const uint32_t delay,
                                   const Cycles lookup_lat) const;
 
+    /**
+     * Complete a cache clean request to the PoC in a cache that is part
+     * of the persistence domain. The data of the block is persistent
+     * already, and the request is not forwarded to the memory below.
+     *
+     * @param pkt The cache clean request, which does not invalidate.
+     * @param blk The cache block, set to nullptr on return.
+     * @param lat The latency of the access.
+     * @param tag_latency The latency of the tag lookup.
+     * @return Boolean indicating whether the request was satisfied.
+     */
+    bool persistFlush(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
+                      Cycles tag_latency);
+
+    /**
+     * Whether a cache clean request is acknowledged without waiting for
+     * the dirty data it finds to reach its destination, which is the case
+     * for a clean to the PoC in the persistence domain.
+     */
+    bool
+    earlyCleanAck(const PacketPtr pkt) const
+    {
+        return flushEngine && pkt->req->isToPOC();
+    }
+
     /**
      * Does all the processing necessary to perform the provided request.
      * @param pkt The memory request to perform.
@@ -848,6 +885,18 @@ class BaseCache : public ClockedObject
      */
     PacketPtr writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id);
 
+    /**
+     * Create the writeclean request for a dirty block found by a cache
+     * clean request. Unless the clean is acknowledged early (see
+     * earlyCleanAck), the write is paired with the clean at its
+     * destination and the caller must mark the clean as satisfied.
+     *
+     * @param blk The dirty block.
+     * @param pkt The cache clean request.
+     * @return The generated write clean packet.
+     */
+    PacketPtr cleanDirtyBlk(CacheBlk *blk, PacketPtr pkt);
+
     /**
      * Write back dirty blocks in the cache using functional accesses.
      */
@@ -1146,6 +1195,65 @@ class BaseCache : public ClockedObject
         std::vector<std::unique_ptr<CacheCmdStats>> cmd;
     } stats;
 
+    /**
+     * The flush engine of a cache in the persistence domain. Cache clean
+     * requests to the PoC that do not invalidate complete in the cache,
+     * without being forwarded and snooped all the way to the memory, and
+     * the engine keeps track of them. Flushes that are in flight at the
+     * same time are part of the same persist epoch, an epoch ends when
+     * all its flushes are acknowledged (e.g. after a fence on the CPU
+     * side).
+     */
+    class FlushEngine : public statistics::Group
+    {
+      public:
+        FlushEngine(BaseCache &c);
+
+        void regStats() override;
+
+        /**
+         * Record a flush completed in the cache.
+         *
+         * @param done_at Tick at which the flush is acknowledged.
+         * @param dirty If the block had dirty data.
+         */
+        void flushed(Tick done_at, bool dirty);
+
+      private:
+        /** Acknowledge ticks of the flushes in flight */
+        std::priority_queue<Tick, std::vector<Tick>,
+                            std::greater<Tick>> inFlight;
+
+        /** Number of flushes in the current epoch */
+        uint64_t epochFlushes;
+
+      public:
+        /** Number of flushes completed in the cache. */
+        statistics::Scalar flushes;
+        /** Number of flushes to blocks with dirty data. */
+        statistics::Scalar dirtyFlushes;
+        /**
+         * Number of flushes forwarded to the memory below, as they
+         * invalidate or an access to the block was outstanding.
+         */
+        statistics::Scalar forwardedFlushes;
+        /** Number of persist epochs. */
+        statistics::Scalar epochs;
+
+        /** Latency from the flush arrival to its acknowledge. */
+        statistics::Histogram flushLatency;
+        /** Number of flushes per persist epoch. */
+        statistics::Histogram flushesPerEpoch;
+        /** Number of flushes in flight when a flush arrives. */
+        statistics::Histogram occupancy;
+    };
+
+    /**
+     * Flush engine, only instantiated for caches in the persistence
+     * domain.
+     */
+    std::unique_ptr<FlushEngine> flushEngine;
+
     /** Registers probes. */
     void regProbePoints() override;
 
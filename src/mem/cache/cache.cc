@@ -1108,10 +1108,13 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
         if (blk_valid && blk->isSet(CacheBlk::DirtyBit)) {
             DPRINTF(CacheVerbose, "%s: packet (snoop) %s found block: %s\n",
                     __func__, pkt->print(), blk->print());
-            PacketPtr wb_pkt =
-                writecleanBlk(blk, pkt->req->getDest(), pkt->id);
+            // the MSHR marked a deferred snoop as satisfied already, so
+            // its write must be paired with the clean at the destination
+            const bool paired = is_deferred || !earlyCleanAck(pkt);
             PacketList writebacks;
-            writebacks.push_back(wb_pkt);
+            writebacks.push_back(paired ?
+                writecleanBlk(blk, pkt->req->getDest(), pkt->id) :
+                cleanDirtyBlk(blk, pkt));
 
             if (is_timing) {
                 // anything that is merely forwarded pays for the forward
@@ -1122,7 +1125,8 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
             } else {
                 doWritebacksAtomic(writebacks);
             }
-            pkt->setSatisfied();
+            if (paired)
+                pkt->setSatisfied();
         }
     } else if (!blk_valid) {
         DPRINTF(CacheVerbose, "%s: snoop miss for %s\n", __func__,
@@ -1255,6 +1259,11 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
         return;
     }
 
+    if (pkt->cmd == MemCmd::BackInvalidateReq) {
+        handleBackInvalidate(pkt, true);
+        return;
+    }
+
     bool is_secure = pkt->isSecure();
     CacheBlk *blk = tags->findBlock(pkt->getAddr(), is_secure);
 
@@ -1371,11 +1380,57 @@ Cache::recvAtomicSnoop(PacketPtr pkt)
         return 0;
     }
 
+    if (pkt->cmd == MemCmd::BackInvalidateReq) {
+        handleBackInvalidate(pkt, false);
+        return lookupLatency * clockPeriod();
+    }
+
     CacheBlk *blk = tags->findBlock(pkt->getAddr(), pkt->isSecure());
     uint32_t snoop_delay = handleSnoop(pkt, blk, false, false, false);
     return snoop_delay + lookupLatency * clockPeriod();
 }
 
+void
+Cache::handleBackInvalidate(PacketPtr pkt, bool is_timing)
+{
+    DPRINTF(CacheVerbose, "%s: for %s\n", __func__, pkt->print());
+
+    // the caches above evict the block first, so that the writebacks
+    // of this cache see whether it is still cached above
+    if (forwardSnoops) {
+        if (is_timing) {
+            Packet snoop_pkt(pkt, true, false);
+            snoop_pkt.setExpressSnoop();
+            snoop_pkt.headerDelay = snoop_pkt.payloadDelay = 0;
+            cpuSidePort.sendTimingSnoopReq(&snoop_pkt);
+        } else {
+            cpuSidePort.sendAtomicSnoop(pkt);
+        }
+    }
+
+    // a block with an outstanding miss, or already on its way out, is
+    // left alone, and it is the snoop filter that keeps tracking it
+    CacheBlk *blk = tags->findBlock(pkt->getAddr(), pkt->isSecure());
+    if (!blk || mshrQueue.findMatch(pkt->getBlockAddr(blkSize),
+                                    pkt->isSecure())) {
+        return;
+    }
+
+    DPRINTF(Cache, "%s: evicting %s\n", __func__, blk->print());
+
+    PacketList writebacks;
+    evictBlock(blk, writebacks);
+    if (is_timing) {
+        // the snoop filter may hold back misses until it sees the
+        // writebacks, so send them first
+        writesFirst = writesFirst || !writebacks.empty();
+        doWritebacks(writebacks, clockEdge(forwardLatency) +
+                     pkt->headerDelay);
+    } else {
+        doWritebacksAtomic(writebacks);
+    }
+}
+
 bool
 Cache::isCachedAbove(PacketPtr pkt, bool is_timing)
 {
@@ -137,6 +137,16 @@ class Cache : public BaseCache
     uint32_t handleSnoop(PacketPtr pkt, CacheBlk *blk,
                          bool is_timing, bool is_deferred, bool pending_inval);
 
+    /**
+     * Handle a back invalidation from a snoop filter below that
+     * evicted the block. The caches above evict the block first, then
+     * this cache evicts it as if it were replaced.
+     *
+     * @param pkt The back invalidation
+     * @param is_timing Timing or atomic mode
+     */
+    void handleBackInvalidate(PacketPtr pkt, bool is_timing);
+
     [[nodiscard]] PacketPtr evictBlock(CacheBlk *blk) override;
 
     /**
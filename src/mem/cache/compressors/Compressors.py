@@ -53,6 +53,11 @@ class BaseCacheCompressor(SimObject):
     decomp_extra_latency = Param.Cycles(1, "Number of extra cycles required "
         "to finish decompression (e.g., due to shifting and packaging).")
 
+    quick_reject = Param.Bool(False, "Check the data of a block with a "
+        "single pass before compressing it, and skip the full compression "
+        "of blocks that cannot be compressed. Pattern statistics do not "
+        "account for the rejected blocks.")
+
 class BaseDictionaryCompressor(BaseCacheCompressor):
     type = 'BaseDictionaryCompressor'
     abstract = True
@@ -89,7 +89,7 @@ Base::Base(const Params &p)
     compExtraLatency(p.comp_extra_latency),
     decompChunksPerCycle(p.decomp_chunks_per_cycle),
     decompExtraLatency(p.decomp_extra_latency),
-    cache(nullptr), stats(*this)
+    quickReject(p.quick_reject), cache(nullptr), stats(*this)
 {
     fatal_if(64 % chunkSizeBits,
         "64 must be a multiple of the chunk granularity.");
@@ -150,9 +150,19 @@ Base::fromChunks(const std::vector<Chunk>& chunks, uint64_t* data) const
 std::unique_ptr<Base::CompressionData>
 Base::compress(const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat)
 {
+    // Skip the compression of lines that are known not to compress
+    std::unique_ptr<CompressionData> comp_data;
+    if (quickReject) {
+        comp_data = reject(data, comp_lat, decomp_lat);
+    }
+    const bool rejected = (comp_data != nullptr);
+
     // Apply compression
-    std::unique_ptr<CompressionData> comp_data =
-        compress(toChunks(data), comp_lat, decomp_lat);
+    if (rejected) {
+        stats.rejectedCompressions++;
+    } else {
+        comp_data = compress(toChunks(data), comp_lat, decomp_lat);
+    }
 
     // If we are in debug mode apply decompression just after the compression.
     // If the results do not match, we've got an error
@@ -237,6 +247,8 @@ Base::BaseStats::BaseStats(Base& _compressor)
              "Total number of compressions"),
     ADD_STAT(failedCompressions, statistics::units::Count::get(),
              "Total number of failed compressions"),
+    ADD_STAT(rejectedCompressions, statistics::units::Count::get(),
+             "Number of failed compressions detected before compressing"),
     ADD_STAT(compressionSize, statistics::units::Count::get(),
              "Number of blocks that were compressed to this power of two "
              "size"),
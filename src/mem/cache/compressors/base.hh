@@ -126,6 +126,11 @@ class Base : public SimObject
      */
     const Cycles decompExtraLatency;
 
+    /**
+     * Whether to check lines with reject() before compressing them.
+     */
+    const bool quickReject;
+
     /** Pointer to the parent cache. */
     BaseCache* cache;
 
@@ -143,6 +148,9 @@ class Base : public SimObject
         /** Number of failed compressions. */
         statistics::Scalar failedCompressions;
 
+        /** Number of failed compressions detected by reject(). */
+        statistics::Scalar rejectedCompressions;
+
         /** Number of blocks that were compressed to this power of two size. */
         statistics::Vector compressionSize;
 
@@ -189,6 +197,24 @@ class Base : public SimObject
         const std::vector<Chunk>& chunks, Cycles& comp_lat,
         Cycles& decomp_lat) = 0;
 
+    /**
+     * Check, with a single pass over the raw data, whether the compressor
+     * would fail to compress a cache line, so that its full compression
+     * can be skipped. It must never reject a line that the compressor
+     * would compress.
+     *
+     * @param data The cache line to be checked.
+     * @param comp_lat Compression latency in number of cycles.
+     * @param decomp_lat Decompression latency in number of cycles.
+     * @return The data of the failed compression, or nullptr if the line
+     *         has to go through the full compression.
+     */
+    virtual std::unique_ptr<CompressionData>
+    reject(const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat)
+    {
+        return nullptr;
+    }
+
     /**
      * Apply the decompression process to the compressed data.
      *
@@ -125,6 +125,9 @@ class BaseDelta : public DictionaryCompressor<BaseType>
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
 
+    std::unique_ptr<Base::CompressionData> reject(const uint64_t* data,
+        Cycles& comp_lat, Cycles& decomp_lat) override;
+
   public:
     typedef BaseDictionaryCompressorParams Params;
     BaseDelta(const Params &p);
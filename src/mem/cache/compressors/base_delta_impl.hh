@@ -36,6 +36,7 @@
 #include "debug/CacheComp.hh"
 #include "mem/cache/compressors/base_delta.hh"
 #include "mem/cache/compressors/dictionary_compressor_impl.hh"
+#include "mem/cache/compressors/reject.hh"
 
 namespace gem5
 {
@@ -98,6 +99,27 @@ BaseDelta<BaseType, DeltaSizeBits>::compress(
     return comp_data;
 }
 
+template <class BaseType, std::size_t DeltaSizeBits>
+std::unique_ptr<Base::CompressionData>
+BaseDelta<BaseType, DeltaSizeBits>::reject(const uint64_t* data,
+    Cycles& comp_lat, Cycles& decomp_lat)
+{
+    // The check assumes that every chunk is a base-sized value
+    if (this->chunkSizeBits != 8 * sizeof(BaseType)) {
+        return nullptr;
+    }
+
+    if (!rejectBaseDelta<BaseType, DeltaSizeBits>(data,
+            DictionaryCompressor<BaseType>::blkSize / sizeof(uint64_t))) {
+        return nullptr;
+    }
+
+    DPRINTF(CacheComp, "Base%dDelta%d compression rejected\n",
+        8 * sizeof(BaseType), DeltaSizeBits);
+    return DictionaryCompressor<BaseType>::failedCompression(data,
+        comp_lat, decomp_lat);
+}
+
 } // namespace compression
 } // namespace gem5
 
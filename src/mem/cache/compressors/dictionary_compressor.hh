@@ -237,6 +237,20 @@ class DictionaryCompressor : public BaseDictionaryCompressor
     virtual std::unique_ptr<DictionaryCompressor::CompData>
     instantiateDictionaryCompData() const;
 
+    /**
+     * Create the compression data of a line that failed to compress,
+     * with the latencies of its full compression. Used by the
+     * implementations of reject(). It keeps a copy of the line, as no
+     * pattern is matched to decompress it from.
+     *
+     * @param data The cache line that failed to compress.
+     * @param comp_lat Compression latency in number of cycles.
+     * @param decomp_lat Decompression latency in number of cycles.
+     * @return The data of the failed compression.
+     */
+    std::unique_ptr<Base::CompressionData> failedCompression(
+        const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat) const;
+
     /**
      * Apply compression.
      *
@@ -396,6 +410,9 @@ class DictionaryCompressor<T>::CompData : public CompressionData
     /** The patterns matched in the original line. */
     std::vector<std::unique_ptr<Pattern>> entries;
 
+    /** The original line, when it was rejected without matching patterns. */
+    std::vector<uint64_t> rejectedLine;
+
     CompData();
     ~CompData() = default;
 
@@ -91,6 +91,23 @@ DictionaryCompressor<T>::instantiateDictionaryCompData() const
     return std::unique_ptr<DictionaryCompressor<T>::CompData>(new CompData());
 }
 
+template <typename T>
+std::unique_ptr<Base::CompressionData>
+DictionaryCompressor<T>::failedCompression(const uint64_t* data,
+    Cycles& comp_lat, Cycles& decomp_lat) const
+{
+    // Same latencies as a compression of all the chunks
+    const std::size_t num_chunks = (blkSize * 8) / chunkSizeBits;
+    comp_lat = Cycles(compExtraLatency + (num_chunks / compChunksPerCycle));
+    decomp_lat = Cycles(decompExtraLatency +
+        (num_chunks / decompChunksPerCycle));
+
+    std::unique_ptr<CompData> comp_data = instantiateDictionaryCompData();
+    comp_data->rejectedLine.assign(data, data + blkSize / sizeof(uint64_t));
+    comp_data->setSizeBits(blkSize * 8);
+    return comp_data;
+}
+
 template <typename T>
 std::unique_ptr<typename DictionaryCompressor<T>::Pattern>
 DictionaryCompressor<T>::compressValue(const T data)
@@ -190,6 +207,13 @@ DictionaryCompressor<T>::decompress(const CompressionData* comp_data,
 {
     const CompData* casted_comp_data = static_cast<const CompData*>(comp_data);
 
+    // A rejected line has no pattern to decompress
+    if (!casted_comp_data->rejectedLine.empty()) {
+        std::copy(casted_comp_data->rejectedLine.begin(),
+            casted_comp_data->rejectedLine.end(), data);
+        return;
+    }
+
     // Reset dictionary
     resetDictionary();
 
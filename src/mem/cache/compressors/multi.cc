@@ -146,6 +146,11 @@ Multi::compress(const std::vector<Chunk>& chunks, Cycles& comp_lat,
     // Find the ranking of the compressor outputs
     std::priority_queue<std::shared_ptr<Results>,
         std::vector<std::shared_ptr<Results>>, ResultsComparator> results;
+    // The sub-compressors are tried one after another rather than through
+    // a batch interface that checks every encoding in a single pass: they
+    // are only known through Base, they can use different chunk sizes,
+    // and the ones that cannot compress the line already leave after one
+    // pass of their reject() check over a line that is in the host cache
     Cycles max_comp_lat;
     for (unsigned i = 0; i < compressors.size(); i++) {
         Cycles temp_decomp_lat;
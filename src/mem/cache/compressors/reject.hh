@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Checks that tell, with a single pass over a raw cache line, whether the
+ * zero, repeated qwords and base-delta compressors would fail to compress
+ * it. They have no early exit, so that the compiler can vectorize them.
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_REJECT_HH__
+#define __MEM_CACHE_COMPRESSORS_REJECT_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "base/bitfield.hh"
+
+namespace gem5
+{
+
+namespace compression
+{
+
+/**
+ * Whether the zero compressor fails to compress a line.
+ *
+ * @param data The cache line.
+ * @param num_qwords Size of the line, in qwords.
+ * @return True if any bit of the line is set.
+ */
+inline bool
+rejectZero(const uint64_t* data, std::size_t num_qwords)
+{
+    uint64_t bits = 0;
+    for (std::size_t i = 0; i < num_qwords; i++) {
+        bits |= data[i];
+    }
+    return bits != 0;
+}
+
+/**
+ * Whether the repeated qwords compressor fails to compress a line.
+ *
+ * @param data The cache line.
+ * @param num_qwords Size of the line, in qwords.
+ * @return True if any qword differs from the first one.
+ */
+inline bool
+rejectRepeatedQwords(const uint64_t* data, std::size_t num_qwords)
+{
+    uint64_t bits = 0;
+    for (std::size_t i = 0; i < num_qwords; i++) {
+        bits |= data[i] ^ data[0];
+    }
+    return bits != 0;
+}
+
+/**
+ * Whether a base-delta compressor, whose chunks are base-sized values,
+ * fails to compress a line. The values are compressed in order: the ones
+ * before the first value that is not an immediate use the zero base, and
+ * that value becomes the only other base the compressor can allocate.
+ *
+ * @tparam BaseType Type of the bases and of the chunks.
+ * @tparam DeltaSizeBits Size of the deltas, in bits.
+ * @param data The cache line.
+ * @param num_qwords Size of the line, in qwords.
+ * @return True if a value is within a delta of neither base.
+ */
+template <class BaseType, std::size_t DeltaSizeBits>
+bool
+rejectBaseDelta(const uint64_t* data, std::size_t num_qwords)
+{
+    using SignedType = typename std::make_signed<BaseType>::type;
+    const SignedType limit = DeltaSizeBits ? mask(DeltaSizeBits - 1) : 0;
+    const auto fits = [limit](BaseType value, BaseType base)
+    {
+        const SignedType delta = value - base;
+        return (delta >= -limit) && (delta <= limit);
+    };
+
+    constexpr std::size_t values_per_qword =
+        sizeof(uint64_t) / sizeof(BaseType);
+    const std::size_t num_values = num_qwords * values_per_qword;
+    const auto value = [data](std::size_t i) -> BaseType
+    {
+        return data[i / values_per_qword] >>
+            (8 * sizeof(BaseType) * (i % values_per_qword));
+    };
+
+    std::size_t i = 0;
+    while ((i < num_values) && fits(value(i), 0)) {
+        i++;
+    }
+    if (i == num_values) {
+        return false;
+    }
+    const BaseType base = value(i);
+
+    bool all_fit = true;
+    for (; i < num_values; i++) {
+        const BaseType v = value(i);
+        all_fit &= fits(v, 0) | fits(v, base);
+    }
+    return !all_fit;
+}
+
+} // namespace compression
+} // namespace gem5
+
+#endif //__MEM_CACHE_COMPRESSORS_REJECT_HH__
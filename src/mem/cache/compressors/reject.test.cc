@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "mem/cache/compressors/reject.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+constexpr std::size_t numQwords = 8;
+using Line = std::array<uint64_t, numQwords>;
+
+/**
+ * Whether the zero compressor fails: every non-zero qword is added to its
+ * dictionary, and it fails if any was.
+ */
+bool
+zeroFails(const Line &line)
+{
+    std::size_t num_entries = 0;
+    for (const uint64_t value : line) {
+        if (value != 0) {
+            num_entries++;
+        }
+    }
+    return num_entries > 0;
+}
+
+/**
+ * Whether the repeated qwords compressor fails: the qwords that match no
+ * dictionary entry are added to it, and it fails if more than one was.
+ */
+bool
+repeatedQwordsFails(const Line &line)
+{
+    std::vector<uint64_t> dictionary;
+    for (const uint64_t value : line) {
+        bool matched = false;
+        for (const uint64_t entry : dictionary) {
+            matched |= (entry == value);
+        }
+        if (!matched) {
+            dictionary.push_back(value);
+        }
+    }
+    return dictionary.size() > 1;
+}
+
+/**
+ * Whether a base-delta compressor fails: the dictionary starts with the
+ * zero base, the values that are not within a delta of any base become
+ * new bases, and it fails if more than two bases are needed.
+ */
+template <class BaseType, std::size_t DeltaSizeBits>
+bool
+baseDeltaFails(const Line &line)
+{
+    using SignedType = typename std::make_signed<BaseType>::type;
+    const SignedType limit = (1ULL << (DeltaSizeBits - 1)) - 1;
+
+    constexpr std::size_t values_per_qword =
+        sizeof(uint64_t) / sizeof(BaseType);
+    std::vector<BaseType> dictionary = {0};
+    for (std::size_t i = 0; i < numQwords * values_per_qword; i++) {
+        const BaseType value = line[i / values_per_qword] >>
+            (8 * sizeof(BaseType) * (i % values_per_qword));
+        bool matched = false;
+        for (const BaseType base : dictionary) {
+            const SignedType delta = value - base;
+            matched |= (delta >= -limit) && (delta <= limit);
+        }
+        if (!matched) {
+            dictionary.push_back(value);
+        }
+    }
+    return dictionary.size() > 2;
+}
+
+/**
+ * Generate lines whose values are drawn around a few bases, with deltas
+ * that are just within or just beyond the given limit, so that the
+ * compressors succeed and fail on about as many lines.
+ */
+template <class BaseType>
+std::vector<Line>
+generateLines(std::mt19937_64 &gen, uint64_t limit, std::size_t num_lines)
+{
+    constexpr std::size_t values_per_qword =
+        sizeof(uint64_t) / sizeof(BaseType);
+    std::vector<Line> lines;
+    for (std::size_t n = 0; n < num_lines; n++) {
+        std::array<BaseType, 3> bases = {0, (BaseType)gen(),
+            (BaseType)gen()};
+        const std::size_t num_bases = 1 + gen() % bases.size();
+        Line line = {};
+        for (std::size_t i = 0; i < numQwords * values_per_qword; i++) {
+            const BaseType base = bases[gen() % num_bases];
+            const uint64_t delta = gen() % (2 * limit + 5);
+            const BaseType value = base + (BaseType)(delta - limit - 2);
+            line[i / values_per_qword] |= (uint64_t)value <<
+                (8 * sizeof(BaseType) * (i % values_per_qword));
+        }
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+template <class BaseType, std::size_t DeltaSizeBits>
+void
+checkBaseDelta(std::mt19937_64 &gen)
+{
+    const uint64_t limit = (1ULL << (DeltaSizeBits - 1)) - 1;
+    std::size_t num_failed = 0;
+    for (const Line &line : generateLines<BaseType>(gen, limit, 2000)) {
+        const bool fails = baseDeltaFails<BaseType, DeltaSizeBits>(line);
+        ASSERT_EQ((compression::rejectBaseDelta<BaseType, DeltaSizeBits>(
+            line.data(), numQwords)), fails);
+        num_failed += fails;
+    }
+
+    // Make sure both outcomes were exercised
+    ASSERT_GT(num_failed, 0);
+    ASSERT_LT(num_failed, 2000);
+}
+
+} // anonymous namespace
+
+/** Lines with zero, a single, and several non-zero qwords. */
+TEST(CompressorRejectTest, Zero)
+{
+    std::mt19937_64 gen(0);
+
+    Line line = {};
+    ASSERT_FALSE(compression::rejectZero(line.data(), numQwords));
+    ASSERT_EQ(compression::rejectZero(line.data(), numQwords),
+        zeroFails(line));
+
+    for (std::size_t i = 0; i < numQwords; i++) {
+        line = {};
+        line[i] = 1ULL << (gen() % 64);
+        ASSERT_TRUE(compression::rejectZero(line.data(), numQwords));
+        ASSERT_EQ(compression::rejectZero(line.data(), numQwords),
+            zeroFails(line));
+    }
+
+    for (std::size_t n = 0; n < 1000; n++) {
+        for (auto &value : line) {
+            value = (gen() % 4) ? 0 : gen();
+        }
+        ASSERT_EQ(compression::rejectZero(line.data(), numQwords),
+            zeroFails(line));
+    }
+}
+
+/** Lines made of one qword, with and without a differing qword. */
+TEST(CompressorRejectTest, RepeatedQwords)
+{
+    std::mt19937_64 gen(0);
+
+    for (std::size_t n = 0; n < 1000; n++) {
+        Line line;
+        line.fill(gen());
+        ASSERT_FALSE(compression::rejectRepeatedQwords(line.data(),
+            numQwords));
+        ASSERT_EQ(compression::rejectRepeatedQwords(line.data(), numQwords),
+            repeatedQwordsFails(line));
+
+        // A qword that differs in a single bit, including the first one
+        line[gen() % numQwords] ^= 1ULL << (gen() % 64);
+        ASSERT_TRUE(compression::rejectRepeatedQwords(line.data(),
+            numQwords));
+        ASSERT_EQ(compression::rejectRepeatedQwords(line.data(), numQwords),
+            repeatedQwordsFails(line));
+
+        // Lines made of a few distinct qwords
+        for (auto &value : line) {
+            value = gen() % 2;
+        }
+        ASSERT_EQ(compression::rejectRepeatedQwords(line.data(), numQwords),
+            repeatedQwordsFails(line));
+    }
+}
+
+/** Every base-delta configuration of the Compressors.py classes. */
+TEST(CompressorRejectTest, BaseDelta)
+{
+    std::mt19937_64 gen(0);
+    checkBaseDelta<uint64_t, 8>(gen);
+    checkBaseDelta<uint64_t, 16>(gen);
+    checkBaseDelta<uint64_t, 32>(gen);
+    checkBaseDelta<uint32_t, 8>(gen);
+    checkBaseDelta<uint32_t, 16>(gen);
+    checkBaseDelta<uint16_t, 8>(gen);
+}
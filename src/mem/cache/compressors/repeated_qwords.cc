@@ -36,6 +36,7 @@
 #include "base/trace.hh"
 #include "debug/CacheComp.hh"
 #include "mem/cache/compressors/dictionary_compressor_impl.hh"
+#include "mem/cache/compressors/reject.hh"
 #include "params/RepeatedQwordsCompressor.hh"
 
 namespace gem5
@@ -57,6 +58,22 @@ RepeatedQwords::addToDictionary(DictionaryEntry data)
     dictionary[numEntries++] = data;
 }
 
+std::unique_ptr<Base::CompressionData>
+RepeatedQwords::reject(const uint64_t* data, Cycles& comp_lat,
+    Cycles& decomp_lat)
+{
+    // Lines whose qwords differ cannot be made of a single repeated chunk
+    if (!rejectRepeatedQwords(data, blkSize / sizeof(uint64_t))) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Base::CompressionData> comp_data =
+        failedCompression(data, comp_lat, decomp_lat);
+    comp_lat = Cycles(1);
+    decomp_lat = Cycles(1);
+    return comp_data;
+}
+
 std::unique_ptr<Base::CompressionData>
 RepeatedQwords::compress(const std::vector<Chunk>& chunks,
     Cycles& comp_lat, Cycles& decomp_lat)
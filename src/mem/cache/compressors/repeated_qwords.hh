@@ -101,6 +101,9 @@ class RepeatedQwords : public DictionaryCompressor<uint64_t>
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
 
+    std::unique_ptr<Base::CompressionData> reject(const uint64_t* data,
+        Cycles& comp_lat, Cycles& decomp_lat) override;
+
   public:
     typedef RepeatedQwordsCompressorParams Params;
     RepeatedQwords(const Params &p);
@@ -66,12 +66,13 @@ MSHR::MSHR(const std::string &name)
         postInvalidate(false), postDowngrade(false),
         wasWholeLineWrite(false), isForward(false),
         targets(name + ".targets"),
-        deferredTargets(name + ".deferredTargets")
+        deferredTargets(name + ".deferredTargets"),
+        readyTargetsName(name + ".readyTargets")
 {
 }
 
-MSHR::TargetList::TargetList(const std::string &name)
-    :   Named(name),
+MSHR::TargetList::TargetList(const std::string &name, Pool *pool)
+    :   PooledList<Target>(pool), Named(name),
         needsWritable(false), hasUpgrade(false),
         allocOnFill(false), hasFromCache(false)
 {}
@@ -546,7 +547,7 @@ MSHR::handleSnoop(PacketPtr pkt, Counter _order)
 MSHR::TargetList
 MSHR::extractServiceableTargets(PacketPtr pkt)
 {
-    TargetList ready_targets;
+    TargetList ready_targets(readyTargetsName, targets.pool());
     ready_targets.init(blkAddr, blkSize);
     // If the downstream MSHR got an invalidation request then we only
     // service the first of the FromCPU targets and any other
@@ -557,18 +558,18 @@ MSHR::extractServiceableTargets(PacketPtr pkt)
         auto it = targets.begin();
         assert((it->source == Target::FromCPU) ||
                (it->source == Target::FromPrefetcher));
-        ready_targets.push_back(*it);
         // Leave the Locked RMW Read until the corresponding Locked Write
         // request comes in
-        if (it->pkt->cmd != MemCmd::LockedRMWReadReq) {
-            it = targets.erase(it);
+        if (it->pkt->cmd == MemCmd::LockedRMWReadReq) {
+            ready_targets.push_back(*it);
+        } else {
+            ready_targets.splice(ready_targets.end(), targets, it++);
             while (it != targets.end()) {
                 if (it->source == Target::FromCPU) {
                     it++;
                 } else {
                     assert(it->source == Target::FromSnoop);
-                    ready_targets.push_back(*it);
-                    it = targets.erase(it);
+                    ready_targets.splice(ready_targets.end(), targets, it++);
                 }
             }
         }
@@ -576,14 +577,14 @@ MSHR::extractServiceableTargets(PacketPtr pkt)
     } else {
         auto it = targets.begin();
         while (it != targets.end()) {
-            ready_targets.push_back(*it);
             if (it->pkt->cmd == MemCmd::LockedRMWReadReq) {
                 // Leave the Locked RMW Read until the corresponding Locked
                 // Write comes in. Also don't service any later targets as the
                 // line is now "locked".
+                ready_targets.push_back(*it);
                 break;
             }
-            it = targets.erase(it);
+            ready_targets.splice(ready_targets.end(), targets, it++);
         }
         ready_targets.populateFlags();
     }
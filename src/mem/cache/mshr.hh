@@ -52,6 +52,7 @@
 #include <string>
 #include <vector>
 
+#include "base/pooled_list.hh"
 #include "base/printable.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
@@ -166,7 +167,12 @@ class MSHR : public QueueEntry, public Printable
         {}
     };
 
-    class TargetList : public std::list<Target>, public Named
+    /**
+     * The targets of the MSHRs of a queue come from the pool of the
+     * queue, so that they are moved between the target lists of an
+     * MSHR without copies, and added without heap allocations.
+     */
+    class TargetList : public PooledList<Target>, public Named
     {
 
       public:
@@ -180,7 +186,8 @@ class MSHR : public QueueEntry, public Printable
          */
         bool hasFromCache;
 
-        TargetList(const std::string &name = ".unnamedTargetList");
+        TargetList(const std::string &name = ".unnamedTargetList",
+                   Pool *pool = nullptr);
 
         /**
          * Use the provided packet and the source to update the
@@ -395,6 +402,9 @@ class MSHR : public QueueEntry, public Printable
 
     TargetList deferredTargets;
 
+    /** Name of the lists of targets serviced by a response */
+    const std::string readyTargetsName;
+
   public:
     /**
      * Check if this MSHR contains only compatible writes, and if they
@@ -54,10 +54,26 @@ namespace gem5
 
 MSHRQueue::MSHRQueue(const std::string &_label,
                      int num_entries, int reserve,
-                     int demand_reserve, std::string cache_name = "")
+                     int demand_reserve, int num_targets,
+                     std::string cache_name = "")
     : Queue<MSHR>(_label, num_entries, reserve, cache_name + ".mshr_queue"),
-      demandReserve(demand_reserve)
-{}
+      demandReserve(demand_reserve),
+      targetPool(numEntries * num_targets, num_targets)
+{
+    for (auto &mshr : entries) {
+        mshr.targets.setPool(&targetPool);
+        mshr.deferredTargets.setPool(&targetPool);
+    }
+}
+
+MSHRQueue::~MSHRQueue()
+{
+    // the targets go back to the pool before it is destroyed
+    for (auto &mshr : entries) {
+        mshr.targets.clear();
+        mshr.deferredTargets.clear();
+    }
+}
 
 MSHR *
 MSHRQueue::allocate(Addr blk_addr, unsigned blk_size, PacketPtr pkt,
@@ -73,6 +89,7 @@ MSHRQueue::allocate(Addr blk_addr, unsigned blk_size, PacketPtr pkt,
 
     mshr->allocate(blk_addr, blk_size, pkt, when_ready, order, alloc_on_fill);
     mshr->allocIter = allocatedList.insert(allocatedList.end(), mshr);
+    addToIndex(mshr);
     mshr->readyIter = addToReadyList(mshr);
 
     allocated += 1;
@@ -68,6 +68,13 @@ class MSHRQueue : public Queue<MSHR>
      */
     const int demandReserve;
 
+    /**
+     * Pool of the targets of all the MSHRs, sized for the maximum
+     * number of targets of every MSHR. The pool grows if snoops add
+     * targets beyond that limit.
+     */
+    MSHR::TargetList::Pool targetPool;
+
   public:
 
     /**
@@ -77,9 +84,12 @@ class MSHRQueue : public Queue<MSHR>
      * any access.
      * @param demand_reserve The minimum number of entries needed to satisfy
      * demand accesses.
+     * @param num_targets The number of targets of each MSHR.
      */
     MSHRQueue(const std::string &_label, int num_entries, int reserve,
-              int demand_reserve, std::string cache_name);
+              int demand_reserve, int num_targets, std::string cache_name);
+
+    ~MSHRQueue();
 
     /**
      * Allocates a new MSHR for the request and size. This places the request
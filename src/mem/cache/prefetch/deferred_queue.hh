@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CACHE_PREFETCH_DEFERRED_QUEUE_HH__
+#define __CACHE_PREFETCH_DEFERRED_QUEUE_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+/**
+ * Bounded queue of deferred packets, ordered by decreasing priority, and
+ * by age within a priority. The packets stay in the same slot while they
+ * are queued, as the TLB holds on to them during a translation. The order
+ * of the slots is kept in a ring buffer, each slot knows where it is in
+ * the ring, and a hash table of the slots indexed by prefetch address
+ * finds the packets to an address without walking the queue.
+ *
+ * Entry must have a priority, and a pfInfo providing getAddr() and
+ * isSecure().
+ */
+template<class Entry>
+class DeferredQueue
+{
+  public:
+    DeferredQueue(unsigned capacity);
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return slots.size(); }
+
+    /** Packet at a position of the queue, 0 being the front */
+    Entry &operator[](size_t pos) { return *slots[slotAt(pos)]; }
+    const Entry &operator[](size_t pos) const { return *slots[slotAt(pos)]; }
+
+    Entry &front() { return (*this)[0]; }
+    const Entry &front() const { return (*this)[0]; }
+    const Entry &back() const { return (*this)[count - 1]; }
+
+    /**
+     * Queue a copy of a packet behind the packets of a higher or equal
+     * priority. The queue must not be full.
+     *
+     * @param entry The packet to queue
+     */
+    void insert(const Entry &entry);
+
+    /**
+     * Remove the packet at a position.
+     *
+     * @param pos Position of the packet
+     */
+    void erase(size_t pos);
+
+    void pop_front() { erase(0); }
+
+    /**
+     * Find a packet to an address.
+     *
+     * @param addr The prefetch address
+     * @param is_secure Whether the address is secure
+     * @return The slot of the packet, -1 if none
+     */
+    int find(Addr addr, bool is_secure) const;
+
+    /** Position of the packet in a slot */
+    size_t
+    position(int slot) const
+    {
+        assert(slots[slot]);
+        size_t idx = ringOf[slot];
+        return idx >= head ? idx - head : idx + ring.size() - head;
+    }
+
+    /** Position of a queued packet */
+    size_t position(const Entry *entry) const;
+
+    /**
+     * Raise the priority of the packet at a position, moving it behind
+     * the packets of a higher or equal priority.
+     *
+     * @param pos Position of the packet
+     * @param priority The new priority
+     */
+    void raisePriority(size_t pos, int32_t priority);
+
+  private:
+    size_t
+    ringIndex(size_t pos) const
+    {
+        pos += head;
+        return pos < ring.size() ? pos : pos - ring.size();
+    }
+
+    size_t
+    slotAt(size_t pos) const
+    {
+        assert(pos < count);
+        return ring[ringIndex(pos)];
+    }
+
+    /** Put a slot at an index of the ring */
+    void
+    setRing(size_t idx, unsigned slot)
+    {
+        ring[idx] = slot;
+        ringOf[slot] = idx;
+    }
+
+    /** Position at which a packet of a priority is queued */
+    size_t insertPosition(int32_t priority) const;
+
+    /** Insert, and remove, a slot at a position of the ring */
+    void ringInsert(size_t pos, unsigned slot);
+    void ringErase(size_t pos);
+
+    size_t
+    hashIndex(Addr addr, bool is_secure) const
+    {
+        return ((addr ^ is_secure) * 0x9e3779b97f4a7c15ULL) >> indexShift;
+    }
+
+    void indexAdd(unsigned slot);
+    void indexRemove(unsigned slot);
+
+    std::vector<std::optional<Entry>> slots;
+    std::vector<unsigned> freeSlots;
+
+    /** Slots of the queued packets, in order, from head */
+    std::vector<unsigned> ring;
+    size_t head;
+    size_t count;
+
+    /** Index in the ring of each queued slot */
+    std::vector<size_t> ringOf;
+
+    /** Slots by prefetch address, -1 for an empty entry */
+    std::vector<int> index;
+    unsigned indexShift;
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __CACHE_PREFETCH_DEFERRED_QUEUE_HH__
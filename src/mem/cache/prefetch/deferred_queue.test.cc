@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mem/cache/prefetch/deferred_queue_impl.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+struct Info
+{
+    Addr addr;
+    bool secure;
+
+    Addr getAddr() const { return addr; }
+    bool isSecure() const { return secure; }
+};
+
+struct Entry
+{
+    Info pfInfo;
+    int32_t priority;
+    int id;
+};
+
+using Queue = prefetch::DeferredQueue<Entry>;
+
+Entry
+makeEntry(Addr addr, int32_t priority, int id, bool secure = false)
+{
+    return Entry{Info{addr, secure}, priority, id};
+}
+
+/** Check the queue against the expected ids, from the front */
+void
+expectIds(const Queue &queue, const std::vector<int> &ids)
+{
+    ASSERT_EQ(queue.size(), ids.size());
+    for (size_t pos = 0; pos < ids.size(); pos++) {
+        EXPECT_EQ(queue[pos].id, ids[pos]) << "at position " << pos;
+        EXPECT_EQ(queue.position(&queue[pos]), pos);
+    }
+}
+
+} // anonymous namespace
+
+/** Packets are ordered by decreasing priority, then by age */
+TEST(DeferredQueueTest, PriorityOrder)
+{
+    Queue queue(8);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.capacity(), 8);
+
+    queue.insert(makeEntry(0x100, 0, 0));
+    queue.insert(makeEntry(0x200, 5, 1));
+    queue.insert(makeEntry(0x300, 0, 2));
+    queue.insert(makeEntry(0x400, 5, 3));
+    queue.insert(makeEntry(0x500, 9, 4));
+    queue.insert(makeEntry(0x600, -1, 5));
+
+    expectIds(queue, {4, 1, 3, 0, 2, 5});
+    EXPECT_EQ(queue.front().id, 4);
+    EXPECT_EQ(queue.back().id, 5);
+}
+
+/** Packets are found by address, and secure addresses are told apart */
+TEST(DeferredQueueTest, Find)
+{
+    Queue queue(4);
+    queue.insert(makeEntry(0x100, 0, 0));
+    queue.insert(makeEntry(0x100, 0, 1, true));
+    queue.insert(makeEntry(0x140, 3, 2));
+
+    int slot = queue.find(0x100, false);
+    ASSERT_GE(slot, 0);
+    EXPECT_EQ(queue[queue.position(slot)].id, 0);
+
+    slot = queue.find(0x100, true);
+    ASSERT_GE(slot, 0);
+    EXPECT_EQ(queue[queue.position(slot)].id, 1);
+
+    slot = queue.find(0x140, false);
+    ASSERT_GE(slot, 0);
+    EXPECT_EQ(queue.position(slot), 0);
+
+    EXPECT_LT(queue.find(0x180, false), 0);
+    EXPECT_LT(queue.find(0x140, true), 0);
+}
+
+/**
+ * Packets to the same address are each found through their own
+ * pointer, and the address is found until the last one is removed.
+ */
+TEST(DeferredQueueTest, Duplicates)
+{
+    Queue queue(4);
+    queue.insert(makeEntry(0x100, 0, 0));
+    queue.insert(makeEntry(0x100, 1, 1));
+    queue.insert(makeEntry(0x100, 2, 2));
+    expectIds(queue, {2, 1, 0});
+
+    const Entry *oldest = &queue[2];
+    queue.erase(0);
+    EXPECT_EQ(queue.position(oldest), 1);
+    ASSERT_GE(queue.find(0x100, false), 0);
+
+    queue.erase(queue.position(oldest));
+    expectIds(queue, {1});
+    ASSERT_GE(queue.find(0x100, false), 0);
+
+    queue.pop_front();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_LT(queue.find(0x100, false), 0);
+}
+
+/** Packets stay in place while others are queued and removed */
+TEST(DeferredQueueTest, Erase)
+{
+    Queue queue(6);
+    for (int i = 0; i < 6; i++)
+        queue.insert(makeEntry(0x40 * i, 0, i));
+    const Entry *third = &queue[3];
+
+    queue.erase(1);
+    expectIds(queue, {0, 2, 3, 4, 5});
+    queue.erase(3);
+    expectIds(queue, {0, 2, 3, 5});
+    queue.pop_front();
+    expectIds(queue, {2, 3, 5});
+    EXPECT_EQ(&queue[1], third);
+
+    EXPECT_LT(queue.find(0x40, false), 0);
+    EXPECT_LT(queue.find(0x100, false), 0);
+    EXPECT_GE(queue.find(0xc0, false), 0);
+
+    // Wrap around the ring
+    for (int i = 6; i < 9; i++)
+        queue.insert(makeEntry(0x40 * i, 0, i));
+    expectIds(queue, {2, 3, 5, 6, 7, 8});
+    EXPECT_EQ(&queue[1], third);
+}
+
+/** Raising the priority moves a packet behind the ones of its priority */
+TEST(DeferredQueueTest, RaisePriority)
+{
+    Queue queue(5);
+    queue.insert(makeEntry(0x000, 4, 0));
+    queue.insert(makeEntry(0x040, 2, 1));
+    queue.insert(makeEntry(0x080, 2, 2));
+    queue.insert(makeEntry(0x0c0, 0, 3));
+
+    queue.raisePriority(3, 2);
+    expectIds(queue, {0, 1, 2, 3});
+    queue.raisePriority(2, 4);
+    expectIds(queue, {0, 2, 1, 3});
+    queue.raisePriority(3, 9);
+    expectIds(queue, {3, 0, 2, 1});
+    EXPECT_EQ(queue.front().priority, 9);
+}
+
+/** Random operations match a queue kept in a plain vector */
+TEST(DeferredQueueTest, MatchesModel)
+{
+    const unsigned capacity = 16;
+    Queue queue(capacity);
+    std::vector<Entry> model;
+    std::mt19937 rng(5);
+    int next_id = 0;
+
+    auto model_insert = [&model](const Entry &e) {
+        auto it = model.begin();
+        while (it != model.end() && it->priority >= e.priority)
+            it++;
+        model.insert(it, e);
+    };
+
+    for (int op = 0; op < 20000; op++) {
+        unsigned r = rng() % 4;
+        if (model.size() < capacity && (r < 2 || model.empty())) {
+            Entry e = makeEntry(rng() % 32 * 0x40, rng() % 4, next_id++,
+                                rng() % 2);
+            queue.insert(e);
+            model_insert(e);
+        } else if (r == 2) {
+            size_t pos = rng() % model.size();
+            queue.erase(pos);
+            model.erase(model.begin() + pos);
+        } else {
+            Addr addr = rng() % 32 * 0x40;
+            bool secure = rng() % 2;
+            int slot = queue.find(addr, secure);
+            bool in_model = false;
+            for (const Entry &e : model) {
+                in_model |= e.pfInfo.addr == addr &&
+                            e.pfInfo.secure == secure;
+            }
+            ASSERT_EQ(slot >= 0, in_model);
+            if (slot < 0)
+                continue;
+
+            size_t pos = queue.position(slot);
+            ASSERT_LT(pos, model.size());
+            ASSERT_EQ(queue[pos].pfInfo.addr, addr);
+            if (queue[pos].priority < 4) {
+                queue.raisePriority(pos, 4);
+                Entry e = model[pos];
+                ASSERT_EQ(e.id, queue[queue.position(slot)].id);
+                model.erase(model.begin() + pos);
+                e.priority = 4;
+                model_insert(e);
+            }
+        }
+
+        ASSERT_EQ(queue.size(), model.size());
+        for (size_t pos = 0; pos < model.size(); pos++) {
+            ASSERT_EQ(queue[pos].id, model[pos].id);
+            ASSERT_EQ(queue.position(&queue[pos]), pos);
+        }
+    }
+}
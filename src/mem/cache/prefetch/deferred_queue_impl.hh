@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CACHE_PREFETCH_DEFERRED_QUEUE_IMPL_HH__
+#define __CACHE_PREFETCH_DEFERRED_QUEUE_IMPL_HH__
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/cache/prefetch/deferred_queue.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+template<class Entry>
+DeferredQueue<Entry>::DeferredQueue(unsigned capacity)
+    : head(0), count(0)
+{
+    fatal_if(capacity == 0, "The prefetch queues need at least one entry.");
+    slots.resize(capacity);
+    freeSlots.reserve(capacity);
+    for (unsigned slot = capacity; slot > 0; slot--)
+        freeSlots.push_back(slot - 1);
+    ring.resize(capacity);
+    ringOf.resize(capacity);
+
+    // Keep the hash table at most half full
+    unsigned index_bits = ceilLog2(capacity) + 1;
+    index.assign(1ULL << index_bits, -1);
+    indexShift = 64 - index_bits;
+}
+
+template<class Entry>
+size_t
+DeferredQueue<Entry>::insertPosition(int32_t priority) const
+{
+    // The priorities decrease from the front, so the position is the
+    // first one with a lower priority
+    if (count == 0 || priority <= back().priority)
+        return count;
+    size_t low = 0;
+    size_t high = count - 1;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if ((*this)[mid].priority < priority)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    return low;
+}
+
+template<class Entry>
+void
+DeferredQueue<Entry>::ringInsert(size_t pos, unsigned slot)
+{
+    assert(count < ring.size() && pos <= count);
+    // Move the shorter side of the ring to make room
+    if (pos < count / 2) {
+        head = head ? head - 1 : ring.size() - 1;
+        for (size_t i = 0; i < pos; i++)
+            setRing(ringIndex(i), ring[ringIndex(i + 1)]);
+    } else {
+        for (size_t i = count; i > pos; i--)
+            setRing(ringIndex(i), ring[ringIndex(i - 1)]);
+    }
+    setRing(ringIndex(pos), slot);
+    count++;
+}
+
+template<class Entry>
+void
+DeferredQueue<Entry>::ringErase(size_t pos)
+{
+    assert(pos < count);
+    if (pos < count / 2) {
+        for (size_t i = pos; i > 0; i--)
+            setRing(ringIndex(i), ring[ringIndex(i - 1)]);
+        head = ringIndex(1);
+    } else {
+        for (size_t i = pos; i + 1 < count; i++)
+            setRing(ringIndex(i), ring[ringIndex(i + 1)]);
+    }
+    count--;
+}
+
+template<class Entry>
+void
+DeferredQueue<Entry>::indexAdd(unsigned slot)
+{
+    const auto &pfi = slots[slot]->pfInfo;
+    size_t mask = index.size() - 1;
+    size_t i = hashIndex(pfi.getAddr(), pfi.isSecure());
+    while (index[i] >= 0)
+        i = (i + 1) & mask;
+    index[i] = slot;
+}
+
+template<class Entry>
+void
+DeferredQueue<Entry>::indexRemove(unsigned slot)
+{
+    const auto &pfi = slots[slot]->pfInfo;
+    size_t mask = index.size() - 1;
+    size_t i = hashIndex(pfi.getAddr(), pfi.isSecure());
+    while (index[i] != (int)slot) {
+        assert(index[i] >= 0);
+        i = (i + 1) & mask;
+    }
+
+    // Shift back the entries that follow in the probe sequence, so that
+    // lookups do not need tombstones
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (index[j] < 0)
+            break;
+        const auto &other = slots[index[j]]->pfInfo;
+        size_t home = hashIndex(other.getAddr(), other.isSecure());
+        // Move the entry if its home is not in (i, j]
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            index[i] = index[j];
+            i = j;
+        }
+    }
+    index[i] = -1;
+}
+
+template<class Entry>
+void
+DeferredQueue<Entry>::insert(const Entry &entry)
+{
+    assert(!freeSlots.empty());
+    unsigned slot = freeSlots.back();
+    freeSlots.pop_back();
+    slots[slot].emplace(entry);
+    indexAdd(slot);
+    ringInsert(insertPosition(entry.priority), slot);
+}
+
+template<class Entry>
+void
+DeferredQueue<Entry>::erase(size_t pos)
+{
+    unsigned slot = slotAt(pos);
+    indexRemove(slot);
+    ringErase(pos);
+    slots[slot].reset();
+    freeSlots.push_back(slot);
+}
+
+template<class Entry>
+int
+DeferredQueue<Entry>::find(Addr addr, bool is_secure) const
+{
+    size_t mask = index.size() - 1;
+    for (size_t i = hashIndex(addr, is_secure); index[i] >= 0;
+         i = (i + 1) & mask) {
+        const auto &pfi = slots[index[i]]->pfInfo;
+        if (pfi.getAddr() == addr && pfi.isSecure() == is_secure)
+            return index[i];
+    }
+    return -1;
+}
+
+template<class Entry>
+size_t
+DeferredQueue<Entry>::position(const Entry *entry) const
+{
+    // The packet is in the probe sequence of its address, among the
+    // packets to the same address if any
+    const auto &pfi = entry->pfInfo;
+    size_t mask = index.size() - 1;
+    for (size_t i = hashIndex(pfi.getAddr(), pfi.isSecure()); index[i] >= 0;
+         i = (i + 1) & mask) {
+        if (&*slots[index[i]] == entry)
+            return position(index[i]);
+    }
+    panic("Deferred packet is not in the prefetch queue.");
+}
+
+template<class Entry>
+void
+DeferredQueue<Entry>::raisePriority(size_t pos, int32_t priority)
+{
+    unsigned slot = slotAt(pos);
+    assert(slots[slot]->priority < priority);
+    ringErase(pos);
+    slots[slot]->priority = priority;
+    ringInsert(insertPosition(priority), slot);
+}
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __CACHE_PREFETCH_DEFERRED_QUEUE_IMPL_HH__
@@ -37,6 +37,7 @@
 
 #include "mem/cache/prefetch/queued.hh"
 
+#include <algorithm>
 #include <cassert>
 
 #include "arch/generic/tlb.hh"
@@ -45,6 +46,7 @@
 #include "debug/HWPrefetch.hh"
 #include "debug/HWPrefetchQueue.hh"
 #include "mem/cache/base.hh"
+#include "mem/cache/prefetch/deferred_queue_impl.hh"
 #include "mem/request.hh"
 #include "params/QueuedPrefetcher.hh"
 
@@ -99,7 +101,9 @@ Queued::DeferredPacket::finish(const Fault &fault,
 }
 
 Queued::Queued(const QueuedPrefetcherParams &p)
-    : Base(p), queueSize(p.queue_size),
+    : Base(p), pfq(p.queue_size),
+      pfqMissingTranslation(p.max_prefetch_requests_with_pending_translation),
+      queueSize(p.queue_size),
       missingTranslationQueueSize(
         p.max_prefetch_requests_with_pending_translation),
       latency(p.latency), queueSquash(p.queue_squash),
@@ -112,15 +116,14 @@ Queued::Queued(const QueuedPrefetcherParams &p)
 Queued::~Queued()
 {
     // Delete the queued prefetch packets
-    for (DeferredPacket &p : pfq) {
-        delete p.pkt;
+    for (size_t pos = 0; pos < pfq.size(); pos++) {
+        delete pfq[pos].pkt;
     }
 }
 
 void
-Queued::printQueue(const std::list<DeferredPacket> &queue) const
+Queued::printQueue(const DeferredQueue &queue) const
 {
-    int pos = 0;
     std::string queue_name = "";
     if (&queue == &pfq) {
         queue_name = "PFQ";
@@ -129,13 +132,13 @@ Queued::printQueue(const std::list<DeferredPacket> &queue) const
         queue_name = "PFTransQ";
     }
 
-    for (const_iterator it = queue.cbegin(); it != queue.cend();
-                                                            it++, pos++) {
-        Addr vaddr = it->pfInfo.getAddr();
+    for (size_t pos = 0; pos < queue.size(); pos++) {
+        const DeferredPacket &dp = queue[pos];
+        Addr vaddr = dp.pfInfo.getAddr();
         /* Set paddr to 0 if not yet translated */
-        Addr paddr = it->pkt ? it->pkt->getAddr() : 0;
+        Addr paddr = dp.pkt ? dp.pkt->getAddr() : 0;
         DPRINTF(HWPrefetchQueue, "%s[%d]: Prefetch Req VA: %#x PA: %#x "
-                "prio: %3d\n", queue_name, pos, vaddr, paddr, it->priority);
+                "prio: %3d\n", queue_name, pos, vaddr, paddr, dp.priority);
     }
 }
 
@@ -177,20 +180,16 @@ Queued::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
 
     // Squash queued prefetches if demand miss to same line
     if (queueSquash) {
-        auto itr = pfq.begin();
-        while (itr != pfq.end()) {
-            if (itr->pfInfo.getAddr() == blk_addr &&
-                itr->pfInfo.isSecure() == is_secure) {
-                DPRINTF(HWPrefetch, "Removing pf candidate addr: %#x "
-                        "(cl: %#x), demand request going to the same addr\n",
-                        itr->pfInfo.getAddr(),
-                        blockAddress(itr->pfInfo.getAddr()));
-                delete itr->pkt;
-                itr = pfq.erase(itr);
-                statsQueued.pfRemovedDemand++;
-            } else {
-                ++itr;
-            }
+        int slot;
+        while ((slot = pfq.find(blk_addr, is_secure)) >= 0) {
+            size_t pos = pfq.position(slot);
+            DPRINTF(HWPrefetch, "Removing pf candidate addr: %#x "
+                    "(cl: %#x), demand request going to the same addr\n",
+                    pfq[pos].pfInfo.getAddr(),
+                    blockAddress(pfq[pos].pfInfo.getAddr()));
+            delete pfq[pos].pkt;
+            pfq.erase(pos);
+            statsQueued.pfRemovedDemand++;
         }
     }
 
@@ -268,6 +267,9 @@ Queued::QueuedStats::QueuedStats(statistics::Group *parent)
              "number of prefetch candidates identified"),
     ADD_STAT(pfBufferHit, statistics::units::Count::get(),
              "number of redundant prefetches already in prefetch queue"),
+    ADD_STAT(pfBufferHitPriority, statistics::units::Count::get(),
+             "number of redundant prefetches that raised the priority of "
+             "the queued prefetch"),
     ADD_STAT(pfInCache, statistics::units::Count::get(),
              "number of redundant prefetches already in cache/mshr dropped"),
     ADD_STAT(pfRemovedDemand, statistics::units::Count::get(),
@@ -286,88 +288,72 @@ Queued::QueuedStats::QueuedStats(statistics::Group *parent)
 void
 Queued::processMissingTranslations(unsigned max)
 {
-    unsigned count = 0;
-    iterator it = pfqMissingTranslation.begin();
-    while (it != pfqMissingTranslation.end() && count < max) {
-        DeferredPacket &dp = *it;
-        // Increase the iterator first because dp.startTranslation can end up
-        // calling finishTranslation, which will erase "it"
-        it++;
-        dp.startTranslation(tlb);
-        count += 1;
+    // Collect the packets first because dp.startTranslation can end up
+    // calling finishTranslation, which will erase it from the queue. The
+    // other packets stay in place.
+    std::vector<DeferredPacket *> pending;
+    size_t count = std::min<size_t>(max, pfqMissingTranslation.size());
+    pending.reserve(count);
+    for (size_t pos = 0; pos < count; pos++) {
+        pending.push_back(&pfqMissingTranslation[pos]);
+    }
+    for (DeferredPacket *dp : pending) {
+        dp->startTranslation(tlb);
     }
 }
 
 void
 Queued::translationComplete(DeferredPacket *dp, bool failed)
 {
-    auto it = pfqMissingTranslation.begin();
-    while (it != pfqMissingTranslation.end()) {
-        if (&(*it) == dp) {
-            break;
-        }
-        it++;
-    }
-    assert(it != pfqMissingTranslation.end());
+    size_t pos = pfqMissingTranslation.position(dp);
     if (!failed) {
         DPRINTF(HWPrefetch, "%s Translation of vaddr %#x succeeded: "
                 "paddr %#x \n", tlb->name(),
-                it->translationRequest->getVaddr(),
-                it->translationRequest->getPaddr());
-        Addr target_paddr = it->translationRequest->getPaddr();
+                dp->translationRequest->getVaddr(),
+                dp->translationRequest->getPaddr());
+        Addr target_paddr = dp->translationRequest->getPaddr();
         // check if this prefetch is already redundant
-        if (cacheSnoop && (inCache(target_paddr, it->pfInfo.isSecure()) ||
-                    inMissQueue(target_paddr, it->pfInfo.isSecure()))) {
+        if (cacheSnoop && (inCache(target_paddr, dp->pfInfo.isSecure()) ||
+                    inMissQueue(target_paddr, dp->pfInfo.isSecure()))) {
             statsQueued.pfInCache++;
             DPRINTF(HWPrefetch, "Dropping redundant in "
                     "cache/MSHR prefetch addr:%#x\n", target_paddr);
         } else {
             Tick pf_time = curTick() + clockPeriod() * latency;
-            it->createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
+            dp->createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
                           pf_time);
-            addToQueue(pfq, *it);
+            addToQueue(pfq, *dp);
         }
     } else {
         DPRINTF(HWPrefetch, "%s Translation of vaddr %#x failed, dropping "
                 "prefetch request %#x \n", tlb->name(),
-                it->translationRequest->getVaddr());
+                dp->translationRequest->getVaddr());
     }
-    pfqMissingTranslation.erase(it);
+    pfqMissingTranslation.erase(pos);
 }
 
 bool
-Queued::alreadyInQueue(std::list<DeferredPacket> &queue,
-                                 const PrefetchInfo &pfi, int32_t priority)
+Queued::alreadyInQueue(DeferredQueue &queue, const PrefetchInfo &pfi,
+                       int32_t priority)
 {
-    bool found = false;
-    iterator it;
-    for (it = queue.begin(); it != queue.end() && !found; it++) {
-        found = it->pfInfo.sameAddr(pfi);
+    int slot = queue.find(pfi.getAddr(), pfi.isSecure());
+    if (slot < 0) {
+        return false;
     }
 
-    /* If the address is already in the queue, update priority and leave */
-    if (it != queue.end()) {
-        statsQueued.pfBufferHit++;
-        if (it->priority < priority) {
-            /* Update priority value and position in the queue */
-            it->priority = priority;
-            iterator prev = it;
-            while (prev != queue.begin()) {
-                prev--;
-                /* If the packet has higher priority, swap */
-                if (*it > *prev) {
-                    std::swap(*it, *prev);
-                    it = prev;
-                }
-            }
-            DPRINTF(HWPrefetch, "Prefetch addr already in "
-                "prefetch queue, priority updated\n");
-        } else {
-            DPRINTF(HWPrefetch, "Prefetch addr already in "
-                "prefetch queue\n");
-        }
+    /* The address is already in the queue, update priority and leave */
+    statsQueued.pfBufferHit++;
+    size_t pos = queue.position(slot);
+    if (queue[pos].priority < priority) {
+        /* Update priority value and position in the queue */
+        queue.raisePriority(pos, priority);
+        statsQueued.pfBufferHitPriority++;
+        DPRINTF(HWPrefetch, "Prefetch addr already in "
+            "prefetch queue, priority updated\n");
+    } else {
+        DPRINTF(HWPrefetch, "Prefetch addr already in prefetch queue\n");
     }
-    return found;
+    return true;
 }
 
 RequestPtr
@@ -481,50 +467,25 @@ Queued::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
 }
 
 void
-Queued::addToQueue(std::list<DeferredPacket> &queue,
-                             DeferredPacket &dpp)
+Queued::addToQueue(DeferredQueue &queue, DeferredPacket &dpp)
 {
     /* Verify prefetch buffer space for request */
-    if (queue.size() == queueSize) {
+    if (queue.size() == queue.capacity()) {
         statsQueued.pfRemovedFull++;
         /* Lowest priority packet */
-        iterator it = queue.end();
-        panic_if (it == queue.begin(),
-            "Prefetch queue is both full and empty!");
-        --it;
+        size_t pos = queue.size() - 1;
         /* Look for oldest in that level of priority */
-        panic_if (it == queue.begin(),
-            "Prefetch queue is full with 1 element!");
-        iterator prev = it;
-        bool cont = true;
-        /* While not at the head of the queue */
-        while (cont && prev != queue.begin()) {
-            prev--;
-            /* While at the same level of priority */
-            cont = prev->priority == it->priority;
-            if (cont)
-                /* update pointer */
-                it = prev;
+        panic_if (pos == 0, "Prefetch queue is full with 1 element!");
+        while (pos > 0 && queue[pos - 1].priority == queue[pos].priority) {
+            pos--;
         }
         DPRINTF(HWPrefetch, "Prefetch queue full, removing lowest priority "
-                            "oldest packet, addr: %#x\n",it->pfInfo.getAddr());
-        delete it->pkt;
-        queue.erase(it);
+                "oldest packet, addr: %#x\n", queue[pos].pfInfo.getAddr());
+        delete queue[pos].pkt;
+        queue.erase(pos);
     }
 
-    if ((queue.size() == 0) || (dpp <= queue.back())) {
-        queue.emplace_back(dpp);
-    } else {
-        iterator it = queue.end();
-        do {
-            --it;
-        } while (it != queue.begin() && dpp > *it);
-        /* If we reach the head, we have to see if the new element is new head
-         * or not */
-        if (it == queue.begin() && dpp <= *it)
-            it++;
-        queue.insert(it, dpp);
-    }
+    queue.insert(dpp);
 
     if (debug::HWPrefetchQueue)
         printQueue(queue);
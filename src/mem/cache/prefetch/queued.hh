@@ -39,13 +39,14 @@
 #define __MEM_CACHE_PREFETCH_QUEUED_HH__
 
 #include <cstdint>
-#include <list>
 #include <utility>
+#include <vector>
 
 #include "arch/generic/mmu.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/cache/prefetch/base.hh"
+#include "mem/cache/prefetch/deferred_queue.hh"
 #include "mem/packet.hh"
 
 namespace gem5
@@ -140,11 +141,11 @@ class Queued : public Base
         void startTranslation(BaseTLB *tlb);
     };
 
-    std::list<DeferredPacket> pfq;
-    std::list<DeferredPacket> pfqMissingTranslation;
+    /** Queue of the deferred packets, with an index by address */
+    using DeferredQueue = prefetch::DeferredQueue<DeferredPacket>;
 
-    using const_iterator = std::list<DeferredPacket>::const_iterator;
-    using iterator = std::list<DeferredPacket>::iterator;
+    DeferredQueue pfq;
+    DeferredQueue pfqMissingTranslation;
 
     // PARAMETERS
 
@@ -181,6 +182,7 @@ class Queued : public Base
         // STATS
         statistics::Scalar pfIdentified;
         statistics::Scalar pfBufferHit;
+        statistics::Scalar pfBufferHitPriority;
         statistics::Scalar pfInCache;
         statistics::Scalar pfRemovedDemand;
         statistics::Scalar pfRemovedFull;
@@ -206,7 +208,7 @@ class Queued : public Base
         return pfq.empty() ? MaxTick : pfq.front().tick;
     }
 
-    void printQueue(const std::list<DeferredPacket> &queue) const;
+    void printQueue(const DeferredQueue &queue) const;
 
   private:
 
@@ -215,7 +217,7 @@ class Queued : public Base
      * @param queue selected queue to use
      * @param dpp DeferredPacket to add
      */
-    void addToQueue(std::list<DeferredPacket> &queue, DeferredPacket &dpp);
+    void addToQueue(DeferredQueue &queue, DeferredPacket &dpp);
 
     /**
      * Starts the translations of the queued prefetches with a
@@ -243,8 +245,8 @@ class Queued : public Base
      * @param priority priority of the prefetch request to be added
      * @return True if the prefetch request was found in the queue
      */
-    bool alreadyInQueue(std::list<DeferredPacket> &queue,
-                        const PrefetchInfo &pfi, int32_t priority);
+    bool alreadyInQueue(DeferredQueue &queue, const PrefetchInfo &pfi,
+                        int32_t priority);
 
     /**
      * Returns the maxmimum number of prefetch requests that are allowed
@@ -46,9 +46,12 @@
 #define __MEM_CACHE_QUEUE_HH__
 
 #include <cassert>
+#include <cstdint>
 #include <string>
 #include <type_traits>
+#include <vector>
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/named.hh"
 #include "base/trace.hh"
@@ -101,6 +104,64 @@ class Queue : public Drainable, public Named
     /** Holds non allocated entries. */
     typename Entry::List freeList;
 
+    /**
+     * Open-addressing hash table of the allocated entries, indexed by
+     * block address, so that findMatch does not walk allocatedList.
+     * With at least twice as many slots as entries, the probe
+     * sequences stay short. The sequence number of each entry orders
+     * the matches like allocatedList does.
+     */
+    struct IndexSlot
+    {
+        Entry *entry;
+        uint64_t seq;
+    };
+    std::vector<IndexSlot> index;
+    const unsigned indexShift;
+    uint64_t indexSeq;
+
+    size_t
+    indexSlot(Addr blk_addr) const
+    {
+        return (blk_addr * 0x9e3779b97f4a7c15ULL) >> indexShift;
+    }
+
+    /** Add a newly allocated entry to the index */
+    void
+    addToIndex(Entry *entry)
+    {
+        const size_t mask = index.size() - 1;
+        size_t i = indexSlot(entry->blkAddr);
+        while (index[i].entry)
+            i = (i + 1) & mask;
+        index[i] = IndexSlot{entry, indexSeq++};
+    }
+
+    /** Remove an entry from the index, keeping the probe sequences */
+    void
+    removeFromIndex(Entry *entry)
+    {
+        const size_t mask = index.size() - 1;
+        size_t i = indexSlot(entry->blkAddr);
+        while (index[i].entry != entry) {
+            assert(index[i].entry);
+            i = (i + 1) & mask;
+        }
+
+        // shift back the following entries of the cluster that
+        // would not be found anymore past the hole
+        for (size_t j = (i + 1) & mask; index[j].entry; j = (j + 1) & mask) {
+            const size_t home = indexSlot(index[j].entry->blkAddr);
+            const bool reachable = (i <= j) ? (i < home && home <= j) :
+                                              (i < home || home <= j);
+            if (!reachable) {
+                index[i] = index[j];
+                i = j;
+            }
+        }
+        index[i] = IndexSlot{nullptr, 0};
+    }
+
     typename Entry::Iterator addToReadyList(Entry* entry)
     {
         if (readyList.empty() ||
@@ -135,6 +196,8 @@ class Queue : public Drainable, public Named
         Named(name),
         label(_label), numEntries(num_entries + reserve),
         numReserve(reserve), entries(numEntries, name + ".entry"),
+        index(2ULL << ceilLog2(numEntries), IndexSlot{nullptr, 0}),
+        indexShift(64 - floorLog2(index.size())), indexSeq(0),
         _numInService(0), allocated(0)
     {
         for (int i = 0; i < numEntries; ++i) {
@@ -168,7 +231,11 @@ class Queue : public Drainable, public Named
     Entry* findMatch(Addr blk_addr, bool is_secure,
                      bool ignore_uncacheable = true) const
     {
-        for (const auto& entry : allocatedList) {
+        const size_t mask = index.size() - 1;
+        const IndexSlot *match = nullptr;
+        for (size_t i = indexSlot(blk_addr); index[i].entry;
+             i = (i + 1) & mask) {
+            const Entry *entry = index[i].entry;
             // we ignore any entries allocated for uncacheable
             // accesses and simply ignore them when matching, in the
             // cache we never check for matches when adding new
@@ -176,11 +243,12 @@ class Queue : public Drainable, public Named
             // cacheable accesses being added to an WriteQueueEntry
             // serving an uncacheable access
             if (!(ignore_uncacheable && entry->isUncacheable()) &&
-                entry->matchBlockAddr(blk_addr, is_secure)) {
-                return entry;
+                entry->matchBlockAddr(blk_addr, is_secure) &&
+                (!match || index[i].seq < match->seq)) {
+                match = &index[i];
             }
         }
-        return nullptr;
+        return match ? match->entry : nullptr;
     }
 
     bool trySatisfyFunctional(PacketPtr pkt)
@@ -241,6 +309,7 @@ class Queue : public Drainable, public Named
     deallocate(Entry *entry)
     {
         allocatedList.erase(entry->allocIter);
+        removeFromIndex(entry);
         freeList.push_front(entry);
         allocated--;
         if (entry->inService) {
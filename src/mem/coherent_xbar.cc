@@ -50,6 +50,7 @@
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/CoherentXBar.hh"
+#include "debug/Drain.hh"
 #include "sim/system.hh"
 
 namespace gem5
@@ -62,6 +63,7 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams &p)
       maxRoutingTableSizeCheck(p.max_routing_table_size),
       pointOfCoherency(p.point_of_coherency),
       pointOfUnification(p.point_of_unification),
+      backInvalidateEvent([this]{ sendBackInvalidations(true); }, name()),
 
       ADD_STAT(snoops, statistics::units::Count::get(), "Total snoops"),
       ADD_STAT(snoopTraffic, statistics::units::Byte::get(), "Total snoop traffic"),
@@ -170,6 +172,29 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
         return false;
     }
 
+    const bool snoop_caches = !system->bypassCaches() &&
+        pkt->cmd != MemCmd::WriteClean;
+
+    // a bounded snoop filter may have no room to track the line until
+    // the caches above have evicted some of the lines it evicted, in
+    // which case the request is retried
+    if (snoopFilter && snoop_caches && !is_express_snoop &&
+        !snoopFilter->canLookupRequest(pkt, *src_port)) {
+        DPRINTF(CoherentXBar, "%s: src %s packet %s SF FULL\n", __func__,
+                src_port->name(), pkt->print());
+
+        // ask again for the evicted lines, in case a holder kept one
+        // as it had a request in flight for it
+        snoopFilter->retryEvictedLines();
+        queueBackInvalidation();
+        if (!backInvalidations.empty() && !backInvalidateEvent.scheduled())
+            schedule(backInvalidateEvent, clockEdge(forwardLatency));
+
+        reqLayers[mem_side_port_id]->retryTiming(src_port,
+                                                 clockEdge(Cycles(1)));
+        return false;
+    }
+
     DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
             src_port->name(), pkt->print());
 
@@ -196,8 +221,6 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
     // the request
     const bool is_destination = isDestination(pkt);
 
-    const bool snoop_caches = !system->bypassCaches() &&
-        pkt->cmd != MemCmd::WriteClean;
     if (snoop_caches) {
         assert(pkt->snoopDelay == 0);
 
@@ -305,6 +328,10 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
     if (snoopFilter && snoop_caches) {
         // Let the snoop filter know about the success of the send operation
         snoopFilter->finishRequest(!success, addr, pkt->isSecure());
+
+        queueBackInvalidation();
+        if (!backInvalidations.empty() && !backInvalidateEvent.scheduled())
+            schedule(backInvalidateEvent, clockEdge(forwardLatency));
     }
 
     // check if we were successful in sending the packet onwards
@@ -772,6 +799,7 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
             // avoid situations where atomic upward snoops sneak in
             // between and change the filter state
             snoopFilter->finishRequest(false, pkt->getAddr(), pkt->isSecure());
+            queueBackInvalidation();
 
             if (pkt->isEviction()) {
                 // for block-evicting packets, i.e. writebacks and
@@ -882,6 +910,12 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
 
     // @todo: Not setting header time
     pkt->payloadDelay = response_latency;
+
+    // now that the request is done, the caches above can evict the
+    // lines the snoop filter evicted
+    if (!backInvalidations.empty())
+        sendBackInvalidations(false);
+
     return response_latency;
 }
 
@@ -926,6 +960,64 @@ CoherentXBar::recvAtomicSnoop(PacketPtr pkt, PortID mem_side_port_id)
     return snoop_response_latency;
 }
 
+void
+CoherentXBar::queueBackInvalidation()
+{
+    while (true) {
+        BackInvalidation inval;
+        inval.holders = snoopFilter->takeEvictedLine(inval.addr,
+                                                     inval.isSecure);
+        if (inval.holders.empty())
+            return;
+        backInvalidations.push_back(std::move(inval));
+    }
+}
+
+void
+CoherentXBar::sendBackInvalidations(bool is_timing)
+{
+    while (!backInvalidations.empty()) {
+        const BackInvalidation inval = std::move(backInvalidations.front());
+        backInvalidations.pop_front();
+
+        RequestPtr req = std::make_shared<Request>(
+            inval.addr, system->cacheLineSize(), 0,
+            Request::wbRequestorId);
+        if (inval.isSecure)
+            req->setFlags(Request::SECURE);
+        Packet pkt(req, MemCmd::BackInvalidateReq);
+
+        DPRINTF(CoherentXBar, "%s: %s to %d holders\n", __func__,
+                pkt.print(), inval.holders.size());
+
+        if (is_timing) {
+            pkt.setExpressSnoop();
+            forwardTiming(&pkt, InvalidPortID, inval.holders);
+        } else {
+            forwardAtomic(&pkt, InvalidPortID, InvalidPortID,
+                          inval.holders);
+        }
+    }
+
+    if (is_timing && drainState() == DrainState::Draining) {
+        DPRINTF(Drain, "Crossbar done with its back invalidations\n");
+        signalDrainDone();
+    }
+}
+
+DrainState
+CoherentXBar::drain()
+{
+    // the caches above have to see the back invalidations before they
+    // drain, as the lines are evicted from the snoop filter already
+    if (backInvalidateEvent.scheduled() || !backInvalidations.empty()) {
+        DPRINTF(Drain, "Crossbar not drained, back invalidations "
+                "pending\n");
+        return DrainState::Draining;
+    }
+    return DrainState::Drained;
+}
+
 std::pair<MemCmd, Tick>
 CoherentXBar::forwardAtomic(PacketPtr pkt, PortID exclude_cpu_side_port_id,
                            PortID source_mem_side_port_id,
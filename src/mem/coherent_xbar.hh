@@ -46,6 +46,7 @@
 #ifndef __MEM_COHERENT_XBAR_HH__
 #define __MEM_COHERENT_XBAR_HH__
 
+#include <deque>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -298,6 +299,34 @@ class CoherentXBar : public BaseXBar
      */
     std::unique_ptr<Packet> pendingDelete;
 
+    /** A line evicted by the snoop filter, still held above */
+    struct BackInvalidation
+    {
+        Addr addr;
+        bool isSecure;
+        SnoopFilter::SnoopList holders;
+    };
+
+    /** Back invalidations waiting to be sent to the caches above */
+    std::deque<BackInvalidation> backInvalidations;
+
+    /**
+     * Queue the lines, if any, that the snoop filter evicted and whose
+     * holders have to be asked to evict them.
+     */
+    void queueBackInvalidation();
+
+    /**
+     * Ask the holders of the queued lines to evict them. The caches
+     * write back or clean evict the lines as if they were replaced,
+     * which in turn removes them from the snoop filter. In timing
+     * mode the snoops are sent from an event, as they may ask the
+     * cache whose request caused the eviction to evict a block.
+     */
+    void sendBackInvalidations(bool is_timing);
+
+    EventFunctionWrapper backInvalidateEvent;
+
     bool recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id);
     bool recvTimingResp(PacketPtr pkt, PortID mem_side_port_id);
     void recvTimingSnoopReq(PacketPtr pkt, PortID mem_side_port_id);
@@ -431,6 +460,8 @@ class CoherentXBar : public BaseXBar
     virtual ~CoherentXBar();
 
     virtual void regStats();
+
+    DrainState drain() override;
 };
 
 } // namespace gem5
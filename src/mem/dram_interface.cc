@@ -58,6 +58,124 @@ namespace memory
 
 std::pair<MemPacketQueue::iterator, Tick>
 DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
+{
+    // The policy picks, in order of preference and in arrival order
+    // within each category:
+    // 1. a seamless row hit, i.e. a row hit that can issue by min_col_at
+    // 2. a row miss to one of the earliest banks to prep, if the bank can
+    //    be prepped without impacting utilization
+    // 3. any row hit
+    // 4. a row miss to one of the earliest banks to prep
+    // Only packets to available ranks are considered. As the packets are
+    // bucketed per bank, the first hit and the first miss of each bank
+    // are enough to find the first packet of each category.
+    const MemPacket* first_seamless = nullptr;
+    const MemPacket* first_hit = nullptr;
+    bool found_miss = false;
+
+    auto earlier = [](const MemPacket* pkt, const MemPacket* other)
+    {
+        return !other || pkt->queueSeqNum < other->queueSeqNum;
+    };
+
+    const std::vector<uint16_t>& busy_banks = queue.busyBanks(pseudoChannel);
+    for (uint16_t bank_id : busy_banks) {
+        const auto& pkts = queue.bankPackets(pseudoChannel, bank_id);
+        const MemPacket* head = pkts.front();
+
+        // check if rank is not doing a refresh and thus is available
+        if (!ranks[head->rank]->inRefIdleState())
+            continue;
+
+        const Bank& bank = ranks[head->rank]->banks[head->bank];
+        const MemPacket* bank_hit = nullptr;
+        bool bank_miss = false;
+        for (const MemPacket* pkt : pkts) {
+            if (bank.openRow == pkt->row) {
+                if (!bank_hit)
+                    bank_hit = pkt;
+            } else {
+                bank_miss = true;
+            }
+            if (bank_hit && bank_miss)
+                break;
+        }
+
+        found_miss |= bank_miss;
+        if (bank_hit) {
+            const Tick col_allowed_at = bank_hit->isRead() ?
+                bank.rdAllowedAt : bank.wrAllowedAt;
+            if (col_allowed_at <= min_col_at &&
+                earlier(bank_hit, first_seamless)) {
+                first_seamless = bank_hit;
+            }
+            if (earlier(bank_hit, first_hit))
+                first_hit = bank_hit;
+        }
+    }
+
+    const MemPacket* selected = first_seamless;
+
+    if (!selected && found_miss) {
+        std::vector<uint32_t> earliest_banks;
+        bool hidden_bank_prep;
+        std::tie(earliest_banks, hidden_bank_prep) =
+            minBankPrep(queue, min_col_at);
+
+        // find the first miss to one of the earliest banks
+        const MemPacket* first_miss = nullptr;
+        for (uint16_t bank_id : busy_banks) {
+            const auto& pkts = queue.bankPackets(pseudoChannel, bank_id);
+            const MemPacket* head = pkts.front();
+            if (!ranks[head->rank]->inRefIdleState() ||
+                !bits(earliest_banks[head->rank], head->bank, head->bank)) {
+                continue;
+            }
+
+            const Bank& bank = ranks[head->rank]->banks[head->bank];
+            for (const MemPacket* pkt : pkts) {
+                if (bank.openRow != pkt->row) {
+                    if (earlier(pkt, first_miss))
+                        first_miss = pkt;
+                    break;
+                }
+            }
+        }
+
+        // give priority to packets that can issue bank commands 'behind
+        // the scenes', otherwise to row hits
+        if (first_miss && (hidden_bank_prep || !first_hit))
+            selected = first_miss;
+    }
+
+    if (!selected)
+        selected = first_hit;
+
+    auto selected_pkt_it = queue.end();
+    Tick selected_col_at = MaxTick;
+    if (selected) {
+        selected_pkt_it = queue.find(selected);
+        const Bank& bank = ranks[selected->rank]->banks[selected->bank];
+        selected_col_at = selected->isRead() ? bank.rdAllowedAt :
+                                               bank.wrAllowedAt;
+        DPRINTF(DRAM, "%s selected packet in bank %d, row %d\n", __func__,
+                selected->bank, selected->row);
+    } else {
+        DPRINTF(DRAM, "%s no available DRAM ranks found\n", __func__);
+    }
+
+    if (checkFRFCFSIndex) {
+        auto scanned = scanNextFRFCFS(queue, min_col_at);
+        panic_if(scanned.first != selected_pkt_it ||
+                 scanned.second != selected_col_at,
+                 "Indexed FR-FCFS selection does not match the queue scan");
+    }
+
+    return std::make_pair(selected_pkt_it, selected_col_at);
+}
+
+std::pair<MemPacketQueue::iterator, Tick>
+DRAMInterface::scanNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
 {
     std::vector<uint32_t> earliest_banks(ranksPerChannel, 0);
 
@@ -657,6 +775,8 @@ DRAMInterface::DRAMInterface(const DRAMInterfaceParams &_p)
       maxAccessesPerRow(_p.max_accesses_per_row),
       timeStampOffset(0), activeRank(0),
       enableDRAMPowerdown(_p.enable_dram_powerdown),
+      lazyRefresh(_p.lazy_refresh),
+      checkFRFCFSIndex(_p.check_frfcfs_index),
       lastStatsResetTick(0),
       stats(*this)
 {
@@ -796,6 +916,12 @@ DRAMInterface::startup()
 bool
 DRAMInterface::isBusy(bool read_queue_empty, bool all_writes_nvm)
 {
+    if (lazyRefresh) {
+        for (auto r : ranks) {
+            r->catchUpRefresh();
+        }
+    }
+
     int busy_ranks = 0;
     for (auto r : ranks) {
         if (!r->inRefIdleState()) {
@@ -919,6 +1045,9 @@ DRAMInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
 
 void DRAMInterface::setupRank(const uint8_t rank, const bool is_read)
 {
+    if (lazyRefresh)
+        ranks[rank]->resumeRefresh();
+
     // increment entry count of the rank based on packet type
     if (is_read) {
         ++ranks[rank]->readEntries;
@@ -992,6 +1121,9 @@ DRAMInterface::drainRanks()
 {
     // also need to kick off events to exit self-refresh
     for (auto r : ranks) {
+        // deferred refreshes have to run to completion
+        r->resumeRefresh();
+
         // force self-refresh exit, which in turn will issue auto-refresh
         if (r->pwrState == PWR_SREF) {
             DPRINTF(DRAM,"Rank%d: Forcing self-refresh wakeup in drain\n",
@@ -1011,7 +1143,7 @@ DRAMInterface::allRanksDrained() const
         // closed and rank is not in a low power state. Also verify that rank
         // is idle from a refresh point of view.
         all_ranks_drained = r->inPwrIdleState() && r->inRefIdleState() &&
-            all_ranks_drained;
+            !r->inDeferredRefresh() && all_ranks_drained;
     }
     return all_ranks_drained;
 }
@@ -1024,6 +1156,16 @@ DRAMInterface::suspend()
     }
 }
 
+void
+DRAMInterface::resumeRefresh()
+{
+    // a queued request schedules the controller, which holds up the
+    // refreshes of the active rank, see REF_DRAIN. The other ranks are
+    // resumed when a request for them is queued, see setupRank()
+    if (lazyRefresh)
+        ranks[activeRank]->resumeRefresh();
+}
+
 std::pair<std::vector<uint32_t>, bool>
 DRAMInterface::minBankPrep(const MemPacketQueue& queue,
                       Tick min_col_at) const
@@ -1041,11 +1183,10 @@ DRAMInterface::minBankPrep(const MemPacketQueue& queue,
     // determine if we have queued transactions targetting the
     // bank in question
     std::vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->pseudoChannel != pseudoChannel)
-            continue;
-        if (p->isDram() && ranks[p->rank]->inRefIdleState())
-            got_waiting[p->bankId] = true;
+    for (uint16_t bank_id : queue.busyBanks(pseudoChannel)) {
+        const MemPacket* p = queue.bankPackets(pseudoChannel, bank_id).front();
+        if (ranks[p->rank]->inRefIdleState())
+            got_waiting[bank_id] = true;
     }
 
     // Find command with optimal bank timing
@@ -1118,7 +1259,8 @@ DRAMInterface::Rank::Rank(const DRAMInterfaceParams &_p,
                          int _rank, DRAMInterface& _dram)
     : EventManager(&_dram), dram(_dram),
       pwrStateTrans(PWR_IDLE), pwrStatePostRefresh(PWR_IDLE),
-      pwrStateTick(0), refreshDueAt(0), pwrState(PWR_IDLE),
+      pwrStateTick(0), refreshDueAt(0), refreshDeferred(false),
+      pwrState(PWR_IDLE),
       refreshState(REF_IDLE), inLowPowerState(false), rank(_rank),
       readEntries(0), writeEntries(0), outstandingEvents(0),
       wakeUpAllowedAt(0), power(_p, false), banks(_p.banks_per_rank),
@@ -1167,6 +1309,7 @@ DRAMInterface::Rank::startup(Tick ref_tick)
 void
 DRAMInterface::Rank::suspend()
 {
+    resumeRefresh();
     deschedule(refreshEvent);
 
     // Update the stats
@@ -1203,7 +1346,7 @@ DRAMInterface::Rank::checkDrainDone()
 }
 
 void
-DRAMInterface::Rank::flushCmdList()
+DRAMInterface::Rank::flushCmdList(Tick now)
 {
     // at the moment sort the list of commands and update the counters
     // for DRAMPower libray when doing a refresh
@@ -1213,8 +1356,8 @@ DRAMInterface::Rank::flushCmdList()
     // push to commands to DRAMPower
     for ( ; next_iter != cmdList.end() ; ++next_iter) {
          Command cmd = *next_iter;
-         if (cmd.timeStamp <= curTick()) {
-             // Move all commands at or before curTick to DRAMPower
+         if (cmd.timeStamp <= now) {
+             // Move all commands at or before now to DRAMPower
              power.powerlib.doCommand(cmd.type, cmd.bank,
                                       divCeil(cmd.timeStamp, dram.tCK) -
                                       dram.timeStampOffset);
@@ -1381,7 +1524,7 @@ DRAMInterface::Rank::processRefreshEvent()
             // or have outstanding ACT,RD/WR,Auto-PRE sequence scheduled
             // should have outstanding precharge or read response event
             assert(prechargeEvent.scheduled() ||
-                   dram.ctrl->respondEventScheduled());
+                   dram.ctrl->respondEventScheduled(dram.pseudoChannel));
             // will start refresh when pwrState transitions to IDLE
         }
 
@@ -1672,6 +1815,15 @@ DRAMInterface::Rank::processPowerEvent()
                            " rank %d\n", rank);
             dram.ctrl->restartScheduler(curTick(), dram.pseudoChannel);
         }
+
+        // if nothing but refreshes can happen until the controller
+        // gets a request, stop scheduling them
+        if (canDeferRefresh()) {
+            DPRINTF(DRAMState, "Deferring refreshes of idle rank %d\n",
+                    rank);
+            deschedule(refreshEvent);
+            refreshDeferred = true;
+        }
     }
 
     if ((pwrState == PWR_ACT) && (refreshState == REF_PD_EXIT)) {
@@ -1763,17 +1915,17 @@ DRAMInterface::Rank::processPowerEvent()
 }
 
 void
-DRAMInterface::Rank::updatePowerStats()
+DRAMInterface::Rank::updatePowerStats(Tick now)
 {
     // All commands up to refresh have completed
     // flush cmdList to DRAMPower
-    flushCmdList();
+    flushCmdList(now);
 
     // Call the function that calculates window energy at intermediate update
     // events like at refresh, stats dump as well as at simulation exit.
     // Window starts at the last time the calcWindowEnergy function was called
     // and is upto current time.
-    power.powerlib.calcWindowEnergy(divCeil(curTick(), dram.tCK) -
+    power.powerlib.calcWindowEnergy(divCeil(now, dram.tCK) -
                                     dram.timeStampOffset);
 
     // Get the energy from DRAMPower
@@ -1801,7 +1953,7 @@ DRAMInterface::Rank::updatePowerStats()
     // power (mW) = ----------- * ----------
     //              time (tick)   tick_frequency
     stats.averagePower = (stats.totalEnergy.value() /
-                    (curTick() - dram.lastStatsResetTick)) *
+                    (now - dram.lastStatsResetTick)) *
                     (sim_clock::Frequency / 1000000000.0);
 }
 
@@ -1810,6 +1962,8 @@ DRAMInterface::Rank::computeStats()
 {
     DPRINTF(DRAM,"Computing stats due to a dump callback\n");
 
+    catchUpRefresh();
+
     // Update the stats
     updatePowerStats();
 
@@ -1828,6 +1982,97 @@ DRAMInterface::Rank::resetStats() {
 
 }
 
+bool
+DRAMInterface::Rank::canDeferRefresh() const
+{
+    return dram.lazyRefresh && !dram.enableDRAMPowerdown &&
+           pwrState == PWR_IDLE && refreshState == REF_IDLE &&
+           pwrStatePostRefresh == PWR_IDLE && numBanksActive == 0 &&
+           outstandingEvents == 0 && readEntries == 0 &&
+           writeEntries == 0 &&
+           (rank != dram.activeRank ||
+            !dram.ctrl->requestEventScheduled(dram.pseudoChannel)) &&
+           refreshEvent.scheduled() && !powerEvent.scheduled() &&
+           !activateEvent.scheduled() && !prechargeEvent.scheduled() &&
+           !writeDoneEvent.scheduled() && !wakeUpEvent.scheduled() &&
+           dram.ctrl->drainState() == DrainState::Running;
+}
+
+void
+DRAMInterface::Rank::catchUpRefresh()
+{
+    while (refreshDeferred) {
+        // this is when the refresh event would have been processed, see
+        // the end of the REF_RUN state
+        Tick ref_at = refreshDueAt - dram.tRP;
+        if (ref_at >= curTick())
+            return;
+
+        // an idle rank goes from the idle power state straight to the
+        // refresh, with all transitions happening at ref_at
+        stats.pwrStateTime[PWR_IDLE] += ref_at - pwrStateTick;
+        pwrStateTick = ref_at;
+
+        Tick ref_done_at = ref_at + dram.tRFC;
+
+        for (auto &b : banks) {
+            b.actAllowedAt = ref_done_at;
+        }
+
+        cmdList.push_back(Command(MemCommand::REF, 0, ref_at));
+
+        // Update the stats, DRAMPower sees the same windows as when
+        // the refresh is issued by the refresh event
+        updatePowerStats(ref_at);
+
+        DPRINTF(DRAMPower, "%llu,REF,0,%d\n", divCeil(ref_at, dram.tCK) -
+                dram.timeStampOffset, rank);
+
+        refreshDueAt = ref_at + dram.tREFI;
+
+        if (ref_done_at >= curTick()) {
+            // the refresh is still running, let the refresh and power
+            // events finish it as usual
+            pwrState = PWR_REF;
+            refreshState = REF_RUN;
+            ++outstandingEvents;
+            refreshDeferred = false;
+            schedule(refreshEvent, ref_done_at);
+            return;
+        }
+
+        stats.pwrStateTime[PWR_REF] += dram.tRFC;
+        pwrStateTick = ref_done_at;
+    }
+}
+
+void
+DRAMInterface::Rank::resumeRefresh()
+{
+    catchUpRefresh();
+
+    if (refreshDeferred) {
+        refreshDeferred = false;
+        schedule(refreshEvent, refreshDueAt - dram.tRP);
+    }
+}
+
+bool
+DRAMInterface::Rank::inDeferredRefresh() const
+{
+    if (!refreshDeferred)
+        return false;
+
+    Tick ref_at = refreshDueAt - dram.tRP;
+    if (ref_at >= curTick())
+        return false;
+
+    // find the last refresh that started before curTick()
+    Tick period = dram.tREFI - dram.tRP;
+    ref_at += (curTick() - 1 - ref_at) / period * period;
+    return curTick() <= ref_at + dram.tRFC;
+}
+
 bool
 DRAMInterface::Rank::forceSelfRefreshExit() const {
     return (readEntries != 0) ||
@@ -2014,6 +2259,9 @@ DRAMInterface::RankStats::regStats()
 void
 DRAMInterface::RankStats::resetStats()
 {
+    // account for deferred refreshes in the window that is being reset
+    rank.catchUpRefresh();
+
     statistics::Group::resetStats();
 
     rank.resetStats();
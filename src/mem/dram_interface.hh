@@ -256,10 +256,28 @@ class DRAMInterface : public MemInterface
          */
         Tick refreshDueAt;
 
+        /**
+         * The rank is idle and its refresh event is not scheduled. The
+         * refreshes that would have been issued since are accounted for
+         * when the rank is next looked at, see catchUpRefresh().
+         */
+        bool refreshDeferred;
+
         /**
          * Function to update Power Stats
+         *
+         * @param now Tick up to which the stats are updated
          */
-        void updatePowerStats();
+        void updatePowerStats(Tick now);
+        void updatePowerStats() { updatePowerStats(curTick()); }
+
+        /**
+         * Check if the rank is idle enough to stop scheduling refresh
+         * events, i.e. nothing but refreshes can happen to it until the
+         * controller gets a request for it. Other ranks may be busy, but
+         * the controller must not be about to serve the active rank.
+         */
+        bool canDeferRefresh() const;
 
         /**
          * Schedule a power state transition in the future, and
@@ -365,6 +383,27 @@ class DRAMInterface : public MemInterface
          */
         void suspend();
 
+        /**
+         * Account for the refreshes of a deferred rank that started before
+         * curTick(). If a refresh is still running, the rank goes back to
+         * scheduling events for the rest of it.
+         */
+        void catchUpRefresh();
+
+        /**
+         * Catch up on deferred refreshes and schedule the refresh event
+         * again, e.g. since the controller is about to use the rank.
+         */
+        void resumeRefresh();
+
+        /**
+         * Check if a deferred refresh is running at curTick(), without
+         * catching up on it.
+         *
+         * @return true if the rank would be refreshing
+         */
+        bool inDeferredRefresh() const;
+
         /**
          * Check if there is no refresh and no preparation of refresh ongoing
          * i.e. the refresh state machine is in idle
@@ -413,8 +452,10 @@ class DRAMInterface : public MemInterface
          * or before curTick() to DRAMPower library
          * All commands before curTick are guaranteed to be complete
          * and can safely be flushed.
+         *
+         * @param now Tick up to which commands are pushed
          */
-        void flushCmdList();
+        void flushCmdList(Tick now);
 
         /**
          * Computes stats just prior to dump event
@@ -533,6 +574,18 @@ class DRAMInterface : public MemInterface
     /** Enable or disable DRAM powerdown states. */
     bool enableDRAMPowerdown;
 
+    /**
+     * Stop scheduling refresh events for idle ranks and account for
+     * their refreshes when they are next used or stats are dumped.
+     */
+    const bool lazyRefresh;
+
+    /**
+     * Check the FR-FCFS decisions taken using the bank index of the queue
+     * against the ones taken by going through the whole queue.
+     */
+    const bool checkFRFCFSIndex;
+
     /** The time when stats were last reset used to calculate average power */
     Tick lastStatsResetTick;
 
@@ -638,6 +691,18 @@ class DRAMInterface : public MemInterface
     std::pair<std::vector<uint32_t>, bool>
     minBankPrep(const MemPacketQueue& queue, Tick min_col_at) const;
 
+    /**
+     * Reference implementation of the FR-FCFS policy, going through the
+     * whole queue in arrival order. Used to check chooseNextFRFCFS.
+     *
+     * @param queue Queued requests to consider
+     * @param min_col_at Minimum tick for 'seamless' issue
+     * @return an iterator to the selected packet, else queue.end()
+     * @return the tick when the packet selected will issue
+     */
+    std::pair<MemPacketQueue::iterator, Tick>
+    scanNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const;
+
     /*
      * @return time to send a burst of data without gaps
      */
@@ -691,6 +756,11 @@ class DRAMInterface : public MemInterface
      */
     void suspend() override;
 
+    /**
+     * Resume the refresh events of the active rank if it deferred them
+     */
+    void resumeRefresh() override;
+
     /*
      * @return time to offset next command
      */
@@ -465,6 +465,13 @@ HBMCtrl::verifyMultiCmd(Tick cmd_tick, Tick max_cmds_per_burst,
     return cmd_at;
 }
 
+void
+HBMCtrl::resumeIntfRefresh()
+{
+    MemCtrl::resumeIntfRefresh();
+    pc1Int->resumeRefresh();
+}
+
 void
 HBMCtrl::drainResume()
 {
@@ -62,8 +62,8 @@ HeteroMemCtrl::HeteroMemCtrl(const HeteroMemCtrlParams &p) :
     nvm(p.nvm)
 {
     DPRINTF(MemCtrl, "Setting up controller\n");
-    readQueue.resize(p.qos_priorities);
-    writeQueue.resize(p.qos_priorities);
+    readQueue.resize(p.qos_priorities, MemPacketQueue(true));
+    writeQueue.resize(p.qos_priorities, MemPacketQueue(true));
 
     fatal_if(dynamic_cast<DRAMInterface*>(dram) == nullptr,
             "HeteroMemCtrl's dram interface must be of type DRAMInterface.\n");
@@ -431,6 +431,7 @@ HeteroMemCtrl::drain()
         }
 
         dram->drainRanks();
+        nvm->drainRanks();
 
         return DrainState::Draining;
     } else {
@@ -40,6 +40,8 @@
 
 #include "mem/mem_ctrl.hh"
 
+#include <algorithm>
+
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
 #include "debug/Drain.hh"
@@ -57,6 +59,87 @@ namespace gem5
 namespace memory
 {
 
+void
+MemPacketQueue::push_back(MemPacket* mem_pkt)
+{
+    mem_pkt->queueSeqNum = nextSeqNum++;
+    queue.push_back(mem_pkt);
+
+    if (!indexBanks || !mem_pkt->isDram())
+        return;
+
+    if (dramQueues.size() <= mem_pkt->pseudoChannel)
+        dramQueues.resize(mem_pkt->pseudoChannel + 1);
+    ChannelQueues &channel = dramQueues[mem_pkt->pseudoChannel];
+
+    if (channel.banks.size() <= mem_pkt->bankId)
+        channel.banks.resize(mem_pkt->bankId + 1);
+    BankQueue &bank = channel.banks[mem_pkt->bankId];
+
+    if (bank.pkts.empty()) {
+        bank.busyIdx = channel.busyBanks.size();
+        channel.busyBanks.push_back(mem_pkt->bankId);
+    }
+    bank.pkts.push_back(mem_pkt);
+}
+
+MemPacketQueue::iterator
+MemPacketQueue::erase(iterator it)
+{
+    MemPacket* mem_pkt = *it;
+
+    if (indexBanks && mem_pkt->isDram()) {
+        ChannelQueues &channel = dramQueues[mem_pkt->pseudoChannel];
+        BankQueue &bank = channel.banks[mem_pkt->bankId];
+
+        // Packets are mostly taken out close to the head of the bank
+        auto bank_it = std::find(bank.pkts.begin(), bank.pkts.end(),
+                                 mem_pkt);
+        assert(bank_it != bank.pkts.end());
+        bank.pkts.erase(bank_it);
+
+        if (bank.pkts.empty()) {
+            // Move the last busy bank to the position of this one
+            uint16_t last_bank = channel.busyBanks.back();
+            channel.busyBanks[bank.busyIdx] = last_bank;
+            channel.banks[last_bank].busyIdx = bank.busyIdx;
+            channel.busyBanks.pop_back();
+            bank.busyIdx = -1;
+        }
+    }
+
+    return queue.erase(it);
+}
+
+MemPacketQueue::iterator
+MemPacketQueue::find(const MemPacket* mem_pkt)
+{
+    // The queue is sorted by arrival order
+    auto it = std::lower_bound(queue.begin(), queue.end(),
+        mem_pkt->queueSeqNum,
+        [](const MemPacket* pkt, uint64_t seq_num)
+        { return pkt->queueSeqNum < seq_num; });
+    assert(it != queue.end() && *it == mem_pkt);
+    return it;
+}
+
+const std::vector<uint16_t>&
+MemPacketQueue::busyBanks(uint8_t pseudo_channel) const
+{
+    assert(indexBanks);
+    static const std::vector<uint16_t> no_banks;
+    if (dramQueues.size() <= pseudo_channel)
+        return no_banks;
+    return dramQueues[pseudo_channel].busyBanks;
+}
+
+const MemPacketQueue::BankPackets&
+MemPacketQueue::bankPackets(uint8_t pseudo_channel, uint16_t bank_id) const
+{
+    assert(indexBanks);
+    return dramQueues[pseudo_channel].banks[bank_id].pkts;
+}
+
 MemCtrl::MemCtrl(const MemCtrlParams &p) :
     qos::MemCtrl(p),
     port(name() + ".port", *this), isTimingMode(false),
@@ -82,8 +165,8 @@ MemCtrl::MemCtrl(const MemCtrlParams &p) :
 {
     DPRINTF(MemCtrl, "Setting up controller\n");
 
-    readQueue.resize(p.qos_priorities);
-    writeQueue.resize(p.qos_priorities);
+    readQueue.resize(p.qos_priorities, MemPacketQueue(true));
+    writeQueue.resize(p.qos_priorities, MemPacketQueue(true));
 
     dram->setCtrl(this, commandWindow);
 
@@ -193,6 +276,10 @@ MemCtrl::addToReadQueue(PacketPtr pkt,
 
     assert(pkt_count != 0);
 
+    // idle ranks may have stopped refreshing on their own, get them
+    // going again before the request is scheduled
+    resumeIntfRefresh();
+
     // if the request size is larger than burst size, the pkt is split into
     // multiple packets
     // Note if the pkt starting address is not aligened to burst size, the
@@ -304,6 +391,8 @@ MemCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pkt_count,
     // eventually done, set the readyTime, and call schedule()
     assert(pkt->isWrite());
 
+    resumeIntfRefresh();
+
     // if the request size is larger than burst size, the pkt is split into
     // multiple packets
     const Addr base_addr = pkt->getAddr();
@@ -521,10 +610,11 @@ MemCtrl::processRespondEvent(MemInterface* mem_intr,
         assert(!resp_event.scheduled());
         schedule(resp_event, queue.front()->readyTime);
     } else {
-        // if there is nothing left in any queue, signal a drain
+        // if there is nothing left in any queue, signal a drain; with
+        // several channels the others may still have responses queued
         if (drainState() == DrainState::Draining &&
             !totalWriteQueueSize && !totalReadQueueSize &&
-            allIntfDrained()) {
+            respQEmpty() && allIntfDrained()) {
 
             DPRINTF(Drain, "Controller done draining\n");
             signalDrainDone();
@@ -1120,8 +1210,9 @@ MemCtrl::processNextReqEvent(MemInterface* mem_intr,
     }
     // It is possible that a refresh to another rank kicks things back into
     // action before reaching this point.
-    if (!next_req_event.scheduled())
-        schedule(next_req_event, std::max(mem_intr->nextReqTime, curTick()));
+    if (!requestEventScheduled(mem_intr->pseudoChannel))
+        restartScheduler(std::max(mem_intr->nextReqTime, curTick()),
+                         mem_intr->pseudoChannel);
 
     if (retry_wr_req && totalWriteQueueSize < writeBufferSize) {
         retry_wr_req = false;
@@ -1392,6 +1483,12 @@ MemCtrl::allIntfDrained() const
    return dram->allRanksDrained();
 }
 
+void
+MemCtrl::resumeIntfRefresh()
+{
+    dram->resumeRefresh();
+}
+
 DrainState
 MemCtrl::drain()
 {
@@ -156,6 +156,12 @@ class MemPacket
      */
     uint8_t _qosValue;
 
+    /**
+     * Position of the packet in the order of arrival of the queue it is
+     * in, set by MemPacketQueue
+     */
+    uint64_t queueSeqNum;
+
     /**
      * Set the packet QoS value
      * (interface compatibility with Packet)
@@ -210,14 +216,99 @@ class MemPacket
           _requestorId(pkt->requestorId()),
           read(is_read), dram(is_dram), pseudoChannel(_channel), rank(_rank),
           bank(_bank), row(_row), bankId(bank_id), addr(_addr), size(_size),
-          burstHelper(NULL), _qosValue(_pkt->qosValue())
+          burstHelper(NULL), _qosValue(_pkt->qosValue()), queueSeqNum(0)
     { }
 
 };
 
-// The memory packets are store in a multiple dequeue structure,
-// based on their QoS priority
-typedef std::deque<MemPacket*> MemPacketQueue;
+/**
+ * A queue of memory packets in arrival order. For the read and write
+ * queues, the DRAM packets are also bucketed per pseudo channel and bank,
+ * so that the scheduler can go through the banks with waiting packets
+ * instead of through the whole queue, and then get back to the packet in
+ * the queue from its arrival order.
+ */
+class MemPacketQueue
+{
+  private:
+    typedef std::deque<MemPacket*> Container;
+
+  public:
+    typedef Container::iterator iterator;
+    typedef Container::const_iterator const_iterator;
+
+    /** The DRAM packets waiting for a bank, in arrival order */
+    typedef std::deque<MemPacket*> BankPackets;
+
+    /**
+     * @param index_banks Bucket the DRAM packets per bank, only needed by
+     *                    the queues the scheduler picks packets from
+     */
+    explicit MemPacketQueue(bool index_banks = false)
+        : indexBanks(index_banks), nextSeqNum(0)
+    {}
+
+    iterator begin() { return queue.begin(); }
+    iterator end() { return queue.end(); }
+    const_iterator begin() const { return queue.begin(); }
+    const_iterator end() const { return queue.end(); }
+
+    size_t size() const { return queue.size(); }
+    bool empty() const { return queue.empty(); }
+    MemPacket* front() const { return queue.front(); }
+    MemPacket* back() const { return queue.back(); }
+
+    void push_back(MemPacket* mem_pkt);
+    iterator erase(iterator it);
+    void pop_front() { erase(queue.begin()); }
+
+    /**
+     * Find a packet in the queue using its arrival order.
+     *
+     * @param mem_pkt A packet in this queue
+     * @return an iterator to the packet
+     */
+    iterator find(const MemPacket* mem_pkt);
+
+    /**
+     * @param pseudo_channel Pseudo channel of the DRAM packets
+     * @return the ids of the banks with waiting DRAM packets
+     */
+    const std::vector<uint16_t>& busyBanks(uint8_t pseudo_channel) const;
+
+    /**
+     * @param pseudo_channel Pseudo channel of the DRAM packets
+     * @param bank_id Bank id, considering banks in all the ranks
+     * @return the DRAM packets waiting for the bank
+     */
+    const BankPackets& bankPackets(uint8_t pseudo_channel,
+                                   uint16_t bank_id) const;
+
+  private:
+    struct BankQueue
+    {
+        BankPackets pkts;
+
+        /** Position of this bank in the list of busy banks */
+        int busyIdx = -1;
+    };
+
+    struct ChannelQueues
+    {
+        std::vector<BankQueue> banks;
+        std::vector<uint16_t> busyBanks;
+    };
+
+    Container queue;
+
+    /** Whether the DRAM packets are bucketed per bank */
+    bool indexBanks;
+
+    /** DRAM packets per pseudo channel and bank */
+    std::vector<ChannelQueues> dramQueues;
+
+    uint64_t nextSeqNum;
+};
 
 
 /**
@@ -486,7 +577,7 @@ class MemCtrl : public qos::MemCtrl
      * as sizing the read queue, this and the main read queue need to
      * be added together.
      */
-    std::deque<MemPacket*> respQueue;
+    MemPacketQueue respQueue;
 
     /**
      * Holds count of commands issued in burst window starting at
@@ -683,6 +774,12 @@ class MemCtrl : public qos::MemCtrl
      */
     virtual bool allIntfDrained() const;
 
+    /**
+     * Let the interfaces resume refresh events they deferred while
+     * idle, called when a request is queued
+     */
+    virtual void resumeIntfRefresh();
+
     DrainState drain() override;
 
     /**
@@ -721,9 +818,14 @@ class MemCtrl : public qos::MemCtrl
     /**
      * Is there a respondEvent scheduled?
      *
+     * @param pseudo_channel pseudo channel whose response event to check,
+     * ignored by controllers with a single response queue
      * @return true if event is scheduled
      */
-    bool respondEventScheduled() const { return respondEvent.scheduled(); }
+    virtual bool respondEventScheduled(uint8_t pseudo_channel = 0) const
+    {
+        return respondEvent.scheduled();
+    }
 
     /**
      * Is there a read/write burst Event scheduled?
@@ -363,6 +363,13 @@ class MemInterface : public AbstractMemory
         "not be executed from here.\n");
     }
 
+    /**
+     * Bring ranks that stopped scheduling refresh events while idle back
+     * to normal operation. Called whenever the controller queues a
+     * request, only DRAM interfaces defer refreshes.
+     */
+    virtual void resumeRefresh() { }
+
     /**
      * This function is NVM specific.
      */
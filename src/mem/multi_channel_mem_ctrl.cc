@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/multi_channel_mem_ctrl.hh"
+
+#include <algorithm>
+
+#include "base/trace.hh"
+#include "debug/Drain.hh"
+#include "debug/MemCtrl.hh"
+#include "mem/dram_interface.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+MultiChannelMemCtrl::Channel::Channel(MultiChannelMemCtrl &ctrl,
+                                      DRAMInterface *_intr) :
+    intr(_intr),
+    respondEvent([this, &ctrl] {ctrl.processRespondEvent(intr, respQueue,
+                         respondEvent, ctrl.retryRdReq); },
+                 ctrl.name() + ".respondEvent"),
+    nextReqAt(MaxTick)
+{
+}
+
+MultiChannelMemCtrl::MultiChannelMemCtrl(
+        const MultiChannelMemCtrlParams &p) :
+    MemCtrl(p), inBatch(false), mcStats(*this)
+{
+    DPRINTF(MemCtrl, "Setting up multi-channel controller\n");
+
+    fatal_if(!dynamic_cast<DRAMInterface*>(dram),
+             "Memory controller must have a DRAM interface for channel 0");
+    fatal_if(p.extra_channels.size() + 1 > 256,
+             "Memory controller supports at most 256 channels");
+
+    channels.emplace_back(new Channel(*this,
+                                      static_cast<DRAMInterface*>(dram)));
+    for (auto intr : p.extra_channels) {
+        channels.emplace_back(new Channel(*this, intr));
+    }
+
+    readBufferSize = 0;
+    writeBufferSize = 0;
+    for (unsigned i = 0; i < channels.size(); i++) {
+        DRAMInterface *intr = channels[i]->intr;
+        fatal_if(intr->bytesPerBurst() != dram->bytesPerBurst(),
+                 "All channels must have the same burst size\n");
+        intr->setCtrl(this, commandWindow, i);
+        readBufferSize += intr->readBufferSize;
+        writeBufferSize += intr->writeBufferSize;
+    }
+
+    writeHighThreshold = (writeBufferSize * p.write_high_thresh_perc
+                          / 100.0);
+    writeLowThreshold = (writeBufferSize * p.write_low_thresh_perc
+                         / 100.0);
+}
+
+void
+MultiChannelMemCtrl::startup()
+{
+    MemCtrl::startup();
+
+    if (isTimingMode) {
+        // same bubble as for channel 0, see MemCtrl::startup
+        for (auto &chan : channels) {
+            chan->intr->nextBurstAt = curTick() + chan->intr->commandOffset();
+        }
+    }
+}
+
+uint8_t
+MultiChannelMemCtrl::channelOf(Addr addr) const
+{
+    for (unsigned i = 0; i < channels.size(); i++) {
+        if (channels[i]->intr->getAddrRange().contains(addr))
+            return i;
+    }
+    panic("Can't handle address %#x in any channel\n", addr);
+}
+
+AddrRangeList
+MultiChannelMemCtrl::getAddrRanges()
+{
+    AddrRangeList ranges;
+    for (auto &chan : channels) {
+        ranges.push_back(chan->intr->getAddrRange());
+    }
+    return ranges;
+}
+
+Tick
+MultiChannelMemCtrl::recvAtomic(PacketPtr pkt)
+{
+    return recvAtomicLogic(pkt, channels[channelOf(pkt->getAddr())]->intr);
+}
+
+Tick
+MultiChannelMemCtrl::recvAtomicBackdoor(PacketPtr pkt,
+                                        MemBackdoorPtr &backdoor)
+{
+    DRAMInterface *intr = channels[channelOf(pkt->getAddr())]->intr;
+    Tick latency = recvAtomicLogic(pkt, intr);
+    intr->getBackdoor(backdoor);
+    return latency;
+}
+
+void
+MultiChannelMemCtrl::recvFunctional(PacketPtr pkt)
+{
+    for (auto &chan : channels) {
+        if (recvFunctionalLogic(pkt, chan->intr))
+            return;
+    }
+    panic("Can't handle address range for packet %s\n", pkt->print());
+}
+
+bool
+MultiChannelMemCtrl::readQueueFull(unsigned int neededEntries) const
+{
+    unsigned int rdsize_new = totalReadQueueSize + neededEntries;
+    for (auto &chan : channels) {
+        rdsize_new += chan->respQueue.size();
+    }
+
+    DPRINTF(MemCtrl,
+            "Read queue limit %d, current size %d, entries needed %d\n",
+            readBufferSize, rdsize_new - neededEntries, neededEntries);
+
+    return rdsize_new > readBufferSize;
+}
+
+bool
+MultiChannelMemCtrl::recvTimingReq(PacketPtr pkt)
+{
+    // This is where we enter from the outside world
+    DPRINTF(MemCtrl, "recvTimingReq: request %s addr %#x size %d\n",
+            pkt->cmdString(), pkt->getAddr(), pkt->getSize());
+
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    panic_if(!(pkt->isRead() || pkt->isWrite()),
+             "Should only see read and writes at memory controller\n");
+
+    // Calc avg gap between requests
+    if (prevArrival != 0) {
+        stats.totGap += curTick() - prevArrival;
+    }
+    prevArrival = curTick();
+
+    uint8_t chan = channelOf(pkt->getAddr());
+    DRAMInterface *intr = channels[chan]->intr;
+
+    // Find out how many memory packets a pkt translates to, all channels
+    // have the same burst size
+    unsigned size = pkt->getSize();
+    uint32_t burst_size = intr->bytesPerBurst();
+    unsigned offset = pkt->getAddr() & (burst_size - 1);
+    unsigned int pkt_count = divCeil(offset + size, burst_size);
+
+    // run the QoS scheduler and assign a QoS priority value to the packet
+    qosSchedule({&readQueue, &writeQueue}, burst_size, pkt);
+
+    // check local buffers and do not accept if full
+    if (pkt->isWrite()) {
+        assert(size != 0);
+        if (writeQueueFull(pkt_count)) {
+            DPRINTF(MemCtrl, "Write queue full, not accepting\n");
+            // remember that we have to retry this port
+            retryWrReq = true;
+            stats.numWrRetry++;
+            return false;
+        }
+
+        addToWriteQueue(pkt, pkt_count, intr);
+        // If the channel is not already scheduled to get a request out
+        // of the queue, do so now
+        if (!requestEventScheduled(chan)) {
+            DPRINTF(MemCtrl, "Request scheduled immediately\n");
+            restartScheduler(curTick(), chan);
+        }
+        stats.writeReqs++;
+        stats.bytesWrittenSys += size;
+    } else {
+        assert(pkt->isRead());
+        assert(size != 0);
+        if (readQueueFull(pkt_count)) {
+            DPRINTF(MemCtrl, "Read queue full, not accepting\n");
+            // remember that we have to retry this port
+            retryRdReq = true;
+            stats.numRdRetry++;
+            return false;
+        }
+
+        if (!addToReadQueue(pkt, pkt_count, intr)) {
+            if (!requestEventScheduled(chan)) {
+                DPRINTF(MemCtrl, "Request scheduled immediately\n");
+                restartScheduler(curTick(), chan);
+            }
+        }
+        stats.readReqs++;
+        stats.bytesReadSys += size;
+    }
+
+    return true;
+}
+
+void
+MultiChannelMemCtrl::processNextReqEvent(MemInterface* mem_intr,
+                          MemPacketQueue& resp_queue,
+                          EventFunctionWrapper& resp_event,
+                          EventFunctionWrapper& next_req_event,
+                          bool& retry_wr_req)
+{
+    // The shared event is always scheduled through channel 0's
+    // arguments, service every channel that is due instead
+    mcStats.reqEvents++;
+
+    BusState bus_state_next = busStateNext;
+
+    inBatch = true;
+    for (auto &chan : channels) {
+        if (chan->nextReqAt > curTick())
+            continue;
+
+        mcStats.channelsScheduled++;
+        chan->nextReqAt = MaxTick;
+
+        // the channel has its own command bus
+        std::swap(burstTicks, chan->burstTicks);
+        MemCtrl::processNextReqEvent(chan->intr, chan->respQueue,
+                                     chan->respondEvent, nextReqEvent,
+                                     retryWrReq);
+        std::swap(burstTicks, chan->burstTicks);
+    }
+    inBatch = false;
+
+    // a channel that went idle because it had nothing to issue in the
+    // old bus direction may have work in the new one
+    if (busStateNext != bus_state_next) {
+        for (auto &chan : channels) {
+            if (chan->nextReqAt == MaxTick)
+                chan->nextReqAt = curTick();
+        }
+    }
+
+    scheduleNextReq();
+}
+
+void
+MultiChannelMemCtrl::scheduleNextReq()
+{
+    Tick when = MaxTick;
+    for (auto &chan : channels) {
+        when = std::min(when, chan->nextReqAt);
+    }
+
+    if (when == MaxTick)
+        return;
+
+    if (!nextReqEvent.scheduled()) {
+        schedule(nextReqEvent, when);
+    } else if (nextReqEvent.when() > when) {
+        reschedule(nextReqEvent, when);
+    }
+}
+
+bool
+MultiChannelMemCtrl::requestEventScheduled(uint8_t pseudo_channel) const
+{
+    assert(pseudo_channel < channels.size());
+    return channels[pseudo_channel]->nextReqAt != MaxTick;
+}
+
+void
+MultiChannelMemCtrl::restartScheduler(Tick tick, uint8_t pseudo_channel)
+{
+    assert(pseudo_channel < channels.size());
+    Channel &chan = *channels[pseudo_channel];
+    chan.nextReqAt = std::min(chan.nextReqAt, tick);
+
+    // when restarted from within the shared event, the event is
+    // scheduled once all due channels have been serviced
+    if (!inBatch)
+        scheduleNextReq();
+}
+
+bool
+MultiChannelMemCtrl::respondEventScheduled(uint8_t pseudo_channel) const
+{
+    assert(pseudo_channel < channels.size());
+    return channels[pseudo_channel]->respondEvent.scheduled();
+}
+
+bool
+MultiChannelMemCtrl::respQEmpty()
+{
+    for (auto &chan : channels) {
+        if (!chan->respQueue.empty())
+            return false;
+    }
+    return true;
+}
+
+bool
+MultiChannelMemCtrl::allIntfDrained() const
+{
+    for (auto &chan : channels) {
+        if (!chan->intr->allRanksDrained())
+            return false;
+    }
+    return true;
+}
+
+void
+MultiChannelMemCtrl::resumeIntfRefresh()
+{
+    for (auto &chan : channels) {
+        chan->intr->resumeRefresh();
+    }
+}
+
+DrainState
+MultiChannelMemCtrl::drain()
+{
+    // if there is anything in any of our internal queues, keep track
+    // of that as well
+    if (!(!totalWriteQueueSize && !totalReadQueueSize && respQEmpty() &&
+          allIntfDrained())) {
+
+        DPRINTF(Drain, "Memory controller not drained, write: %d, "
+                "read: %d\n", totalWriteQueueSize, totalReadQueueSize);
+
+        // the only queue that is not drained automatically over time
+        // is the write queue, thus kick things into action if needed
+        if (!totalWriteQueueSize && !requestEventScheduled(0)) {
+            restartScheduler(curTick(), 0);
+        }
+
+        for (auto &chan : channels) {
+            chan->intr->drainRanks();
+        }
+
+        return DrainState::Draining;
+    } else {
+        return DrainState::Drained;
+    }
+}
+
+void
+MultiChannelMemCtrl::drainResume()
+{
+    bool was_timing = isTimingMode;
+
+    // handles channel 0 and calls our startup if we switched to timing
+    MemCtrl::drainResume();
+
+    if (!was_timing && system()->isTimingMode()) {
+        for (auto &chan : channels) {
+            if (chan->intr != dram)
+                chan->intr->startup();
+        }
+    } else if (was_timing && !system()->isTimingMode()) {
+        // stop the refresh events to not cause issues with KVM
+        for (auto &chan : channels) {
+            if (chan->intr != dram)
+                chan->intr->suspend();
+        }
+    }
+}
+
+MultiChannelMemCtrl::MultiChannelStats::MultiChannelStats(
+        MultiChannelMemCtrl &ctrl)
+    : statistics::Group(&ctrl, "multiChannel"),
+
+    ADD_STAT(reqEvents, statistics::units::Count::get(),
+             "Number of times the shared request event was processed"),
+    ADD_STAT(channelsScheduled, statistics::units::Count::get(),
+             "Number of channels scheduled by the shared request event"),
+    ADD_STAT(avgChannelsPerEvent, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Count>::get(),
+             "Average number of channels scheduled per request event")
+{
+    avgChannelsPerEvent.precision(2);
+    avgChannelsPerEvent = channelsScheduled / reqEvents;
+}
+
+} // namespace memory
+} // namespace gem5
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * MultiChannelMemCtrl declaration
+ */
+
+#ifndef __MULTI_CHANNEL_MEM_CTRL_HH__
+#define __MULTI_CHANNEL_MEM_CTRL_HH__
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/mem_ctrl.hh"
+#include "params/MultiChannelMemCtrl.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+class DRAMInterface;
+
+/**
+ * A memory controller for several independent DRAM channels behind a
+ * single port, e.g. the 8-16 channels of an HBM stack. Instead of one
+ * MemCtrl, with its own request event, per channel behind an address
+ * interleaving crossbar, all channels share a single request event that
+ * wakes up at the earliest tick any channel needs to be scheduled, and
+ * services every channel that is due in one pass.
+ *
+ * Like HBMCtrl, the channels share the read/write queues (packets are
+ * tagged with their channel as pseudo channel), the bus turnaround state
+ * and the drain bookkeeping of the controller. Each channel keeps its own
+ * response queue and command bus. The refresh and power states are those
+ * of the ranks of each channel, with their own events, as they follow the
+ * commands issued to the ranks.
+ */
+class MultiChannelMemCtrl : public MemCtrl
+{
+  private:
+
+    /**
+     * Per-channel state that cannot be shared between channels.
+     */
+    struct Channel
+    {
+        Channel(MultiChannelMemCtrl &ctrl, DRAMInterface *_intr);
+
+        DRAMInterface *intr;
+
+        /** Reads that have been issued and wait for their readyTime */
+        MemPacketQueue respQueue;
+        EventFunctionWrapper respondEvent;
+
+        /**
+         * Tick at which the channel wants to be scheduled next, MaxTick
+         * when it has nothing to do and waits to be restarted.
+         */
+        Tick nextReqAt;
+
+        /**
+         * Commands issued in each burst window on this channel's command
+         * bus, swapped into MemCtrl::burstTicks while the channel is
+         * being scheduled.
+         */
+        std::unordered_multiset<Tick> burstTicks;
+    };
+
+    std::vector<std::unique_ptr<Channel>> channels;
+
+    /**
+     * Set while the shared request event services the channels, so that
+     * restarting a channel only records its tick instead of scheduling.
+     */
+    bool inBatch;
+
+    /**
+     * Schedule the shared request event at the earliest tick any channel
+     * has recorded, moving it forward if it is already scheduled later.
+     */
+    void scheduleNextReq();
+
+    /**
+     * Find the channel an address maps to.
+     *
+     * @param addr Address to look up
+     * @return Index of the channel
+     */
+    uint8_t channelOf(Addr addr) const;
+
+    /**
+     * Check if the read queue, including the reads waiting in the
+     * response queues of all channels, has room for more entries.
+     *
+     * @param pkt_count The number of entries needed in the read queue
+     * @return true if read queue is full, false otherwise
+     */
+    bool readQueueFull(unsigned int pkt_count) const;
+
+    struct MultiChannelStats : public statistics::Group
+    {
+        MultiChannelStats(MultiChannelMemCtrl &ctrl);
+
+        statistics::Scalar reqEvents;
+        statistics::Scalar channelsScheduled;
+        statistics::Formula avgChannelsPerEvent;
+    };
+
+    MultiChannelStats mcStats;
+
+  protected:
+
+    void processNextReqEvent(MemInterface* mem_intr,
+                          MemPacketQueue& resp_queue,
+                          EventFunctionWrapper& resp_event,
+                          EventFunctionWrapper& next_req_event,
+                          bool& retry_wr_req) override;
+
+    bool respQEmpty() override;
+
+    AddrRangeList getAddrRanges() override;
+
+    Tick recvAtomic(PacketPtr pkt) override;
+    Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor) override;
+    void recvFunctional(PacketPtr pkt) override;
+    bool recvTimingReq(PacketPtr pkt) override;
+
+  public:
+    MultiChannelMemCtrl(const MultiChannelMemCtrlParams &p);
+
+    bool allIntfDrained() const override;
+    void resumeIntfRefresh() override;
+    DrainState drain() override;
+
+    bool respondEventScheduled(uint8_t pseudo_channel = 0) const override;
+    bool requestEventScheduled(uint8_t pseudo_channel = 0) const override;
+
+    /**
+     * Record that a channel wants to be scheduled at the given tick. The
+     * shared request event is moved forward when needed.
+     *
+     * @param tick Tick to schedule the channel at
+     * @param pseudo_channel Channel number
+     */
+    void restartScheduler(Tick tick, uint8_t pseudo_channel = 0) override;
+
+    void startup() override;
+    void drainResume() override;
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif //__MULTI_CHANNEL_MEM_CTRL_HH__
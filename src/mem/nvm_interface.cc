@@ -58,6 +58,10 @@ NVMInterface::NVMInterface(const NVMInterfaceParams &_p)
       maxPendingReads(_p.max_pending_reads),
       twoCycleRdWr(_p.two_cycle_rdwr),
       tREAD(_p.tREAD), tWRITE(_p.tWRITE), tSEND(_p.tSEND),
+      xpBufferEntries(_p.xpbuffer_entries),
+      xpLineSize(_p.xpbuffer_line_size),
+      xpLineMask(mask(xpLineSize / burstSize)),
+      xpWearLines(_p.xpbuffer_wear_lines),
       stats(*this),
       writeRespondEvent([this]{ processWriteRespondEvent(); }, name()),
       readReadyEvent([this]{ processReadReadyEvent(); }, name()),
@@ -69,6 +73,12 @@ NVMInterface::NVMInterface(const NVMInterfaceParams &_p)
     fatal_if(!isPowerOf2(burstSize), "NVM burst size %d is not allowed, "
              "must be a power of two\n", burstSize);
 
+    fatal_if(!isPowerOf2(xpLineSize) || (xpBufferEntries &&
+             (xpLineSize < burstSize || xpLineSize / burstSize > 64)),
+             "NVM write-combining line size %d must be a power of two, "
+             "and between one and 64 bursts of %d bytes\n",
+             xpLineSize, burstSize);
+
     // sanity check the ranks since we rely on bit slicing for the
     // address decoding
     fatal_if(!isPowerOf2(ranksPerChannel), "NVM rank count of %d is "
@@ -118,18 +128,13 @@ void NVMInterface::setupRank(const uint8_t rank, const bool is_read)
     }
 }
 
-MemPacket*
-NVMInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
-                       unsigned size, bool is_read, uint8_t pseudo_channel)
+void
+NVMInterface::decodeAddr(Addr pkt_addr, uint8_t &rank, uint8_t &bank,
+                         uint64_t &row) const
 {
     // decode the address based on the address mapping scheme, with
     // Ro, Ra, Co, Ba and Ch denoting row, rank, column, bank and
     // channel, respectively
-    uint8_t rank;
-    uint8_t bank;
-    // use a 64-bit unsigned during the computations as the row is
-    // always the top bits, and check before creating the packet
-    uint64_t row;
 
     // Get packed address, starting at 0
     Addr addr = getCtrlAddr(pkt_addr);
@@ -186,6 +191,18 @@ NVMInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
         row = addr % rowsPerBank;
     } else
         panic("Unknown address mapping policy chosen!");
+}
+
+MemPacket*
+NVMInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
+                       unsigned size, bool is_read, uint8_t pseudo_channel)
+{
+    uint8_t rank;
+    uint8_t bank;
+    // use a 64-bit unsigned during the computations as the row is
+    // always the top bits, and check before creating the packet
+    uint64_t row;
+    decodeAddr(pkt_addr, rank, bank, row);
 
     assert(rank < ranksPerChannel);
     assert(bank < banksPerRank);
@@ -306,31 +323,40 @@ NVMInterface::chooseRead(MemPacketQueue& queue)
             // Ensures single read command issued per cycle
             nextReadAt = cmd_at + tCK;
 
-            // If accessing a new location in this bank, update timing
-            // and stats
-            if (bank_ref.openRow != pkt->row) {
-                // update the open bank, re-using row field
-                bank_ref.openRow = pkt->row;
-
-                // sample the bytes accessed to a buffer in this bank
-                // here when we are re-buffering the data
-                stats.bytesPerBank.sample(bank_ref.bytesAccessed);
-                // start counting anew
-                bank_ref.bytesAccessed = 0;
-
-                // holdoff next command to this bank until the read completes
-                // and the data has been successfully buffered
-                // can pipeline accesses to the same bank, sending them
-                // across the interface B2B, but will incur full access
-                // delay between data ready responses to different buffers
-                // in a bank
-                bank_ref.actAllowedAt = std::max(cmd_at,
-                                        bank_ref.actAllowedAt) + tREAD;
+            if (xpBufferEntries && bufferHit(pkt)) {
+                // the data is in the write-combining buffer, no need to
+                // go to the media
+                DPRINTF(NVM, "NVM read to %#x hits in write buffer\n",
+                        pkt->addr);
+                stats.bufferReadHits++;
+                pkt->readyTime = cmd_at;
+            } else {
+                // If accessing a new location in this bank, update timing
+                // and stats
+                if (bank_ref.openRow != pkt->row) {
+                    // update the open bank, re-using row field
+                    bank_ref.openRow = pkt->row;
+
+                    // sample the bytes accessed to a buffer in this bank
+                    // here when we are re-buffering the data
+                    stats.bytesPerBank.sample(bank_ref.bytesAccessed);
+                    // start counting anew
+                    bank_ref.bytesAccessed = 0;
+
+                    // holdoff next command to this bank until the read
+                    // completes and the data has been successfully buffered
+                    // can pipeline accesses to the same bank, sending them
+                    // across the interface B2B, but will incur full access
+                    // delay between data ready responses to different
+                    // buffers in a bank
+                    bank_ref.actAllowedAt = std::max(cmd_at,
+                                            bank_ref.actAllowedAt) + tREAD;
+                }
+                // update per packet readyTime to holdoff burst read operation
+                // overloading readyTime, which will be updated again when the
+                // burst is issued
+                pkt->readyTime = std::max(cmd_at, bank_ref.actAllowedAt);
             }
-            // update per packet readyTime to holdoff burst read operation
-            // overloading readyTime, which will be updated again when the
-            // burst is issued
-            pkt->readyTime = std::max(cmd_at, bank_ref.actAllowedAt);
 
             DPRINTF(NVM, "Issuing NVM Read to bank %d at tick %d. "
                          "Data ready at %d\n",
@@ -500,39 +526,19 @@ NVMInterface::doBurstAccess(MemPacket* pkt, Tick next_burst_at,
            bank_ref.bytesAccessed = 0;
         }
 
-        // Determine when write will actually complete, assuming it is
-        // scheduled to push to NVM immediately
-        // update actAllowedAt to serialize next command completion that
-        // accesses this bank; must wait until this write completes
-        // Data accesses to the same buffer in this bank
-        // can issue immediately after actAllowedAt expires, without
-        // waiting additional delay of tWRITE. Can revisit this
-        // assumption/simplification in the future.
-        bank_ref.actAllowedAt = std::max(pkt->readyTime,
-                                bank_ref.actAllowedAt) + tWRITE;
-
-        // Need to track number of outstanding writes to
-        // ensure 'buffer' on media controller does not overflow
-        assert(!writeRespQueueFull());
-
-        // Insert into write done queue. It will be handled after
-        // the media delay has been met
-        if (writeRespQueueEmpty()) {
-            assert(!writeRespondEvent.scheduled());
-            schedule(writeRespondEvent, bank_ref.actAllowedAt);
+        if (xpBufferEntries) {
+            // the write goes to the write-combining buffer, the media is
+            // only written when a line is evicted, or when draining
+            bufferWrite(pkt);
+            if (ctrl->drainState() == DrainState::Draining)
+                flushBuffer();
         } else {
-            assert(writeRespondEvent.scheduled());
-        }
-        writeRespQueue.push_back(bank_ref.actAllowedAt);
-        writeRespQueue.sort();
-        if (writeRespondEvent.when() > bank_ref.actAllowedAt) {
-            DPRINTF(NVM, "Rescheduled respond event from %lld to %11d\n",
-                writeRespondEvent.when(), bank_ref.actAllowedAt);
-            DPRINTF(NVM, "Front of response queue is %11d\n",
-                writeRespQueue.front());
-            reschedule(writeRespondEvent, bank_ref.actAllowedAt);
+            // the write goes straight to the media, the timing does not
+            // account for a read-modify-write of partial lines, and
+            // neither the media writes nor the wear are tracked
+            mediaWrite(pkt->addr & ~Addr(xpLineSize - 1), bank_ref,
+                       pkt->readyTime, false);
         }
-
     }
 
     // Update the stats
@@ -555,6 +561,140 @@ NVMInterface::doBurstAccess(MemPacket* pkt, Tick next_burst_at,
     return std::make_pair(cmd_at, cmd_at + tBURST);
 }
 
+void
+NVMInterface::mediaWrite(Addr line_addr, Bank& bank_ref, Tick write_at,
+                         bool rmw)
+{
+    // Determine when write will actually complete, assuming it is
+    // scheduled to push to NVM immediately
+    // update actAllowedAt to serialize next command completion that
+    // accesses this bank; must wait until this write completes
+    // Data accesses to the same buffer in this bank
+    // can issue immediately after actAllowedAt expires, without
+    // waiting additional delay of tWRITE. Can revisit this
+    // assumption/simplification in the future.
+    // A partially written line has to be read from the media first
+    bank_ref.actAllowedAt = std::max(write_at, bank_ref.actAllowedAt) +
+                            (rmw ? tREAD : 0) + tWRITE;
+
+    // Need to track number of outstanding writes to
+    // ensure 'buffer' on media controller does not overflow
+    assert(!writeRespQueueFull());
+
+    // Insert into write done queue. It will be handled after
+    // the media delay has been met
+    if (writeRespQueueEmpty()) {
+        assert(!writeRespondEvent.scheduled());
+        schedule(writeRespondEvent, bank_ref.actAllowedAt);
+    } else {
+        assert(writeRespondEvent.scheduled());
+    }
+    writeRespQueue.push_back(bank_ref.actAllowedAt);
+    writeRespQueue.sort();
+    if (writeRespondEvent.when() > bank_ref.actAllowedAt) {
+        DPRINTF(NVM, "Rescheduled respond event from %lld to %11d\n",
+            writeRespondEvent.when(), bank_ref.actAllowedAt);
+        DPRINTF(NVM, "Front of response queue is %11d\n",
+            writeRespQueue.front());
+        reschedule(writeRespondEvent, bank_ref.actAllowedAt);
+    }
+
+    // the media writes are only counted with the write-combining buffer,
+    // without it every burst is written as is
+    if (!xpBufferEntries)
+        return;
+
+    stats.mediaWrites++;
+    if (rmw)
+        stats.rmwWrites++;
+
+    // keep track of how often each line is written to model wear, as
+    // long as there is room to track a newly written line
+    auto it = lineMediaWrites.find(line_addr);
+    if (it == lineMediaWrites.end()) {
+        if (lineMediaWrites.size() == xpWearLines) {
+            stats.untrackedWrites++;
+            return;
+        }
+        it = lineMediaWrites.emplace(line_addr, 0).first;
+        stats.linesWritten++;
+    }
+    if (++it->second > stats.maxLineWrites.value())
+        stats.maxLineWrites = it->second;
+}
+
+void
+NVMInterface::bufferWrite(const MemPacket* pkt)
+{
+    Addr line_addr = pkt->addr & ~Addr(xpLineSize - 1);
+    uint64_t burst_bit = 1ULL << ((pkt->addr & (xpLineSize - 1)) /
+                                  burstSize);
+
+    auto it = xpLineMap.find(line_addr);
+    if (it != xpLineMap.end()) {
+        // coalesce with the buffered line, and make it the most
+        // recently written one
+        DPRINTF(NVM, "NVM write to %#x merged in write buffer\n",
+                pkt->addr);
+        it->second->writtenBursts |= burst_bit;
+        xpLines.splice(xpLines.begin(), xpLines, it->second);
+        stats.bufferWriteHits++;
+        return;
+    }
+
+    if (xpLines.size() == xpBufferEntries) {
+        // write back the least recently written line, to the bank its
+        // own address maps to
+        const XPLine &victim = xpLines.back();
+        uint8_t rank;
+        uint8_t bank;
+        uint64_t row;
+        decodeAddr(victim.addr, rank, bank, row);
+        DPRINTF(NVM, "NVM write buffer evicting line %#x to rank %d "
+                "bank %d\n", victim.addr, rank, bank);
+        stats.bufferEvictions++;
+        mediaWrite(victim.addr, ranks[rank]->banks[bank],
+                   pkt->readyTime, victim.writtenBursts != xpLineMask);
+        xpLineMap.erase(victim.addr);
+        xpLines.pop_back();
+    }
+
+    xpLines.push_front(XPLine{line_addr, burst_bit});
+    xpLineMap[line_addr] = xpLines.begin();
+}
+
+void
+NVMInterface::flushBuffer()
+{
+    // write back the least recently written lines first, as long as the
+    // media controller has room for the writes
+    while (!xpLines.empty() && !writeRespQueueFull()) {
+        const XPLine &victim = xpLines.back();
+        uint8_t rank;
+        uint8_t bank;
+        uint64_t row;
+        decodeAddr(victim.addr, rank, bank, row);
+        DPRINTF(NVM, "NVM write buffer flushing line %#x to rank %d "
+                "bank %d\n", victim.addr, rank, bank);
+        mediaWrite(victim.addr, ranks[rank]->banks[bank], curTick(),
+                   victim.writtenBursts != xpLineMask);
+        xpLineMap.erase(victim.addr);
+        xpLines.pop_back();
+    }
+}
+
+bool
+NVMInterface::bufferHit(const MemPacket* pkt) const
+{
+    auto it = xpLineMap.find(pkt->addr & ~Addr(xpLineSize - 1));
+    if (it == xpLineMap.end())
+        return false;
+
+    uint64_t burst_bit = 1ULL << ((pkt->addr & (xpLineSize - 1)) /
+                                  burstSize);
+    return it->second->writtenBursts & burst_bit;
+}
+
 void
 NVMInterface::processWriteRespondEvent()
 {
@@ -574,6 +714,10 @@ NVMInterface::processWriteRespondEvent()
         schedule(writeRespondEvent, writeRespQueue.front());
     }
 
+    // keep writing back the buffered lines while the controller drains
+    if (ctrl->drainState() == DrainState::Draining)
+        flushBuffer();
+
     // It is possible that a new command kicks things back into
     // action before reaching this point but need to ensure that we
     // continue to process new commands as writes complete at the media and
@@ -671,7 +815,36 @@ NVMInterface::NVMStats::NVMStats(NVMInterface &_nvm)
     ADD_STAT(pendingWrites, statistics::units::Count::get(),
              "Number of outstanding writes to NVM"),
     ADD_STAT(bytesPerBank, statistics::units::Byte::get(),
-             "Bytes read within a bank before loading new bank")
+             "Bytes read within a bank before loading new bank"),
+
+    ADD_STAT(bufferWriteHits, statistics::units::Count::get(),
+             "Number of NVM write bursts merged in the write buffer"),
+    ADD_STAT(bufferReadHits, statistics::units::Count::get(),
+             "Number of NVM read bursts served by the write buffer"),
+    ADD_STAT(bufferEvictions, statistics::units::Count::get(),
+             "Number of lines evicted from the write buffer"),
+    ADD_STAT(mediaWrites, statistics::units::Count::get(),
+             "Number of writes to the NVM media"),
+    ADD_STAT(rmwWrites, statistics::units::Count::get(),
+             "Number of media writes of partially written lines, which "
+             "need a read-modify-write"),
+    ADD_STAT(bufferedLines, statistics::units::Count::get(),
+             "Number of written lines still in the write buffer, each "
+             "one a media write yet to happen"),
+    ADD_STAT(writeCoalescing, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Count>::get(),
+             "Average number of write bursts per media write"),
+
+    ADD_STAT(linesWritten, statistics::units::Count::get(),
+             "Number of distinct lines written to the NVM media"),
+    ADD_STAT(untrackedWrites, statistics::units::Count::get(),
+             "Number of media writes to lines not tracked for wear, as "
+             "the limit of tracked lines was reached"),
+    ADD_STAT(maxLineWrites, statistics::units::Count::get(),
+             "Number of media writes to the most written line"),
+    ADD_STAT(avgLineWrites, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Count>::get(),
+             "Average number of media writes per written line")
 
 {
 }
@@ -723,6 +896,46 @@ NVMInterface::NVMStats::regStats()
     busUtil = (avgRdBW + avgWrBW) / peakBW * 100;
     busUtilRead = avgRdBW / peakBW * 100;
     busUtilWrite = avgWrBW / peakBW * 100;
+
+    writeCoalescing.precision(2);
+    avgLineWrites.precision(2);
+
+    // without the write-combining buffer, none of its stats is kept
+    if (!nvm.xpBufferEntries) {
+        bufferWriteHits.flags(nozero);
+        bufferReadHits.flags(nozero);
+        bufferEvictions.flags(nozero);
+        mediaWrites.flags(nozero);
+        rmwWrites.flags(nozero);
+        bufferedLines.flags(nozero);
+        writeCoalescing.flags(nozero | nonan);
+        linesWritten.flags(nozero);
+        untrackedWrites.flags(nozero);
+        maxLineWrites.flags(nozero);
+        avgLineWrites.flags(nozero | nonan);
+    }
+
+    // lines still in the buffer will eventually be written back, so
+    // they count as media writes for the coalescing
+    writeCoalescing = writeBursts / (mediaWrites + bufferedLines);
+    avgLineWrites = (mediaWrites - untrackedWrites) / linesWritten;
+}
+
+void
+NVMInterface::NVMStats::resetStats()
+{
+    statistics::Group::resetStats();
+
+    // wear is tracked over the same window as the other stats
+    nvm.lineMediaWrites.clear();
+}
+
+void
+NVMInterface::NVMStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    bufferedLines = nvm.xpLines.size();
 }
 
 } // namespace memory
@@ -46,6 +46,9 @@
 #ifndef __NVM_INTERFACE_HH__
 #define __NVM_INTERFACE_HH__
 
+#include <list>
+#include <unordered_map>
+
 #include "mem/mem_interface.hh"
 #include "params/NVMInterface.hh"
 
@@ -100,11 +103,105 @@ class NVMInterface : public MemInterface
     const Tick tWRITE;
     const Tick tSEND;
 
+    /**
+     * A line of the on-DIMM write-combining buffer. Writes to the NVM
+     * are merged here at the media access granularity, and only written
+     * to the media when the line is evicted.
+     */
+    struct XPLine
+    {
+        /** Line aligned address */
+        Addr addr;
+
+        /** One bit per burst of the line that has been written */
+        uint64_t writtenBursts;
+    };
+
+    /**
+     * Number of lines in the write-combining buffer, the buffer is
+     * disabled when zero
+     */
+    const uint32_t xpBufferEntries;
+
+    /**
+     * Media access granularity, in bytes, used for the write-combining
+     * buffer and the wear statistics
+     */
+    const uint32_t xpLineSize;
+
+    /** Bit mask with one bit set per burst of a line */
+    const uint64_t xpLineMask;
+
+    /** Buffered lines, most recently written first */
+    std::list<XPLine> xpLines;
+    std::unordered_map<Addr, std::list<XPLine>::iterator> xpLineMap;
+
+    /**
+     * Maximum number of lines whose media writes are tracked for the
+     * wear stats
+     */
+    const uint32_t xpWearLines;
+
+    /**
+     * Number of media writes per line, to model wear. Only maintained
+     * when the write-combining buffer is enabled, and holds at most
+     * xpWearLines lines.
+     */
+    std::unordered_map<Addr, uint64_t> lineMediaWrites;
+
+    /**
+     * Decode an address to the rank, bank and row it maps to, based on
+     * the address mapping scheme
+     *
+     * @param pkt_addr Address to decode
+     * @param rank Rank of the address
+     * @param bank Bank of the address within the rank
+     * @param row Row of the address within the bank
+     */
+    void decodeAddr(Addr pkt_addr, uint8_t &rank, uint8_t &bank,
+                    uint64_t &row) const;
+
+    /**
+     * Merge a write burst into the write-combining buffer, evicting the
+     * least recently written line if needed.
+     *
+     * @param pkt The write burst
+     */
+    void bufferWrite(const MemPacket* pkt);
+
+    /**
+     * Write back the buffered lines to the media, for as long as there
+     * is room in the queue of pending writes.
+     */
+    void flushBuffer();
+
+    /**
+     * Check if a read burst can be served by the write-combining buffer
+     *
+     * @param pkt The read burst
+     * @return true if all its data was written to a buffered line
+     */
+    bool bufferHit(const MemPacket* pkt) const;
+
+    /**
+     * Write a line to the media, updating the bank timing, the pending
+     * write queue and the wear statistics.
+     *
+     * @param line_addr Line aligned address
+     * @param bank_ref Bank the line is written to
+     * @param write_at Tick from which the write can start
+     * @param rmw Only part of the line was written and the rest has to
+     *            be read from the media first
+     */
+    void mediaWrite(Addr line_addr, Bank& bank_ref, Tick write_at, bool rmw);
+
     struct NVMStats : public statistics::Group
     {
         NVMStats(NVMInterface &nvm);
 
         void regStats() override;
+        void resetStats() override;
+        void preDumpStats() override;
 
         NVMInterface &nvm;
 
@@ -140,6 +237,21 @@ class NVMInterface : public MemInterface
         statistics::Histogram pendingReads;
         statistics::Histogram pendingWrites;
         statistics::Histogram bytesPerBank;
+
+        /** Write-combining buffer and media write stats */
+        statistics::Scalar bufferWriteHits;
+        statistics::Scalar bufferReadHits;
+        statistics::Scalar bufferEvictions;
+        statistics::Scalar mediaWrites;
+        statistics::Scalar rmwWrites;
+        statistics::Scalar bufferedLines;
+        statistics::Formula writeCoalescing;
+
+        /** Wear stats */
+        statistics::Scalar linesWritten;
+        statistics::Scalar untrackedWrites;
+        statistics::Scalar maxLineWrites;
+        statistics::Formula avgLineWrites;
     };
     NVMStats stats;
 
@@ -207,10 +319,14 @@ class NVMInterface : public MemInterface
     /**
      * Check drain state of NVM interface
      *
-     * @return true if write response queue is empty
+     * @return true if write response queue and write buffer are empty
      *
      */
-    bool allRanksDrained() const override { return writeRespQueueEmpty(); }
+    bool
+    allRanksDrained() const override
+    {
+        return writeRespQueueEmpty() && xpLines.empty();
+    }
 
     /*
      * @return time to offset next command
@@ -308,9 +424,14 @@ class NVMInterface : public MemInterface
                   const std::vector<MemPacketQueue>& queue) override;
 
     /**
-     * The next three functions are DRAM-specific and will be ignored by NVM.
+     * Write back the lines of the write-combining buffer, so that none
+     * is left buffered once drained, and none is lost in a checkpoint.
+     */
+    void drainRanks() override { flushBuffer(); }
+
+    /**
+     * The next two functions are DRAM-specific and will be ignored by NVM.
      */
-    void drainRanks() override { }
     void suspend() override { }
     void startup() override { }
 
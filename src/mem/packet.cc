@@ -233,6 +233,9 @@ MemCmd::commandInfo[] =
     { {IsRead, IsResponse}, InvalidCmd, "HTMReqResp" },
     { {IsRead, IsRequest}, InvalidCmd, "HTMAbort" },
     { {IsRequest}, InvalidCmd, "TlbiExtSync" },
+    /* Back invalidation Request -- Snooped from a snoop filter evicting
+       a block, the caches above evict the block as if it were replaced */
+    { {IsRequest}, InvalidCmd, "BackInvalidateReq" },
 };
 
 AddrRange
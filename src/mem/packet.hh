@@ -146,6 +146,8 @@ class MemCmd
         HTMAbort,
         // Tlb shootdown
         TlbiExtSync,
+        // Snoop filter eviction
+        BackInvalidateReq, // request for caches above to evict a block
         NUM_MEM_CMDS
     };
 
@@ -47,3 +47,10 @@ class MemFootprintProbe(BaseMemProbe):
     system = Param.System(Parent.any,
                           "System pointer to get cache line and mem size")
     page_size = Param.Unsigned(4096, "Page size for page-level footprint")
+    estimate = Param.Bool(False, "Estimate the footprints with HyperLogLog, "
+                          "using a fixed amount of memory, instead of "
+                          "tracking every cache line accessed")
+    estimate_precision = Param.Unsigned(14, "Log2 of the number of "
+                                        "HyperLogLog registers, the "
+                                        "standard error is about "
+                                        "1.04 / sqrt(2^precision)")
@@ -48,6 +48,11 @@ class MemTraceProbe(BaseMemProbe):
     # For requests with a valid PC, include the PC in the trace
     with_pc = Param.Bool(False, "Include PC info in the trace")
 
+    # Write the trace in the columnar format instead of protobuf, which
+    # is smaller and cheaper to write. trace_compress then compresses
+    # each block of the trace, in a background thread.
+    columnar = Param.Bool(False, "Write a columnar trace")
+
     # packet trace output file, disabled by default
     trace_file = Param.String("", "Packet trace output file")
 
@@ -53,6 +53,14 @@ class StackDistProbe(BaseMemProbe):
     # enable verification stack
     verify = Param.Bool(False, "Verify behaviuor with reference implementation")
 
+    # approximate the stack distances by sampling the lines (SHARDS)
+    sampling_shift = Param.Unsigned(0, "Log2 of the inverse of the rate at "
+                                    "which lines are sampled (0 tracks all "
+                                    "lines, at most 30)")
+    max_tracked_lines = Param.UInt64(0, "Maximum number of tracked lines, "
+                                     "the sampling rate is lowered to stay "
+                                     "below it (0 for no limit)")
+
     # linear histogram bins and enable/disable
     linear_hist_bins = Param.Unsigned('16', "Bins in linear histograms")
     disable_linear_hists = Param.Bool(False, "Disable linear histograms")
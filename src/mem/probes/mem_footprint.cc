@@ -38,29 +38,82 @@
 
 #include "mem/probes/mem_footprint.hh"
 
+#include <algorithm>
+#include <cmath>
+
+#include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "params/MemFootprintProbe.hh"
 
 namespace gem5
 {
 
+const MemFootprintProbeParams &
+MemFootprintProbe::checkParams(const MemFootprintProbeParams &p)
+{
+    fatal_if(!isPowerOf2(p.system->cacheLineSize()),
+             "MemFootprintProbe expects cache line size is power of 2.");
+    fatal_if(!isPowerOf2(p.page_size),
+             "MemFootprintProbe expects page size parameter is power of 2");
+    fatal_if(p.page_size < p.system->cacheLineSize(),
+             "MemFootprintProbe expects pages larger than cache lines.");
+    fatal_if(p.estimate &&
+             (p.estimate_precision < 4 || p.estimate_precision > 18),
+             "MemFootprintProbe expects an estimate precision in [4, 18].");
+
+    return p;
+}
+
 MemFootprintProbe::MemFootprintProbe(const MemFootprintProbeParams &p)
-    : BaseMemProbe(p),
+    : BaseMemProbe(checkParams(p)),
       cacheLineSizeLg2(floorLog2(p.system->cacheLineSize())),
       pageSizeLg2(floorLog2(p.page_size)),
       totalCacheLinesInMem(p.system->memSize() / p.system->cacheLineSize()),
       totalPagesInMem(p.system->memSize() / p.page_size),
-      cacheLines(),
-      cacheLinesAll(),
-      pages(),
-      pagesAll(),
+      estimate(p.estimate),
+      lines(pageSizeLg2 - cacheLineSizeLg2),
+      linesAll(pageSizeLg2 - cacheLineSizeLg2),
+      cacheLinesEstimate(estimate ? p.estimate_precision : 4),
+      cacheLinesAllEstimate(estimate ? p.estimate_precision : 4),
+      pagesEstimate(estimate ? p.estimate_precision : 4),
+      pagesAllEstimate(estimate ? p.estimate_precision : 4),
       system(p.system),
       stats(this)
 {
-    fatal_if(!isPowerOf2(system->cacheLineSize()),
-             "MemFootprintProbe expects cache line size is power of 2.");
-    fatal_if(!isPowerOf2(p.page_size),
-             "MemFootprintProbe expects page size parameter is power of 2");
+}
+
+MemFootprintProbe::LineSet::LineSet(unsigned lines_per_page_lg2)
+    : linesPerPageLg2(lines_per_page_lg2),
+      wordsPerPage(divCeil(1ULL << lines_per_page_lg2, 64)),
+      numLines(0)
+{
+}
+
+void
+MemFootprintProbe::LineSet::insert(Addr line)
+{
+    const Addr page = line >> linesPerPageLg2;
+    const uint64_t offset = line & mask(linesPerPageLg2);
+
+    // Allocate a cleared bitmap for the pages accessed for the first time
+    auto [it, new_page] = pageBitmaps.emplace(page, bitmaps.size());
+    if (new_page)
+        bitmaps.resize(bitmaps.size() + wordsPerPage, 0);
+
+    uint64_t &word = bitmaps[it->second + offset / 64];
+    const uint64_t bit = 1ULL << (offset % 64);
+    if (!(word & bit)) {
+        word |= bit;
+        numLines++;
+    }
+}
+
+void
+MemFootprintProbe::LineSet::clear()
+{
+    pageBitmaps.clear();
+    bitmaps.clear();
+    numLines = 0;
 }
 
 MemFootprintProbe::MemFootprintProbeStats::MemFootprintProbeStats(
@@ -87,40 +140,58 @@ MemFootprintProbe::MemFootprintProbeStats::MemFootprintProbeStats(
     registerResetCallback([parent]() { parent->statReset(); });
 }
 
-void
-MemFootprintProbe::insertAddr(Addr addr, AddrSet *set, uint64_t limit)
-{
-    set->insert(addr);
-    assert(set->size() <= limit);
-}
-
 void
 MemFootprintProbe::handleRequest(const probing::PacketInfo &pi)
 {
     if (!pi.cmd.isRequest() || !system->isMemAddr(pi.addr))
         return;
 
-    const Addr cl_addr = (pi.addr >> cacheLineSizeLg2) << cacheLineSizeLg2;
-    const Addr page_addr = (pi.addr >> pageSizeLg2) << pageSizeLg2;
-    insertAddr(cl_addr, &cacheLines, totalCacheLinesInMem);
-    insertAddr(cl_addr, &cacheLinesAll, totalCacheLinesInMem);
-    insertAddr(page_addr, &pages, totalPagesInMem);
-    insertAddr(page_addr, &pagesAll, totalPagesInMem);
+    const Addr cl_num = pi.addr >> cacheLineSizeLg2;
+
+    if (estimate) {
+        const Addr page_num = pi.addr >> pageSizeLg2;
+        cacheLinesEstimate.insert(cl_num);
+        cacheLinesAllEstimate.insert(cl_num);
+        pagesEstimate.insert(page_num);
+        pagesAllEstimate.insert(page_num);
+
+        // The estimates cannot exceed the memory size
+        const auto footprint = [](const HyperLogLog &hll, uint64_t limit,
+                                  uint8_t size_lg2) {
+            const uint64_t count = std::llround(hll.estimate());
+            return std::min(count, limit) << size_lg2;
+        };
+        stats.cacheLine = footprint(cacheLinesEstimate,
+                                    totalCacheLinesInMem, cacheLineSizeLg2);
+        stats.cacheLineTotal = footprint(cacheLinesAllEstimate,
+                                         totalCacheLinesInMem,
+                                         cacheLineSizeLg2);
+        stats.page = footprint(pagesEstimate, totalPagesInMem, pageSizeLg2);
+        stats.pageTotal = footprint(pagesAllEstimate, totalPagesInMem,
+                                    pageSizeLg2);
+        return;
+    }
+
+    lines.insert(cl_num);
+    linesAll.insert(cl_num);
 
-    assert(cacheLines.size() <= cacheLinesAll.size());
-    assert(pages.size() <= pagesAll.size());
+    assert(linesAll.lines() <= totalCacheLinesInMem);
+    assert(linesAll.pages() <= totalPagesInMem);
+    assert(lines.lines() <= linesAll.lines());
+    assert(lines.pages() <= linesAll.pages());
 
-    stats.cacheLine = cacheLines.size() << cacheLineSizeLg2;
-    stats.cacheLineTotal = cacheLinesAll.size() << cacheLineSizeLg2;
-    stats.page = pages.size() << pageSizeLg2;
-    stats.pageTotal = pagesAll.size() << pageSizeLg2;
+    stats.cacheLine = lines.lines() << cacheLineSizeLg2;
+    stats.cacheLineTotal = linesAll.lines() << cacheLineSizeLg2;
+    stats.page = lines.pages() << pageSizeLg2;
+    stats.pageTotal = linesAll.pages() << pageSizeLg2;
 }
 
 void
 MemFootprintProbe::statReset()
 {
-    cacheLines.clear();
-    pages.clear();
+    lines.clear();
+    cacheLinesEstimate.clear();
+    pagesEstimate.clear();
 }
 
 } // namespace gem5
@@ -39,9 +39,12 @@
 #ifndef __MEM_PROBES_MEM_FOOTPRINT_HH__
 #define __MEM_PROBES_MEM_FOOTPRINT_HH__
 
-#include <unordered_set>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 #include "base/callback.hh"
+#include "base/hyperloglog.hh"
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
 #include "sim/stats.hh"
@@ -57,13 +60,63 @@ struct MemFootprintProbeParams;
 class MemFootprintProbe : public BaseMemProbe
 {
   public:
-    typedef std::unordered_set<Addr> AddrSet;
+    /**
+     * Set of the cache lines accessed, held as a bitmap of the lines of
+     * every page accessed. The pages accessed are the pages that have a
+     * bitmap.
+     */
+    class LineSet
+    {
+      public:
+        /**
+         * @param lines_per_page_lg2 Number of cache lines in a page (log2)
+         */
+        LineSet(unsigned lines_per_page_lg2);
+
+        /**
+         * Add a cache line to the set.
+         *
+         * @param line Cache line number, i.e., address / line size
+         */
+        void insert(Addr line);
+
+        /** Number of cache lines in the set */
+        uint64_t lines() const { return numLines; }
+
+        /** Number of pages with a cache line in the set */
+        uint64_t pages() const { return pageBitmaps.size(); }
+
+        void clear();
+
+      private:
+        const unsigned linesPerPageLg2;
+
+        /** Number of 64-bit words in the bitmap of a page */
+        const size_t wordsPerPage;
+
+        /** Position in bitmaps of the bitmap of each page, by page number */
+        std::unordered_map<Addr, size_t> pageBitmaps;
+
+        /** Bitmaps of all pages */
+        std::vector<uint64_t> bitmaps;
+
+        uint64_t numLines;
+    };
 
     MemFootprintProbe(const MemFootprintProbeParams &p);
     // Fix footprint tracking state on stat reset
     void statReset();
 
   protected:
+    /**
+     * Check the parameters, before any member is built from them.
+     *
+     * @param p The parameters of the probe
+     * @return The parameters
+     */
+    static const MemFootprintProbeParams &
+    checkParams(const MemFootprintProbeParams &p);
+
     /// Cache Line size for footprint measurement (log2)
     const uint8_t cacheLineSizeLg2;
     /// Page size for footprint measurement (log2)
@@ -71,7 +124,6 @@ class MemFootprintProbe : public BaseMemProbe
     const uint64_t totalCacheLinesInMem;
     const uint64_t totalPagesInMem;
 
-    void insertAddr(Addr addr, AddrSet *set, uint64_t limit);
     void handleRequest(const probing::PacketInfo &pkt_info) override;
 
     struct MemFootprintProbeStats : public statistics::Group
@@ -88,14 +140,23 @@ class MemFootprintProbe : public BaseMemProbe
         statistics::Scalar pageTotal;
     };
 
-    // Addr set to track unique cache lines accessed
-    AddrSet cacheLines;
-    // Addr set to track unique cache lines accessed since simulation begin
-    AddrSet cacheLinesAll;
-    // Addr set to track unique pages accessed
-    AddrSet pages;
-    // Addr set to track unique pages accessed since simulation begin
-    AddrSet pagesAll;
+    // Estimate the footprints with HyperLogLog instead of tracking the
+    // lines accessed
+    const bool estimate;
+
+    // Line set to track unique cache lines and pages accessed
+    LineSet lines;
+    // Line set to track unique cache lines and pages accessed since
+    // simulation begin
+    LineSet linesAll;
+
+    // Estimators of the unique cache lines and pages accessed, and since
+    // simulation begin, when estimating
+    HyperLogLog cacheLinesEstimate;
+    HyperLogLog cacheLinesAllEstimate;
+    HyperLogLog pagesEstimate;
+    HyperLogLog pagesAllEstimate;
+
     System *system;
 
     MemFootprintProbeStats stats;
@@ -51,6 +51,7 @@ namespace gem5
 MemTraceProbe::MemTraceProbe(const MemTraceProbeParams &p)
     : BaseMemProbe(p),
       traceStream(nullptr),
+      columnarStream(nullptr),
       system(p.system),
       withPC(p.with_pc)
 {
@@ -62,11 +63,13 @@ MemTraceProbe::MemTraceProbe(const MemTraceProbeParams &p)
 
         const std::string suffix = ".gz";
         // If trace_compress has been set, check the suffix. Append
-        // accordingly.
-        if (p.trace_compress &&
+        // accordingly. Columnar traces compress their blocks instead.
+        if (p.trace_compress && !p.columnar &&
             filename.compare(filename.size() - suffix.size(), suffix.size(),
                              suffix) != 0)
             filename = filename + suffix;
+    } else if (p.columnar) {
+        filename = simout.resolve(name() + ".ctrc");
     } else {
         // Generate a filename from the name of the SimObject. Append .trc
         // and .gz if we want compression enabled.
@@ -74,7 +77,12 @@ MemTraceProbe::MemTraceProbe(const MemTraceProbeParams &p)
                                   (p.trace_compress ? ".gz" : ""));
     }
 
-    traceStream = new ProtoOutputStream(filename);
+    if (p.columnar) {
+        columnarStream =
+            new ColumnarTraceOutputStream(filename, p.trace_compress);
+    } else {
+        traceStream = new ProtoOutputStream(filename);
+    }
 
     // Register a callback to compensate for the destructor not
     // being called. The callback forces the stream to flush and
@@ -85,6 +93,16 @@ MemTraceProbe::MemTraceProbe(const MemTraceProbeParams &p)
 void
 MemTraceProbe::startup()
 {
+    if (columnarStream) {
+        PacketTraceHeader header;
+        header.objId = name();
+        header.tickFreq = sim_clock::Frequency;
+        for (int i = 0; i < system->maxRequestors(); i++)
+            header.idStrings.emplace_back(i, system->getRequestorName(i));
+        columnarStream->writeHeader(header);
+        return;
+    }
+
     // Create a protobuf message for the header and write it to
     // the stream
     ProtoMessage::PacketHeader header_msg;
@@ -105,11 +123,26 @@ MemTraceProbe::closeStreams()
 {
     if (traceStream != NULL)
         delete traceStream;
+    delete columnarStream;
 }
 
 void
 MemTraceProbe::handleRequest(const probing::PacketInfo &pkt_info)
 {
+    if (columnarStream) {
+        PacketTraceRecord record;
+        record.tick = curTick();
+        record.cmd = pkt_info.cmd.toInt();
+        record.flags = pkt_info.flags;
+        record.addr = pkt_info.addr;
+        record.size = pkt_info.size;
+        if (withPC)
+            record.pc = pkt_info.pc;
+        record.pktId = pkt_info.id;
+        columnarStream->write(record);
+        return;
+    }
+
     ProtoMessage::Packet pkt_msg;
 
     pkt_msg.set_tick(curTick());
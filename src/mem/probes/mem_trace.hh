@@ -40,6 +40,7 @@
 
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
+#include "proto/columnar_trace.hh"
 #include "proto/protoio.hh"
 
 namespace gem5
@@ -69,6 +70,9 @@ class MemTraceProbe : public BaseMemProbe
     /** Trace output stream */
     ProtoOutputStream *traceStream;
 
+    /** Trace output stream, when the trace is columnar */
+    ColumnarTraceOutputStream *columnarStream;
+
     System *system;
 
   private:
@@ -48,7 +48,7 @@ StackDistProbe::StackDistProbe(const StackDistProbeParams &p)
       lineSize(p.line_size),
       disableLinearHists(p.disable_linear_hists),
       disableLogHists(p.disable_log_hists),
-      calc(p.verify),
+      calc(p.verify, p.sampling_shift, p.max_tracked_lines),
       stats(this)
 {
     fatal_if(p.system->cacheLineSize() > p.line_size,
@@ -106,19 +106,25 @@ StackDistProbe::handleRequest(const probing::PacketInfo &pkt_info)
     // Align the address to a cache line size
     const Addr aligned_addr(roundDown(pkt_info.addr, lineSize));
 
+    // When sampling, only the sampled lines are tracked, and each of
+    // their accesses stands for the accesses to the other lines
+    if (!calc.sampled(aligned_addr))
+        return;
+    const uint64_t weight(calc.sampleWeight());
+
     // Calculate the stack distance
     const uint64_t sd(calc.calcStackDistAndUpdate(aligned_addr).first);
     if (sd == StackDistCalc::Infinity) {
-        stats.infiniteSD++;
+        stats.infiniteSD += weight;
         return;
     }
 
     // Sample the stack distance of the address in linear bins
     if (!disableLinearHists) {
         if (pkt_info.cmd.isRead())
-            stats.readLinearHist.sample(sd);
+            stats.readLinearHist.sample(sd, weight);
         else
-            stats.writeLinearHist.sample(sd);
+            stats.writeLinearHist.sample(sd, weight);
     }
 
     if (!disableLogHists) {
@@ -126,9 +132,9 @@ StackDistProbe::handleRequest(const probing::PacketInfo &pkt_info)
 
         // Sample the stack distance of the address in log bins
         if (pkt_info.cmd.isRead())
-            stats.readLogHist.sample(sd_lg2);
+            stats.readLogHist.sample(sd_lg2, weight);
         else
-            stats.writeLogHist.sample(sd_lg2);
+            stats.writeLogHist.sample(sd_lg2, weight);
     }
 }
 
@@ -49,21 +49,31 @@ namespace ruby
 Consumer::Consumer(ClockedObject *_em, Event::Priority ev_prio)
     : m_wakeup_event([this]{ processCurrentEvent(); },
                     "Consumer Event", false, ev_prio),
-      em(_em)
+      em(_em), m_last_wakeup_tick(MaxTick), m_nonempty_ports(0)
 { }
 
 void
 Consumer::scheduleEvent(Cycles timeDelta)
 {
-    m_wakeup_ticks.insert(em->clockEdge(timeDelta));
-    scheduleNextWakeup();
+    scheduleWakeup(em->clockEdge(timeDelta));
 }
 
 void
 Consumer::scheduleEventAbsolute(Tick evt_time)
 {
-    m_wakeup_ticks.insert(
-        divCeil(evt_time, em->clockPeriod()) * em->clockPeriod());
+    scheduleWakeup(divCeil(evt_time, em->clockPeriod()) * em->clockPeriod());
+}
+
+void
+Consumer::scheduleWakeup(Tick when)
+{
+    // The wakeup is already pending, and the next wakeup was scheduled
+    // when it was inserted
+    if (when == m_last_wakeup_tick)
+        return;
+
+    m_last_wakeup_tick = when;
+    m_wakeup_ticks.insert(when);
     scheduleNextWakeup();
 }
 
@@ -90,6 +100,8 @@ Consumer::processCurrentEvent()
 
     // remove the current tick from the wakeup list, wake up, and then schedule
     // the next wakeup
+    if (*curr == m_last_wakeup_tick)
+        m_last_wakeup_tick = MaxTick;
     m_wakeup_ticks.erase(curr);
     wakeup();
     scheduleNextWakeup();
@@ -47,6 +47,8 @@
 #ifndef __MEM_RUBY_COMMON_CONSUMER_HH__
 #define __MEM_RUBY_COMMON_CONSUMER_HH__
 
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <set>
 
@@ -87,11 +89,46 @@ class Consumer
     void scheduleEventAbsolute(Tick timeAbs);
     void scheduleEvent(Cycles timeDelta);
 
+    /**
+     * Record whether the message buffer of an input port of the consumer
+     * is non-empty. The buffer updates it whenever it becomes empty or
+     * non-empty, whether or not its messages are ready yet, so that the
+     * consumer can skip the empty ports when it wakes up. Only ports 0 to
+     * 63 can be tracked.
+     */
+    void
+    setPortNonEmpty(int port, bool non_empty)
+    {
+        assert(port >= 0 && port < 64);
+        if (non_empty)
+            m_nonempty_ports |= 1ULL << port;
+        else
+            m_nonempty_ports &= ~(1ULL << port);
+    }
+
+    /**
+     * Whether the message buffer of an input port holds any message. A
+     * message may be held that is not ready to be dequeued yet.
+     */
+    bool
+    hasPortMessages(int port) const
+    {
+        return (m_nonempty_ports >> port) & 1;
+    }
+
   private:
     std::set<Tick> m_wakeup_ticks;
     EventFunctionWrapper m_wakeup_event;
     ClockedObject *em;
 
+    // The last tick a wakeup was requested for, while it is pending, so
+    // that the messages arriving in the same cycle only insert it once
+    Tick m_last_wakeup_tick;
+
+    // The input ports whose message buffers are non-empty
+    uint64_t m_nonempty_ports;
+
+    void scheduleWakeup(Tick when);
     void scheduleNextWakeup();
     void processCurrentEvent();
 };
@@ -49,36 +49,108 @@ namespace gem5
 namespace ruby
 {
 
+thread_local DataBlock::CopyCounts *DataBlock::copyCounts = nullptr;
+
 DataBlock::DataBlock(const DataBlock &cp)
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
-    memcpy(m_data, cp.m_data, RubySystem::getBlockSizeBytes());
+    if (cp.m_alloc) {
+        m_data = cp.m_data;
+        refCount(m_data)++;
+        if (copyCounts && m_data != zeroLine())
+            copyCounts->shared++;
+    } else {
+        // The data of an assigned buffer can change under the block, so
+        // it is copied right away
+        m_data = allocLine(RubySystem::getBlockSizeBytes());
+        memcpy(m_data, cp.m_data, RubySystem::getBlockSizeBytes());
+    }
     m_alloc = true;
 }
 
+uint8_t *
+DataBlock::allocLine(size_t size)
+{
+    uint8_t *line = new uint8_t[LineHeaderSize + size];
+    uint8_t *data = line + LineHeaderSize;
+    refCount(data) = 1;
+    return data;
+}
+
+uint8_t *
+DataBlock::zeroLine()
+{
+    // The line keeps a reference of its own, so that it is never freed
+    static uint8_t *line = []() {
+        uint8_t *data = allocLine(ZeroLineSize);
+        memset(data, 0, ZeroLineSize);
+        return data;
+    }();
+    return line;
+}
+
 void
 DataBlock::alloc()
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
+    if (RubySystem::getBlockSizeBytes() <= ZeroLineSize) {
+        m_data = zeroLine();
+        refCount(m_data)++;
+    } else {
+        m_data = allocLine(RubySystem::getBlockSizeBytes());
+        memset(m_data, 0, RubySystem::getBlockSizeBytes());
+    }
     m_alloc = true;
-    clear();
+}
+
+void
+DataBlock::release()
+{
+    if (m_alloc && --refCount(m_data) == 0)
+        delete [] (m_data - LineHeaderSize);
+}
+
+void
+DataBlock::copyLine(bool keep_data)
+{
+    uint8_t *data = allocLine(RubySystem::getBlockSizeBytes());
+    if (m_data == zeroLine()) {
+        if (keep_data)
+            memset(data, 0, RubySystem::getBlockSizeBytes());
+    } else if (keep_data) {
+        memcpy(data, m_data, RubySystem::getBlockSizeBytes());
+        if (copyCounts)
+            copyCounts->copiedOnWrite++;
+    }
+    // The line is shared, so the reference of this block is not the last
+    refCount(m_data)--;
+    m_data = data;
 }
 
 void
 DataBlock::clear()
 {
-    memset(m_data, 0, RubySystem::getBlockSizeBytes());
+    if (m_alloc) {
+        release();
+        alloc();
+    } else {
+        memset(m_data, 0, RubySystem::getBlockSizeBytes());
+    }
 }
 
 bool
 DataBlock::equal(const DataBlock& obj) const
 {
-    return !memcmp(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
+    return m_data == obj.m_data ||
+        !memcmp(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
 }
 
 void
 DataBlock::copyPartial(const DataBlock &dblk, const WriteMask &mask)
 {
+    if (mask.isFull()) {
+        *this = dblk;
+        return;
+    }
+    makeUnique();
     for (int i = 0; i < RubySystem::getBlockSizeBytes(); i++) {
         if (mask.getMask(i, 1)) {
             m_data[i] = dblk.m_data[i];
@@ -89,9 +161,12 @@ DataBlock::copyPartial(const DataBlock &dblk, const WriteMask &mask)
 void
 DataBlock::atomicPartial(const DataBlock &dblk, const WriteMask &mask)
 {
-    for (int i = 0; i < RubySystem::getBlockSizeBytes(); i++) {
-        m_data[i] = dblk.m_data[i];
-    }
+    // The line of dblk stays valid if this block drops it, as it is
+    // still used by dblk
+    const uint8_t *data = dblk.m_data;
+    makeUnique(false);
+    if (m_data != data)
+        memcpy(m_data, data, RubySystem::getBlockSizeBytes());
     mask.performAtomic(m_data);
 }
 
@@ -117,12 +192,14 @@ DataBlock::getData(int offset, int len) const
 uint8_t*
 DataBlock::getDataMod(int offset)
 {
+    makeUnique();
     return &m_data[offset];
 }
 
 void
 DataBlock::setData(const uint8_t *data, int offset, int len)
 {
+    makeUnique(offset > 0 || len < RubySystem::getBlockSizeBytes());
     memcpy(&m_data[offset], data, len);
 }
 
@@ -131,13 +208,27 @@ DataBlock::setData(PacketPtr pkt)
 {
     int offset = getOffset(pkt->getAddr());
     assert(offset + pkt->getSize() <= RubySystem::getBlockSizeBytes());
+    makeUnique(offset > 0 || pkt->getSize() < RubySystem::getBlockSizeBytes());
     pkt->writeData(&m_data[offset]);
 }
 
 DataBlock &
 DataBlock::operator=(const DataBlock & obj)
 {
-    memcpy(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
+    if (m_data == obj.m_data)
+        return *this;
+
+    if (!m_alloc || !obj.m_alloc) {
+        // Write through to an assigned buffer, and do not share one
+        makeUnique(false);
+        memcpy(m_data, obj.m_data, RubySystem::getBlockSizeBytes());
+    } else {
+        release();
+        m_data = obj.m_data;
+        refCount(m_data)++;
+        if (copyCounts && m_data != zeroLine())
+            copyCounts->shared++;
+    }
     return *this;
 }
 
@@ -44,6 +44,8 @@
 #include <inttypes.h>
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 
@@ -57,6 +59,15 @@ namespace ruby
 
 class WriteMask;
 
+// A DataBlock holds the data of a line. Copying a block does not copy
+// its data: the copy shares the line buffer of the original, which is
+// reference counted, and the buffer is only copied when one of the
+// blocks sharing it is modified. Blocks that were not written to share
+// a line of zeros, unless the lines are larger than it.
+//
+// A block can also be assigned a buffer it does not own, in which case
+// it reads and writes that buffer directly, and assigning another block
+// to it copies the data into the buffer.
 class DataBlock
 {
   public:
@@ -69,8 +80,7 @@ class DataBlock
 
     ~DataBlock()
     {
-        if (m_alloc)
-            delete [] m_data;
+        release();
     }
 
     DataBlock& operator=(const DataBlock& obj);
@@ -90,9 +100,74 @@ class DataBlock
     bool equal(const DataBlock& obj) const;
     void print(std::ostream& out) const;
 
+    // Number of block copies that shared the line of the copied block,
+    // and number of those that had to copy it later because one of the
+    // blocks was modified
+    struct CopyCounts
+    {
+        uint64_t shared = 0;
+        uint64_t copiedOnWrite = 0;
+    };
+
+    // Counts the copies made by the thread into the counts of a Ruby
+    // system, e.g. while one of its controllers wakes up, as long as it
+    // is in scope
+    class CountCopies
+    {
+      public:
+        CountCopies(CopyCounts *counts) : prev(copyCounts)
+        {
+            copyCounts = counts;
+        }
+
+        ~CountCopies() { copyCounts = prev; }
+
+      private:
+        CopyCounts *prev;
+    };
+
   private:
     void alloc();
+
+    // Drop the reference of this block to its line
+    void release();
+
+    // Make sure that this block is the only one using its line, before
+    // modifying it. If keep_data is false, the caller overwrites the
+    // whole line, and the data of the shared line is not copied.
+    void
+    makeUnique(bool keep_data = true)
+    {
+        if (m_alloc && refCount(m_data) > 1)
+            copyLine(keep_data);
+    }
+
+    void copyLine(bool keep_data);
+
+    // The line buffers start with their reference count, which is
+    // padded so that the data stays aligned
+    static constexpr size_t LineHeaderSize = alignof(std::max_align_t);
+
+    static uint8_t *allocLine(size_t size);
+
+    static unsigned &
+    refCount(uint8_t *data)
+    {
+        return *reinterpret_cast<unsigned *>(data - LineHeaderSize);
+    }
+
+    // The line of zeros shared by the cleared blocks. It has a fixed
+    // size, so that it stays valid whatever the block size is.
+    static constexpr size_t ZeroLineSize = 1024;
+    static uint8_t *zeroLine();
+
+    // The counts the copies are added to, none when null
+    static thread_local CopyCounts *copyCounts;
+
     uint8_t *m_data;
+
+    // Whether m_data is a reference counted line, as opposed to a buffer
+    // assigned to the block
     bool m_alloc;
 };
 
@@ -100,9 +175,7 @@ inline void
 DataBlock::assign(uint8_t *data)
 {
     assert(data != NULL);
-    if (m_alloc) {
-        delete [] m_data;
-    }
+    release();
     m_data = data;
     m_alloc = false;
 }
@@ -116,6 +189,7 @@ DataBlock::getByte(int whichByte) const
 inline void
 DataBlock::setByte(int whichByte, uint8_t data)
 {
+    makeUnique();
     m_data[whichByte] = data;
 }
 
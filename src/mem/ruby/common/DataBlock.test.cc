@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "mem/ruby/common/DataBlock.hh"
+#include "mem/ruby/common/WriteMask.hh"
+#include "mem/ruby/system/RubySystem.hh"
+
+using namespace gem5;
+using namespace gem5::ruby;
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+// The block size is set by the RubySystem, which is not built with the
+// test, so its static members are defined here
+uint32_t RubySystem::m_block_size_bytes = 64;
+uint32_t RubySystem::m_block_size_bits = 6;
+
+} // namespace ruby
+} // namespace gem5
+
+namespace
+{
+
+const int blockSize = 64;
+
+std::vector<uint8_t>
+contents(const DataBlock &blk)
+{
+    const uint8_t *data = blk.getData(0, blockSize);
+    return std::vector<uint8_t>(data, data + blockSize);
+}
+
+void
+fill(DataBlock &blk, uint8_t first)
+{
+    for (int i = 0; i < blockSize; i++)
+        blk.setByte(i, first + i);
+}
+
+} // anonymous namespace
+
+/** Blocks that were never written share a line of zeros. */
+TEST(DataBlockTest, ZeroLine)
+{
+    DataBlock a;
+    DataBlock b;
+    EXPECT_EQ(a.getData(0, blockSize), b.getData(0, blockSize));
+    EXPECT_EQ(contents(a), std::vector<uint8_t>(blockSize, 0));
+
+    a.setByte(3, 0xff);
+    EXPECT_NE(a.getData(0, blockSize), b.getData(0, blockSize));
+    EXPECT_EQ(a.getByte(3), 0xff);
+    EXPECT_EQ(contents(b), std::vector<uint8_t>(blockSize, 0));
+
+    a.clear();
+    EXPECT_EQ(a.getData(0, blockSize), b.getData(0, blockSize));
+    EXPECT_EQ(a, b);
+}
+
+/** Copies share the line of the original until one is written. */
+TEST(DataBlockTest, WriteAfterCopy)
+{
+    DataBlock a;
+    fill(a, 1);
+    const std::vector<uint8_t> original = contents(a);
+
+    DataBlock::CopyCounts counts;
+    DataBlock::CountCopies count_copies(&counts);
+
+    DataBlock b(a);
+    DataBlock c;
+    c = a;
+    EXPECT_EQ(counts.shared, 2);
+    EXPECT_EQ(b.getData(0, blockSize), a.getData(0, blockSize));
+    EXPECT_EQ(c.getData(0, blockSize), a.getData(0, blockSize));
+
+    // Writing a copy keeps the rest of its data, and leaves the other
+    // blocks alone
+    b.setByte(0, 0xaa);
+    EXPECT_EQ(counts.copiedOnWrite, 1);
+    EXPECT_EQ(b.getByte(0), 0xaa);
+    EXPECT_EQ(b.getByte(1), original[1]);
+    EXPECT_EQ(contents(a), original);
+    EXPECT_EQ(contents(c), original);
+
+    // Overwriting a whole line does not need to copy it first
+    const uint8_t zeros[blockSize] = {};
+    c.setData(zeros, 0, blockSize);
+    EXPECT_EQ(counts.copiedOnWrite, 1);
+    EXPECT_EQ(contents(c), std::vector<uint8_t>(blockSize, 0));
+    EXPECT_EQ(contents(a), original);
+
+    // The last block using a line writes it in place
+    DataBlock d(a);
+    a.setByte(0, 0x55);
+    const uint8_t *line = d.getData(0, blockSize);
+    d.setByte(2, 0x66);
+    EXPECT_EQ(d.getData(0, blockSize), line);
+    EXPECT_EQ(contents(a)[2], original[2]);
+}
+
+/** A full mask shares the line, a partial one only copies its bytes. */
+TEST(DataBlockTest, CopyPartial)
+{
+    DataBlock src;
+    fill(src, 1);
+
+    WriteMask full;
+    full.fillMask();
+    DataBlock dst;
+    dst.copyPartial(src, full);
+    EXPECT_EQ(dst.getData(0, blockSize), src.getData(0, blockSize));
+    EXPECT_EQ(dst, src);
+
+    dst.setByte(0, 0xaa);
+    EXPECT_EQ(src.getByte(0), 1);
+
+    WriteMask partial;
+    partial.setMask(8, 8);
+    DataBlock other;
+    other.copyPartial(src, partial);
+    for (int i = 0; i < blockSize; i++)
+        EXPECT_EQ(other.getByte(i), (i >= 8 && i < 16) ? src.getByte(i) : 0);
+    EXPECT_NE(other.getData(0, blockSize), src.getData(0, blockSize));
+}
+
+/** Blocks assigned a buffer read and write it, and never share it. */
+TEST(DataBlockTest, AssignedBuffer)
+{
+    uint8_t buffer[blockSize];
+    memset(buffer, 0x11, blockSize);
+
+    DataBlock a;
+    a.assign(buffer);
+    EXPECT_EQ(a.getData(0, blockSize), buffer);
+
+    // Assigning a block to it copies the data into the buffer
+    DataBlock src;
+    fill(src, 1);
+    a = src;
+    EXPECT_EQ(a.getData(0, blockSize), buffer);
+    EXPECT_EQ(contents(a), contents(src));
+    src.setByte(0, 0xaa);
+    EXPECT_EQ(buffer[0], 1);
+
+    // Copies of it do not see later changes to the buffer
+    DataBlock copy(a);
+    DataBlock assigned;
+    assigned = a;
+    buffer[1] = 0xbb;
+    EXPECT_EQ(a.getByte(1), 0xbb);
+    EXPECT_EQ(copy.getByte(1), 2);
+    EXPECT_EQ(assigned.getByte(1), 2);
+
+    // Writes go to the buffer
+    a.setByte(2, 0xcc);
+    EXPECT_EQ(buffer[2], 0xcc);
+    a.clear();
+    EXPECT_EQ(std::vector<uint8_t>(buffer, buffer + blockSize),
+              std::vector<uint8_t>(blockSize, 0));
+}
+
+/** Copies are only counted into the counts in scope, if any. */
+TEST(DataBlockTest, CopyCounts)
+{
+    DataBlock a;
+    fill(a, 1);
+
+    DataBlock uncounted(a);
+    uncounted.setByte(0, 0xaa);
+
+    DataBlock::CopyCounts first;
+    DataBlock::CopyCounts second;
+    {
+        DataBlock::CountCopies count_first(&first);
+        DataBlock b(a);
+        {
+            DataBlock::CountCopies count_second(&second);
+            DataBlock c(a);
+            DataBlock d(a);
+            d.setByte(0, 0xbb);
+        }
+        b.setByte(0, 0xcc);
+    }
+    DataBlock e(a);
+
+    EXPECT_EQ(first.shared, 1);
+    EXPECT_EQ(first.copiedOnWrite, 1);
+    EXPECT_EQ(second.shared, 2);
+    EXPECT_EQ(second.copiedOnWrite, 1);
+}
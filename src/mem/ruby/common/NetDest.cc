@@ -30,6 +30,8 @@
 
 #include <algorithm>
 
+#include "base/bitfield.hh"
+
 namespace gem5
 {
 
@@ -44,16 +46,16 @@ NetDest::NetDest()
 void
 NetDest::add(MachineID newElement)
 {
-    assert(bitIndex(newElement.num) < m_bits[vecIndex(newElement)].getSize());
-    m_bits[vecIndex(newElement)].add(bitIndex(newElement.num));
+    int index = bitIndex(newElement);
+    m_bits[index / 64] |= 1ULL << (index % 64);
 }
 
 void
 NetDest::addNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
+    assert(m_nBits == netDest.getSize());
     for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].addSet(netDest.m_bits[i]);
+        m_bits[i] |= netDest.m_bits[i];
     }
 }
 
@@ -63,62 +65,62 @@ NetDest::setNetDest(MachineType machine, const Set& set)
     // assure that there is only one set of destinations for this machine
     assert(MachineType_base_level((MachineType)(machine + 1)) -
            MachineType_base_level(machine) == 1);
-    m_bits[MachineType_base_level(machine)] = set;
+    int base = MachineType_base_number(machine);
+    int count = MachineType_base_count(machine);
+    for (int j = 0; j < count; j++) {
+        int index = base + j;
+        uint64_t bit = 1ULL << (index % 64);
+        if (j < set.getSize() && set.isElement(j))
+            m_bits[index / 64] |= bit;
+        else
+            m_bits[index / 64] &= ~bit;
+    }
 }
 
 void
 NetDest::remove(MachineID oldElement)
 {
-    m_bits[vecIndex(oldElement)].remove(bitIndex(oldElement.num));
+    int index = bitIndex(oldElement);
+    m_bits[index / 64] &= ~(1ULL << (index % 64));
 }
 
 void
 NetDest::removeNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
+    assert(m_nBits == netDest.getSize());
     for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].removeSet(netDest.m_bits[i]);
+        m_bits[i] &= ~netDest.m_bits[i];
     }
 }
 
 void
 NetDest::clear()
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].clear();
-    }
+    std::fill(m_bits.begin(), m_bits.end(), 0);
 }
 
 void
 NetDest::broadcast()
 {
-    for (MachineType machine = MachineType_FIRST;
-         machine < MachineType_NUM; ++machine) {
-        broadcast(machine);
-    }
+    setRange(0, m_nBits);
 }
 
 void
 NetDest::broadcast(MachineType machineType)
 {
-    for (NodeID i = 0; i < MachineType_base_count(machineType); i++) {
-        MachineID mach = {machineType, i};
-        add(mach);
-    }
+    int base = MachineType_base_number(machineType);
+    setRange(base, base + MachineType_base_count(machineType));
 }
 
 //For Princeton Network
 std::vector<NodeID>
 NetDest::getAllDest()
 {
+    // The index of a bit is the id of its machine
     std::vector<NodeID> dest;
-    dest.clear();
     for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                int id = MachineType_base_number((MachineType)i) + j;
-                dest.push_back((NodeID)id);
-            }
+        for (uint64_t word = m_bits[i]; word; word &= word - 1) {
+            dest.push_back((NodeID)(i * 64 + findLsbSet(word)));
         }
     }
     return dest;
@@ -129,7 +131,7 @@ NetDest::count() const
 {
     int counter = 0;
     for (int i = 0; i < m_bits.size(); i++) {
-        counter += m_bits[i].count();
+        counter += popCount(m_bits[i]);
     }
     return counter;
 }
@@ -137,19 +139,20 @@ NetDest::count() const
 NodeID
 NetDest::elementAt(MachineID index)
 {
-    return m_bits[vecIndex(index)].elementAt(bitIndex(index.num));
+    return isElement(index);
 }
 
 MachineID
 NetDest::smallestElement() const
 {
     assert(count() > 0);
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (NodeID j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                MachineID mach = {MachineType_from_base_level(i), j};
-                return mach;
-            }
+    int index = findFirst(0, m_nBits);
+    for (int i = 0; i < MachineType_NUM; i++) {
+        MachineType machine = MachineType_from_base_level(i);
+        int base = MachineType_base_number(machine);
+        if (index < base + MachineType_base_count(machine)) {
+            MachineID mach = {machine, (NodeID)(index - base)};
+            return mach;
         }
     }
     panic("No smallest element of an empty set.");
@@ -158,12 +161,12 @@ NetDest::smallestElement() const
 MachineID
 NetDest::smallestElement(MachineType machine) const
 {
-    int size = m_bits[MachineType_base_level(machine)].getSize();
-    for (NodeID j = 0; j < size; j++) {
-        if (m_bits[MachineType_base_level(machine)].isElement(j)) {
-            MachineID mach = {machine, j};
-            return mach;
-        }
+    int base = MachineType_base_number(machine);
+    int end = base + MachineType_base_count(machine);
+    int index = findFirst(base, end);
+    if (index < end) {
+        MachineID mach = {machine, (NodeID)(index - base)};
+        return mach;
     }
 
     panic("No smallest element of given MachineType.");
@@ -173,35 +176,27 @@ NetDest::smallestElement(MachineType machine) const
 bool
 NetDest::isBroadcast() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isBroadcast()) {
-            return false;
-        }
-    }
-    return true;
+    return count() == m_nBits;
 }
 
 // Returns true iff no bits are set
 bool
 NetDest::isEmpty() const
 {
+    uint64_t bits = 0;
     for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isEmpty()) {
-            return false;
-        }
+        bits |= m_bits[i];
     }
-    return true;
+    return bits == 0;
 }
 
 // returns the logical OR of "this" set and orNetDest
 NetDest
 NetDest::OR(const NetDest& orNetDest) const
 {
-    assert(m_bits.size() == orNetDest.getSize());
-    NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].OR(orNetDest.m_bits[i]);
-    }
+    assert(m_nBits == orNetDest.getSize());
+    NetDest result(*this);
+    result.addNetDest(orNetDest);
     return result;
 }
 
@@ -209,10 +204,10 @@ NetDest::OR(const NetDest& orNetDest) const
 NetDest
 NetDest::AND(const NetDest& andNetDest) const
 {
-    assert(m_bits.size() == andNetDest.getSize());
-    NetDest result;
+    assert(m_nBits == andNetDest.getSize());
+    NetDest result(*this);
     for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].AND(andNetDest.m_bits[i]);
+        result.m_bits[i] &= andNetDest.m_bits[i];
     }
     return result;
 }
@@ -221,53 +216,75 @@ NetDest::AND(const NetDest& andNetDest) const
 bool
 NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 {
-    assert(m_bits.size() == other_netDest.getSize());
+    assert(m_nBits == other_netDest.getSize());
+    uint64_t bits = 0;
     for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].intersectionIsEmpty(other_netDest.m_bits[i])) {
-            return true;
-        }
+        bits |= m_bits[i] & other_netDest.m_bits[i];
     }
-    return false;
+    return bits != 0;
 }
 
 bool
 NetDest::isSuperset(const NetDest& test) const
 {
-    assert(m_bits.size() == test.getSize());
-
+    assert(m_nBits == test.getSize());
+    uint64_t missing = 0;
     for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isSuperset(test.m_bits[i])) {
-            return false;
-        }
+        missing |= test.m_bits[i] & ~m_bits[i];
     }
-    return true;
+    return missing == 0;
 }
 
 bool
 NetDest::isElement(MachineID element) const
 {
-    return ((m_bits[vecIndex(element)])).isElement(bitIndex(element.num));
+    int index = bitIndex(element);
+    return (m_bits[index / 64] >> (index % 64)) & 1;
 }
 
 void
 NetDest::resize()
 {
-    m_bits.resize(MachineType_base_level(MachineType_NUM));
-    assert(m_bits.size() == MachineType_NUM);
+    m_nBits = MachineType_base_number(MachineType_NUM);
+    m_bits.assign((m_nBits + 63) / 64, 0);
+}
 
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].setSize(MachineType_base_count((MachineType)i));
+int
+NetDest::findFirst(int begin, int end) const
+{
+    for (int i = begin / 64; i * 64 < end; i++) {
+        // Ignore the bits of the first word before begin
+        uint64_t word = m_bits[i];
+        if (i == begin / 64)
+            word &= ~mask(begin % 64);
+        if (word) {
+            return std::min(end, i * 64 + findLsbSet(word));
+        }
+    }
+    return end;
+}
+
+void
+NetDest::setRange(int begin, int end)
+{
+    for (int i = begin / 64; i * 64 < end; i++) {
+        // The bits of the range in this word
+        int first = std::max(begin - i * 64, 0);
+        int last = std::min(end - i * 64, 64) - 1;
+        m_bits[i] |= mask(last, first);
     }
 }
 
 void
 NetDest::print(std::ostream& out) const
 {
-    out << "[NetDest (" << m_bits.size() << ") ";
+    out << "[NetDest (" << MachineType_NUM << ") ";
 
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            out << (bool) m_bits[i].isElement(j) << " ";
+    for (int i = 0; i < MachineType_NUM; i++) {
+        MachineType machine = MachineType_from_base_level(i);
+        for (int j = 0; j < MachineType_base_count(machine); j++) {
+            MachineID mach = {machine, (NodeID)j};
+            out << (bool) isElement(mach) << " ";
         }
         out << " - ";
     }
@@ -277,12 +294,8 @@ NetDest::print(std::ostream& out) const
 bool
 NetDest::isEqual(const NetDest& n) const
 {
-    assert(m_bits.size() == n.m_bits.size());
-    for (unsigned int i = 0; i < m_bits.size(); ++i) {
-        if (!m_bits[i].isEqual(n.m_bits[i]))
-            return false;
-    }
-    return true;
+    assert(m_nBits == n.m_nBits);
+    return m_bits == n.m_bits;
 }
 
 } // namespace ruby
@@ -41,7 +41,9 @@ namespace gem5
 namespace ruby
 {
 
-// NetDest specifies the network destination of a Message
+// NetDest specifies the network destination of a Message. It holds a
+// bit per machine, packed in 64-bit words in the order of the machine
+// types, so that the set operations work on whole words.
 class NetDest
 {
   public:
@@ -91,7 +93,9 @@ class NetDest
     MachineID smallestElement(MachineType machine) const;
 
     void resize();
-    int getSize() const { return m_bits.size(); }
+
+    // the number of machines of all types
+    int getSize() const { return m_nBits; }
 
     // get element for a index
     NodeID elementAt(MachineID index);
@@ -99,19 +103,25 @@ class NetDest
     void print(std::ostream& out) const;
 
   private:
-    // returns a value >= MachineType_base_level("this machine")
-    // and < MachineType_base_level("next highest machine")
+    // returns the index of the bit of a machine, which is the number of
+    // machines of the lower types plus its number
     int
-    vecIndex(MachineID m) const
+    bitIndex(MachineID m) const
     {
-        int vec_index = MachineType_base_level(m.type);
-        assert(vec_index < m_bits.size());
-        return vec_index;
+        assert(m.num < MachineType_base_count(m.type));
+        int bit_index = MachineType_base_number(m.type) + m.num;
+        assert(bit_index < m_nBits);
+        return bit_index;
     }
 
-    NodeID bitIndex(NodeID index) const { return index; }
+    // returns the index of the first set bit in [begin, end), or end
+    int findFirst(int begin, int end) const;
+
+    // sets the bits in [begin, end)
+    void setRange(int begin, int end);
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    int m_nBits;  // number of bits in use
+    std::vector<uint64_t> m_bits;  // the bits, packed in words
 };
 
 inline std::ostream&
@@ -32,10 +32,12 @@
 #ifndef __MEM_RUBY_COMMON_SET_HH__
 #define __MEM_RUBY_COMMON_SET_HH__
 
-#include <bitset>
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 
+#include "base/bitfield.hh"
 #include "base/logging.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
@@ -47,16 +49,21 @@ namespace ruby
 
 class Set
 {
+  public:
+    // The bits are packed in 64-bit words, the first word holding
+    // elements 0 to 63
+    static constexpr int NumWords = (NUMBER_BITS_PER_SET + 63) / 64;
+
   private:
     // Number of bits in use in this set.
     // can be defined in build_opts file (default=64).
     int m_nSize;
-    std::bitset<NUMBER_BITS_PER_SET> bits;
+    std::array<uint64_t, NumWords> bits;
 
   public:
-    Set() : m_nSize(0) {}
+    Set() : m_nSize(0), bits{} {}
 
-    Set(int size) : m_nSize(size)
+    Set(int size) : m_nSize(size), bits{}
     {
         if (size > NUMBER_BITS_PER_SET)
             fatal("Number of bits(%d) < size specified(%d). "
@@ -77,7 +84,8 @@ class Set
     void
     add(NodeID index)
     {
-        bits.set(index);
+        assert(index < NUMBER_BITS_PER_SET);
+        bits[index / 64] |= 1ULL << (index % 64);
     }
 
     /*
@@ -88,7 +96,8 @@ class Set
     addSet(const Set& obj)
     {
         assert(m_nSize == obj.m_nSize);
-        bits |= obj.bits;
+        for (int i = 0; i < NumWords; i++)
+            bits[i] |= obj.bits[i];
     }
 
     /*
@@ -97,7 +106,8 @@ class Set
     void
     remove(NodeID index)
     {
-        bits.reset(index);
+        assert(index < NUMBER_BITS_PER_SET);
+        bits[index / 64] &= ~(1ULL << (index % 64));
     }
 
     /*
@@ -107,26 +117,35 @@ class Set
     removeSet(const Set& obj)
     {
         assert(m_nSize == obj.m_nSize);
-        bits &= (~obj.bits);
+        for (int i = 0; i < NumWords; i++)
+            bits[i] &= ~obj.bits[i];
     }
 
-    void clear() { bits.reset(); }
+    void clear() { bits.fill(0); }
 
     /*
      * this function sets all bits in the set
      */
     void broadcast()
     {
-        bits.set();
-        for (int j = m_nSize; j < NUMBER_BITS_PER_SET; ++j) {
-            bits.reset(j);
+        for (int i = 0; i < NumWords; i++) {
+            const int first = i * 64;
+            bits[i] = m_nSize >= first + 64 ? ~0ULL :
+                m_nSize > first ? mask(m_nSize - first) : 0;
         }
     }
 
     /*
      * This function returns the population count of 1's in the set
      */
-    int count() const { return bits.count(); }
+    int
+    count() const
+    {
+        int counter = 0;
+        for (int i = 0; i < NumWords; i++)
+            counter += popCount(bits[i]);
+        return counter;
+    }
 
     /*
      * This function checks for set equality
@@ -143,8 +162,8 @@ class Set
     OR(const Set& obj) const
     {
         assert(m_nSize == obj.m_nSize);
-        Set r(m_nSize);
-        r.bits = bits | obj.bits;
+        Set r(*this);
+        r.addSet(obj);
         return r;
     };
 
@@ -154,7 +173,8 @@ class Set
     {
         assert(m_nSize == obj.m_nSize);
         Set r(m_nSize);
-        r.bits = bits & obj.bits;
+        for (int i = 0; i < NumWords; i++)
+            r.bits[i] = bits[i] & obj.bits[i];
         return r;
     }
 
@@ -162,8 +182,10 @@ class Set
     bool
     intersectionIsEmpty(const Set& obj) const
     {
-        std::bitset<NUMBER_BITS_PER_SET> r = bits & obj.bits;
-        return r.none();
+        uint64_t r = 0;
+        for (int i = 0; i < NumWords; i++)
+            r |= bits[i] & obj.bits[i];
+        return r == 0;
     }
 
     /*
@@ -174,13 +196,20 @@ class Set
     isSuperset(const Set& test) const
     {
         assert(m_nSize == test.m_nSize);
-        std::bitset<NUMBER_BITS_PER_SET> r = bits | test.bits;
-        return (r == bits);
+        uint64_t r = 0;
+        for (int i = 0; i < NumWords; i++)
+            r |= test.bits[i] & ~bits[i];
+        return r == 0;
     }
 
     bool isSubset(const Set& test) const { return test.isSuperset(*this); }
 
-    bool isElement(NodeID element) const { return bits.test(element); }
+    bool
+    isElement(NodeID element) const
+    {
+        assert(element < NUMBER_BITS_PER_SET);
+        return (bits[element / 64] >> (element % 64)) & 1;
+    }
 
     /*
      * this function returns true iff all bits in use are set
@@ -188,22 +217,32 @@ class Set
     bool
     isBroadcast() const
     {
-        return (bits.count() == m_nSize);
+        return (count() == m_nSize);
     }
 
-    bool isEmpty() const { return bits.none(); }
+    bool
+    isEmpty() const
+    {
+        uint64_t r = 0;
+        for (int i = 0; i < NumWords; i++)
+            r |= bits[i];
+        return r == 0;
+    }
 
     NodeID smallestElement() const
     {
-        for (int i = 0; i < m_nSize; ++i) {
-            if (bits.test(i)) {
-                return i;
+        for (int i = 0; i < NumWords; i++) {
+            if (bits[i]) {
+                NodeID element = i * 64 + findLsbSet(bits[i]);
+                if (element < m_nSize)
+                    return element;
+                break;
             }
         }
         panic("No smallest element of an empty set.");
     }
 
-    bool elementAt(int index) const { return bits[index]; }
+    bool elementAt(int index) const { return isElement(index); }
 
     int getSize() const { return m_nSize; }
 
@@ -215,12 +254,16 @@ class Set
                   "Increase the number of bits and recompile.\n",
                   NUMBER_BITS_PER_SET, size);
         m_nSize = size;
-        bits.reset();
+        clear();
     }
 
     void print(std::ostream& out) const
     {
-        out << "[Set (" << m_nSize << "): " << bits << "]";
+        // Print the bits from the highest one, as std::bitset does
+        out << "[Set (" << m_nSize << "): ";
+        for (int i = NUMBER_BITS_PER_SET - 1; i >= 0; i--)
+            out << (isElement(i) ? '1' : '0');
+        out << "]";
     }
 };
 
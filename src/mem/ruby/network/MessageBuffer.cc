@@ -86,6 +86,7 @@ MessageBuffer::MessageBuffer(const Params &p)
 {
     m_msg_counter = 0;
     m_consumer = NULL;
+    m_consumer_port = -1;
     m_size_last_time_size_checked = 0;
     m_size_at_cycle_start = 0;
     m_stalled_at_cycle_start = 0;
@@ -280,6 +281,7 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     // Insert the message into the priority heap
     m_prio_heap.push_back(message);
     push_heap(m_prio_heap.begin(), m_prio_heap.end(), std::greater<MsgPtr>());
+    updateConsumerPort();
     // Increment the number of messages statistic
     m_buf_msgs++;
 
@@ -320,6 +322,7 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
 
     pop_heap(m_prio_heap.begin(), m_prio_heap.end(), std::greater<MsgPtr>());
     m_prio_heap.pop_back();
+    updateConsumerPort();
     if (decrement_messages) {
         // Record how much time is passed since the message was enqueued
         m_stall_time += curTick() - message->getLastEnqueueTime();
@@ -354,6 +357,7 @@ void
 MessageBuffer::clear()
 {
     m_prio_heap.clear();
+    updateConsumerPort();
 
     m_msg_counter = 0;
     m_time_last_time_enqueue = 0;
@@ -389,6 +393,7 @@ MessageBuffer::reanalyzeList(std::list<MsgPtr> &lt, Tick schdTick)
         m_prio_heap.push_back(m);
         push_heap(m_prio_heap.begin(), m_prio_heap.end(),
                   std::greater<MsgPtr>());
+        updateConsumerPort();
 
         m_consumer->scheduleEventAbsolute(schdTick);
 
@@ -102,7 +102,15 @@ class MessageBuffer : public SimObject
     bool areNSlotsAvailable(unsigned int n, Tick curTime);
     int getPriority() { return m_priority_rank; }
     void setPriority(int rank) { m_priority_rank = rank; }
-    void setConsumer(Consumer* consumer)
+
+    /**
+     * Connect the buffer to its consumer.
+     *
+     * @param consumer The consumer to wake up when messages arrive
+     * @param port Input port of the consumer whose ready state the
+     *        buffer maintains, or -1 not to maintain one
+     */
+    void setConsumer(Consumer* consumer, int port = -1)
     {
         DPRINTF(RubyQueue, "Setting consumer: %s\n", *consumer);
         if (m_consumer != NULL) {
@@ -111,6 +119,8 @@ class MessageBuffer : public SimObject
                   *consumer, *this, *m_consumer);
         }
         m_consumer = consumer;
+        m_consumer_port = port;
+        updateConsumerPort();
     }
 
     Consumer* getConsumer() { return m_consumer; }
@@ -195,12 +205,22 @@ class MessageBuffer : public SimObject
   private:
     void reanalyzeList(std::list<MsgPtr> &, Tick);
 
+    // Tell the consumer whether the buffer of its port is non-empty
+    void
+    updateConsumerPort()
+    {
+        if (m_consumer_port >= 0)
+            m_consumer->setPortNonEmpty(m_consumer_port, !m_prio_heap.empty());
+    }
+
     uint32_t functionalAccess(Packet *pkt, bool is_read, WriteMask *mask);
 
   private:
     // Data Members (m_ prefix)
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
+    //! Input port of the consumer the buffer is connected to, or -1
+    int m_consumer_port;
     std::vector<MsgPtr> m_prio_heap;
 
     std::function<void()> m_dequeue_callback;
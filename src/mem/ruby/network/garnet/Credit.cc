@@ -29,6 +29,8 @@
 
 #include "mem/ruby/network/garnet/Credit.hh"
 
+#include <cassert>
+
 #include "base/trace.hh"
 #include "debug/RubyNetwork.hh"
 
@@ -45,8 +47,30 @@ namespace garnet
 // Carries m_vc (inherits from flit.hh)
 // and m_is_free_signal (whether VC is free or not)
 
+thread_local void *Credit::freeCredits = nullptr;
+
+void *
+Credit::operator new(std::size_t size)
+{
+    assert(size == sizeof(Credit));
+    void *ptr = freeCredits;
+    if (!ptr)
+        return ::operator new(size);
+
+    freeCredits = *static_cast<void **>(ptr);
+    return ptr;
+}
+
+void
+Credit::operator delete(void *ptr, std::size_t size)
+{
+    assert(size == sizeof(Credit));
+    *static_cast<void **>(ptr) = freeCredits;
+    freeCredits = ptr;
+}
+
 Credit::Credit(int vc, bool is_free_signal, Tick curTime)
-    : flit(0, 0, vc, 0, RouteInfo(), 0, nullptr, 0, 0, curTime)
+    : flit(0, 0, vc, 0, nullptr, 0, nullptr, 0, 0, curTime)
 {
     m_is_free_signal = is_free_signal;
     m_type = CREDIT_;
@@ -32,6 +32,7 @@
 #define __MEM_RUBY_NETWORK_GARNET_0_CREDIT_HH__
 
 #include <cassert>
+#include <cstddef>
 #include <iostream>
 
 #include "base/types.hh"
@@ -64,10 +65,17 @@ class Credit : public flit
 
     ~Credit() {};
 
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr, std::size_t size);
+
     bool is_free_signal() { return m_is_free_signal; }
 
   private:
     bool m_is_free_signal;
+
+    // The destroyed credits of the thread, each one holding a pointer to
+    // the next
+    static thread_local void *freeCredits;
 };
 
 } // namespace garnet
@@ -46,7 +46,7 @@ namespace garnet
 
 CrossbarSwitch::CrossbarSwitch(Router *router)
   : Consumer(router), m_router(router), m_num_vcs(m_router->get_num_vcs()),
-    m_crossbar_activity(0), switchBuffers(0)
+    m_crossbar_activity(0), switchBuffers(0), m_num_pending_flits(0)
 {
 }
 
@@ -86,6 +86,7 @@ CrossbarSwitch::wakeup()
             // in the next cycle
             m_router->getOutputUnit(outport)->insert_flit(t_flit);
             switch_buffer.getTopFlit();
+            m_num_pending_flits--;
             m_crossbar_activity++;
         }
     }
@@ -63,8 +63,11 @@ class CrossbarSwitch : public Consumer
     update_sw_winner(int inport, flit *t_flit)
     {
         switchBuffers[inport].insert(t_flit);
+        m_num_pending_flits++;
     }
 
+    inline bool has_pending_flits() const { return m_num_pending_flits > 0; }
+
     inline double get_crossbar_activity() { return m_crossbar_activity; }
 
     uint32_t functionalWrite(Packet *pkt);
@@ -75,6 +78,8 @@ class CrossbarSwitch : public Consumer
     int m_num_vcs;
     double m_crossbar_activity;
     std::vector<flitBuffer> switchBuffers;
+    // Number of flits that won SA and wait in the switch buffers
+    int m_num_pending_flits;
 };
 
 } // namespace garnet
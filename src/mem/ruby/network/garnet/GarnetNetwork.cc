@@ -592,7 +592,7 @@ GarnetNetwork::print(std::ostream& out) const
 }
 
 void
-GarnetNetwork::update_traffic_distribution(RouteInfo route)
+GarnetNetwork::update_traffic_distribution(const RouteInfo &route)
 {
     int src_node = route.src_router;
     int dest_node = route.dest_router;
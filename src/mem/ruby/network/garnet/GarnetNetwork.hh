@@ -152,7 +152,7 @@ class GarnetNetwork : public Network
         m_total_hops += hops;
     }
 
-    void update_traffic_distribution(RouteInfo route);
+    void update_traffic_distribution(const RouteInfo &route);
     int getNextPacketID() { return m_next_packet_id++; }
 
   protected:
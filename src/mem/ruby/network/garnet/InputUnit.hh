@@ -66,15 +66,28 @@ class InputUnit : public Consumer
     inline void
     set_vc_idle(int vc, Tick curTime)
     {
+        assert(m_num_active_vcs > 0);
+        m_num_active_vcs--;
         virtualChannels[vc].set_idle(curTime);
     }
 
     inline void
     set_vc_active(int vc, Tick curTime)
     {
+        m_num_active_vcs++;
         virtualChannels[vc].set_active(curTime);
     }
 
+    // A VC holds flits only while it is active, so an input port without
+    // active VCs has nothing to offer to switch allocation.
+    inline bool has_active_vcs() const { return m_num_active_vcs > 0; }
+
+    inline bool
+    has_incoming_flit(Tick curTime)
+    {
+        return m_in_link->isReady(curTime);
+    }
+
     inline void
     grant_outport(int vc, int outport)
     {
@@ -166,6 +179,7 @@ class InputUnit : public Consumer
 
     // Input Virtual channels
     std::vector<VirtualChannel> virtualChannels;
+    int m_num_active_vcs;
 
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
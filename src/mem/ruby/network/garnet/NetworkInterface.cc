@@ -34,6 +34,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <memory>
 
 #include "base/cast.hh"
 #include "debug/RubyNetwork.hh"
@@ -174,7 +175,7 @@ NetworkInterface::incrementStats(flit *t_flit)
     }
 
     // Hops
-    m_net_ptr->increment_total_hops(t_flit->get_route().hops_traversed);
+    m_net_ptr->increment_total_hops(t_flit->get_hops());
 }
 
 /*
@@ -422,20 +423,21 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         // NetDest format is used by the routing table
         // Custom routing algorithms just need destID
 
-        RouteInfo route;
-        route.vnet = vnet;
-        route.net_dest = new_net_msg_ptr->getDestination();
-        route.src_ni = m_id;
-        route.src_router = oPort->routerID();
-        route.dest_ni = destID;
-        route.dest_router = m_net_ptr->get_router_id(destID, vnet);
+        // The route is shared by all the flits of the packet
+        auto route = std::make_shared<RouteInfo>();
+        route->vnet = vnet;
+        route->net_dest = new_net_msg_ptr->getDestination();
+        route->src_ni = m_id;
+        route->src_router = oPort->routerID();
+        route->dest_ni = destID;
+        route->dest_router = m_net_ptr->get_router_id(destID, vnet);
 
         // initialize hops_traversed to -1
         // so that the first router increments it to 0
-        route.hops_traversed = -1;
+        route->hops_traversed = -1;
 
         m_net_ptr->increment_injected_packets(vnet);
-        m_net_ptr->update_traffic_distribution(route);
+        m_net_ptr->update_traffic_distribution(*route);
         int packet_id = m_net_ptr->getNextPacketID();
         for (int i = 0; i < num_flits; i++) {
             m_net_ptr->increment_injected_flits(vnet);
@@ -129,6 +129,12 @@ OutputUnit::select_free_vc(int vnet)
  * the output VC is marked IDLE.
  */
 
+bool
+OutputUnit::has_incoming_credit(Tick curTime)
+{
+    return m_credit_link->isReady(curTime);
+}
+
 void
 OutputUnit::wakeup()
 {
@@ -62,6 +62,7 @@ class OutputUnit : public Consumer
     void set_out_link(NetworkLink *link);
     void set_credit_link(CreditLink *credit_link);
     void wakeup();
+    bool has_incoming_credit(Tick curTime);
     flitBuffer* getOutQueue();
     void print(std::ostream& out) const {};
     void decrement_credit(int out_vc);
@@ -74,9 +74,18 @@ Router::wakeup()
     DPRINTF(RubyNetwork, "Router %d woke up\n", m_id);
     assert(clockEdge() == curTick());
 
+    // Only the units with work this cycle are evaluated. A wakeup is
+    // useful if it moved a flit or a credit.
+    bool useful = false;
+    bool has_packets = false;
+
     // check for incoming flits
     for (int inport = 0; inport < m_input_unit.size(); inport++) {
-        m_input_unit[inport]->wakeup();
+        if (m_input_unit[inport]->has_incoming_flit(curTick())) {
+            m_input_unit[inport]->wakeup();
+            useful = true;
+        }
+        has_packets |= m_input_unit[inport]->has_active_vcs();
     }
 
     // check for incoming credits
@@ -86,14 +95,27 @@ Router::wakeup()
     // if we want the credit update to take place after SA, this loop should
     // be moved after the SA request
     for (int outport = 0; outport < m_output_unit.size(); outport++) {
-        m_output_unit[outport]->wakeup();
+        if (m_output_unit[outport]->has_incoming_credit(curTick())) {
+            m_output_unit[outport]->wakeup();
+            useful = true;
+        }
     }
 
     // Switch Allocation
-    switchAllocator.wakeup();
+    if (has_packets)
+        switchAllocator.wakeup();
 
     // Switch Traversal
-    crossbarSwitch.wakeup();
+    // Flits granted by SA traverse the switch in the same cycle
+    if (crossbarSwitch.has_pending_flits()) {
+        crossbarSwitch.wakeup();
+        useful = true;
+    }
+
+    if (useful)
+        m_useful_wakeups++;
+    else
+        m_empty_wakeups++;
 }
 
 void
@@ -159,7 +181,8 @@ Router::getInportDirection(int inport)
 }
 
 int
-Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn)
+Router::route_compute(const RouteInfo &route, int inport,
+                      PortDirection inport_dirn)
 {
     return routingUnit.outportCompute(route, inport, inport_dirn);
 }
@@ -216,6 +239,18 @@ Router::regStats()
         .name(name() + ".sw_output_arbiter_activity")
         .flags(statistics::nozero)
     ;
+
+    m_useful_wakeups
+        .name(name() + ".useful_wakeups")
+        .desc("Number of wakeups that moved a flit or a credit")
+        .flags(statistics::nozero)
+    ;
+
+    m_empty_wakeups
+        .name(name() + ".empty_wakeups")
+        .desc("Number of wakeups without any flit or credit to move")
+        .flags(statistics::nozero)
+    ;
 }
 
 void
@@ -94,7 +94,7 @@ RoutingUnit::supportsVnet(int vnet, std::vector<int> sVnets)
  * Correct weight assignments are critical to provide deadlock avoidance.
  */
 int
-RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
+RoutingUnit::lookupRoutingTable(int vnet, const NetDest &msg_destination)
 {
     // First find all possible output link candidates
     // For ordered vnet, just choose the first
@@ -166,7 +166,7 @@ RoutingUnit::addOutDirection(PortDirection outport_dirn, int outport_idx)
 // table is provided here.
 
 int
-RoutingUnit::outportCompute(RouteInfo route, int inport,
+RoutingUnit::outportCompute(const RouteInfo &route, int inport,
                             PortDirection inport_dirn)
 {
     int outport = -1;
@@ -205,7 +205,7 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
 // Only for reference purpose in a Mesh
 // By default Garnet uses the routing table
 int
-RoutingUnit::outportComputeXY(RouteInfo route,
+RoutingUnit::outportComputeXY(const RouteInfo &route,
                               int inport,
                               PortDirection inport_dirn)
 {
@@ -263,7 +263,7 @@ RoutingUnit::outportComputeXY(RouteInfo route,
 // Template for implementing custom routing algorithm
 // using port directions. (Example adaptive)
 int
-RoutingUnit::outportComputeCustom(RouteInfo route,
+RoutingUnit::outportComputeCustom(const RouteInfo &route,
                                  int inport,
                                  PortDirection inport_dirn)
 {
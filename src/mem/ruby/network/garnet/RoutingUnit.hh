@@ -53,7 +53,7 @@ class RoutingUnit
 {
   public:
     RoutingUnit(Router *router);
-    int outportCompute(RouteInfo route,
+    int outportCompute(const RouteInfo &route,
                       int inport,
                       PortDirection inport_dirn);
 
@@ -62,19 +62,19 @@ class RoutingUnit
     void addWeight(int link_weight);
 
     // get output port from routing table
-    int  lookupRoutingTable(int vnet, NetDest net_dest);
+    int  lookupRoutingTable(int vnet, const NetDest &net_dest);
 
     // Topology-specific direction based routing
     void addInDirection(PortDirection inport_dirn, int inport);
     void addOutDirection(PortDirection outport_dirn, int outport);
 
     // Routing for Mesh
-    int outportComputeXY(RouteInfo route,
+    int outportComputeXY(const RouteInfo &route,
                          int inport,
                          PortDirection inport_dirn);
 
     // Custom Routing Algorithm using Port Directions
-    int outportComputeCustom(RouteInfo route,
+    int outportComputeCustom(const RouteInfo &route,
                              int inport,
                              PortDirection inport_dirn);
 
@@ -55,6 +55,7 @@ SwitchAllocator::SwitchAllocator(Router *router)
 
     m_input_arbiter_activity = 0;
     m_output_arbiter_activity = 0;
+    m_num_requests = 0;
 }
 
 void
@@ -85,15 +86,19 @@ SwitchAllocator::init()
  * There is no separate VCAllocator stage like the one in garnet1.0.
  * At the end of this function, the router is rescheduled to wakeup
  * next cycle for peforming SA for any flits ready next cycle.
+ * The second stage is skipped if no input port placed a request.
  */
 
 void
 SwitchAllocator::wakeup()
 {
     arbitrate_inports(); // First stage of allocation
-    arbitrate_outports(); // Second stage of allocation
 
-    clear_request_vector();
+    if (m_num_requests > 0) {
+        arbitrate_outports(); // Second stage of allocation
+        clear_request_vector();
+    }
+
     check_for_wakeup();
 }
 
@@ -110,14 +115,20 @@ SwitchAllocator::wakeup()
 void
 SwitchAllocator::arbitrate_inports()
 {
+    m_num_requests = 0;
+
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
     for (int inport = 0; inport < m_num_inports; inport++) {
+        auto input_unit = m_router->getInputUnit(inport);
+
+        // Input ports without packets cannot place a request
+        if (!input_unit->has_active_vcs())
+            continue;
+
         int invc = m_round_robin_invc[inport];
 
         for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
-            auto input_unit = m_router->getInputUnit(inport);
-
             if (input_unit->need_stage(invc, SA_, curTick())) {
                 // This flit is in SA stage
 
@@ -131,6 +142,7 @@ SwitchAllocator::arbitrate_inports()
 
                 if (make_request) {
                     m_input_arbiter_activity++;
+                    m_num_requests++;
                     m_port_requests[inport] = outport;
                     m_vc_winners[inport] = invc;
 
@@ -363,8 +375,12 @@ SwitchAllocator::check_for_wakeup()
     }
 
     for (int i = 0; i < m_num_inports; i++) {
+        auto input_unit = m_router->getInputUnit(i);
+        if (!input_unit->has_active_vcs())
+            continue;
+
         for (int j = 0; j < m_num_vcs; j++) {
-            if (m_router->getInputUnit(i)->need_stage(j, SA_, nextCycle)) {
+            if (input_unit->need_stage(j, SA_, nextCycle)) {
                 m_router->schedule_wakeup(Cycles(1));
                 return;
             }
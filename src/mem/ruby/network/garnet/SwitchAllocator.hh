@@ -85,6 +85,9 @@ class SwitchAllocator : public Consumer
 
     double m_input_arbiter_activity, m_output_arbiter_activity;
 
+    // Number of input ports that placed a request during SA-I
+    int m_num_requests;
+
     Router *m_router;
     std::vector<int> m_round_robin_invc;
     std::vector<int> m_round_robin_inport;
@@ -30,6 +30,8 @@
 
 #include "mem/ruby/network/garnet/flit.hh"
 
+#include <cassert>
+
 #include "base/intmath.hh"
 #include "debug/RubyNetwork.hh"
 
@@ -42,8 +44,31 @@ namespace ruby
 namespace garnet
 {
 
+thread_local void *flit::freeFlits = nullptr;
+
+void *
+flit::operator new(std::size_t size)
+{
+    assert(size == sizeof(flit));
+    void *ptr = freeFlits;
+    if (!ptr)
+        return ::operator new(size);
+
+    freeFlits = *static_cast<void **>(ptr);
+    return ptr;
+}
+
+void
+flit::operator delete(void *ptr, std::size_t size)
+{
+    assert(size == sizeof(flit));
+    *static_cast<void **>(ptr) = freeFlits;
+    freeFlits = ptr;
+}
+
 // Constructor for the flit
-flit::flit(int packet_id, int id, int  vc, int vnet, RouteInfo route, int size,
+flit::flit(int packet_id, int id, int  vc, int vnet,
+    std::shared_ptr<const RouteInfo> route, int size,
     MsgPtr msg_ptr, int MsgSize, uint32_t bWidth, Tick curTime)
 {
     m_size = size;
@@ -55,7 +80,8 @@ flit::flit(int packet_id, int id, int  vc, int vnet, RouteInfo route, int size,
     m_id = id;
     m_vnet = vnet;
     m_vc = vc;
-    m_route = route;
+    m_route = std::move(route);
+    m_hops_traversed = m_route ? m_route->hops_traversed : 0;
     m_stage.first = I_;
     m_stage.second = curTime;
     m_width = bWidth;
@@ -87,6 +113,7 @@ flit::serialize(int ser_id, int parts, uint32_t bWidth)
                     new_size, m_msg_ptr, msgSize, bWidth, m_time);
     fl->set_enqueue_time(m_enqueue_time);
     fl->set_src_delay(src_delay);
+    fl->m_hops_traversed = m_hops_traversed;
     return fl;
 }
 
@@ -102,6 +129,7 @@ flit::deserialize(int des_id, int num_flits, uint32_t bWidth)
                     new_size, m_msg_ptr, msgSize, bWidth, m_time);
     fl->set_enqueue_time(m_enqueue_time);
     fl->set_src_delay(src_delay);
+    fl->m_hops_traversed = m_hops_traversed;
     return fl;
 }
 
@@ -116,10 +144,10 @@ flit::print(std::ostream& out) const
     out << "Size=" << m_size << " ";
     out << "Vnet=" << m_vnet << " ";
     out << "VC=" << m_vc << " ";
-    out << "Src NI=" << m_route.src_ni << " ";
-    out << "Src Router=" << m_route.src_router << " ";
-    out << "Dest NI=" << m_route.dest_ni << " ";
-    out << "Dest Router=" << m_route.dest_router << " ";
+    out << "Src NI=" << m_route->src_ni << " ";
+    out << "Src Router=" << m_route->src_router << " ";
+    out << "Dest NI=" << m_route->dest_ni << " ";
+    out << "Dest Router=" << m_route->dest_router << " ";
     out << "Set Time=" << m_time << " ";
     out << "Width=" << m_width<< " ";
     out << "]";
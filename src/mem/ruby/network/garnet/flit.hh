@@ -32,7 +32,9 @@
 #define __MEM_RUBY_NETWORK_GARNET_0_FLIT_HH__
 
 #include <cassert>
+#include <cstddef>
 #include <iostream>
+#include <memory>
 
 #include "base/types.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
@@ -47,15 +49,25 @@ namespace ruby
 namespace garnet
 {
 
+/*
+ * The route of a packet is shared by all its flits, and only the number
+ * of hops traversed is tracked per flit. Flits and credits are created
+ * and destroyed at a high rate, so their storage is recycled through a
+ * free list of each class instead of going back to the heap.
+ */
 class flit
 {
   public:
     flit() {}
-    flit(int packet_id, int id, int vc, int vnet, RouteInfo route, int size,
+    flit(int packet_id, int id, int vc, int vnet,
+         std::shared_ptr<const RouteInfo> route, int size,
          MsgPtr msg_ptr, int MsgSize, uint32_t bWidth, Tick curTime);
 
     virtual ~flit(){};
 
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr, std::size_t size);
+
     int get_outport() {return m_outport; }
     int get_size() { return m_size; }
     Tick get_enqueue_time() { return m_enqueue_time; }
@@ -65,7 +77,8 @@ class flit
     Tick get_time() { return m_time; }
     int get_vnet() { return m_vnet; }
     int get_vc() { return m_vc; }
-    RouteInfo get_route() { return m_route; }
+    const RouteInfo &get_route() { return *m_route; }
+    int get_hops() { return m_hops_traversed; }
     MsgPtr& get_msg_ptr() { return m_msg_ptr; }
     flit_type get_type() { return m_type; }
     std::pair<flit_stage, Tick> get_stage() { return m_stage; }
@@ -74,12 +87,17 @@ class flit
     void set_outport(int port) { m_outport = port; }
     void set_time(Tick time) { m_time = time; }
     void set_vc(int vc) { m_vc = vc; }
-    void set_route(RouteInfo route) { m_route = route; }
+    void
+    set_route(const RouteInfo &route)
+    {
+        m_route = std::make_shared<const RouteInfo>(route);
+        m_hops_traversed = route.hops_traversed;
+    }
     void set_src_delay(Tick delay) { src_delay = delay; }
     void set_dequeue_time(Tick time) { m_dequeue_time = time; }
     void set_enqueue_time(Tick time) { m_enqueue_time = time; }
 
-    void increment_hops() { m_route.hops_traversed++; }
+    void increment_hops() { m_hops_traversed++; }
     virtual void print(std::ostream& out) const;
 
     bool
@@ -119,7 +137,8 @@ class flit
     int m_id;
     int m_vnet;
     int m_vc;
-    RouteInfo m_route;
+    std::shared_ptr<const RouteInfo> m_route;
+    int m_hops_traversed;
     int m_size;
     Tick m_enqueue_time, m_dequeue_time;
     Tick m_time;
@@ -128,6 +147,11 @@ class flit
     int m_outport;
     Tick src_delay;
     std::pair<flit_stage, Tick> m_stage;
+
+  private:
+    // The destroyed flits of the thread, each one holding a pointer to
+    // the next
+    static thread_local void *freeFlits;
 };
 
 inline std::ostream&
@@ -120,7 +120,14 @@ ProfilerStats::ProfilerStats(statistics::Group *parent, Profiler *profiler)
       ADD_STAT(m_latencyHistCoalsr, ""),
       ADD_STAT(m_hitLatencyHistSeqr, ""),
       ADD_STAT(m_missLatencyHistSeqr, ""),
-      ADD_STAT(m_missLatencyHistCoalsr, "")
+      ADD_STAT(m_missLatencyHistCoalsr, ""),
+      ADD_STAT(dataBlockSharedCopies, statistics::units::Count::get(),
+               "Number of data block copies sharing the copied line"),
+      ADD_STAT(dataBlockCopiesOnWrite, statistics::units::Count::get(),
+               "Number of shared lines copied when a block was modified"),
+      ADD_STAT(dataBlockCopiesAvoided, statistics::units::Count::get(),
+               "Number of data block copies that never copied the line",
+               dataBlockSharedCopies - dataBlockCopiesOnWrite)
 {
     delayHistogram
         .init(10)
@@ -566,6 +573,18 @@ Profiler::collateStats()
 #endif
         }
     }
+
+    // The data block copies are counted since the last collation
+    rubyProfilerStats.dataBlockSharedCopies += m_data_block_copies.shared;
+    rubyProfilerStats.dataBlockCopiesOnWrite +=
+        m_data_block_copies.copiedOnWrite;
+    m_data_block_copies = DataBlock::CopyCounts();
+}
+
+void
+Profiler::resetStats()
+{
+    m_data_block_copies = DataBlock::CopyCounts();
 }
 
 void
@@ -52,6 +52,7 @@
 
 #include "base/callback.hh"
 #include "base/statistics.hh"
+#include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/common/MachineID.hh"
 #include "mem/ruby/protocol/AccessType.hh"
 #include "mem/ruby/protocol/PrefetchBit.hh"
@@ -79,6 +80,15 @@ class Profiler
     void wakeup();
     void regStats();
     void collateStats();
+    void resetStats();
+
+    // Counts of the data block copies made by the controllers since the
+    // last collation
+    DataBlock::CopyCounts *
+    getDataBlockCopies()
+    {
+        return &m_data_block_copies;
+    }
 
     AddressProfiler* getAddressProfiler() { return m_address_profiler_ptr; }
     AddressProfiler* getInstructionProfiler() { return m_inst_profiler_ptr; }
@@ -97,6 +107,8 @@ class Profiler
     AddressProfiler* m_address_profiler_ptr;
     AddressProfiler* m_inst_profiler_ptr;
 
+    DataBlock::CopyCounts m_data_block_copies;
+
     struct ProfilerStats : public statistics::Group
     {
         ProfilerStats(statistics::Group *parent, Profiler *profiler);
@@ -187,6 +199,12 @@ class Profiler
         //! miss in the controller connected to this sequencer.
         statistics::Histogram m_missLatencyHistSeqr;
         statistics::Histogram m_missLatencyHistCoalsr;
+
+        //! Copies of data blocks that shared the line of the copied
+        //! block, and the ones that copied it later on a write.
+        statistics::Scalar dataBlockSharedCopies;
+        statistics::Scalar dataBlockCopiesOnWrite;
+        statistics::Formula dataBlockCopiesAvoided;
     };
 
     //added by SS
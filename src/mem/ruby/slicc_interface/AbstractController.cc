@@ -56,12 +56,13 @@ namespace ruby
 AbstractController::AbstractController(const Params &p)
     : ClockedObject(p), Consumer(this), m_version(p.version),
       m_clusterID(p.cluster_id),
-      m_id(p.system->getRequestorId(this)), m_is_blocking(false),
+      m_id(p.system->getRequestorId(this)), m_ruby_system(p.ruby_system),
+      m_is_blocking(false),
       m_number_of_TBEs(p.number_of_TBEs),
       m_transitions_per_cycle(p.transitions_per_cycle),
       m_buffer_size(p.buffer_size), m_recycle_latency(p.recycle_latency),
       m_mandatory_queue_latency(p.mandatory_queue_latency),
-      m_waiting_mem_retry(false),
+      m_waiting_mem_retry(false), m_track_line_holders(false),
       memoryPort(csprintf("%s.memory", name()), this),
       addrRanges(p.addr_ranges.begin(), p.addr_ranges.end()),
       stats(this)
@@ -133,6 +134,37 @@ AbstractController::regStats()
     ClockedObject::regStats();
 }
 
+void
+AbstractController::directWarmup(Addr addr, const MachineID &requestor,
+                                 RubyRequestType type, const DataBlock &data)
+{
+    warmupLine(addr, requestor, type, data);
+
+    // The line didn't go through a transition, so keep the index of line
+    // holders up to date here.
+    if (m_track_line_holders)
+        updateLineHolder(addr, getAccessPermission(addr));
+}
+
+void
+AbstractController::updateLineHolder(Addr addr, AccessPermission perm)
+{
+    if (perm != AccessPermission_Invalid &&
+        perm != AccessPermission_NotPresent) {
+        m_ruby_system->addLineHolder(addr, this);
+        return;
+    }
+
+    // The state alone doesn't tell whether the protocol still exposes the
+    // line through some other structure, so only drop it once the
+    // controller itself reports it as invalid.
+    perm = getAccessPermission(addr);
+    if (perm == AccessPermission_Invalid ||
+        perm == AccessPermission_NotPresent) {
+        m_ruby_system->removeLineHolder(addr, this);
+    }
+}
+
 void
 AbstractController::profileMsgDelay(uint32_t virtualNetwork, Cycles delay)
 {
@@ -407,6 +439,12 @@ AbstractController::recvAtomic(PacketPtr pkt)
    return ticksToCycles(memoryPort.sendAtomic(pkt));
 }
 
+Tick
+AbstractController::recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor)
+{
+   return ticksToCycles(memoryPort.sendAtomicBackdoor(pkt, backdoor));
+}
+
 MachineID
 AbstractController::mapAddressToMachine(Addr addr, MachineType mtype) const
 {
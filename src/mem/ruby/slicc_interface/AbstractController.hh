@@ -43,6 +43,7 @@
 
 #include <exception>
 #include <iostream>
+#include <set>
 #include <string>
 #include <unordered_map>
 
@@ -71,6 +72,7 @@ namespace ruby
 class Network;
 class GPUCoalescer;
 class DMASequencer;
+class RubySystem;
 
 // used to communicate that an in_port peeked the wrong message type
 class RejectException: public std::exception
@@ -108,6 +110,13 @@ class AbstractController : public ClockedObject, public Consumer
     virtual void regStats();
 
     virtual void recordCacheTrace(int cntrl, CacheRecorder* tr) = 0;
+
+    /**
+     * Add to lines the addresses of all the lines the controller holds in a
+     * cache or a TBE, in any state. These are the lines whose most recent
+     * data may not be in memory.
+     */
+    virtual void collectHeldLines(std::set<Addr> &lines) = 0;
     virtual Sequencer* getCPUSequencer() const = 0;
     virtual DMASequencer* getDMASequencer() const = 0;
     virtual GPUCoalescer* getGPUCoalescer() const = 0;
@@ -139,6 +148,20 @@ class AbstractController : public ClockedObject, public Consumer
     virtual int functionalWrite(const Addr &addr, PacketPtr) = 0;
     int functionalMemoryWrite(PacketPtr);
 
+    //! These functions are used by ruby system to restore the contents of
+    //! the caches from a checkpoint without simulating the requests. A
+    //! protocol supports this by defining warmupLine in all of its
+    //! machines, mapping a block recorded in the cache of the requestor to
+    //! the state this controller has to hold for it.
+    virtual bool supportsDirectWarmup() const { return false; }
+    virtual void warmupLine(const Addr &addr, const MachineID &requestor,
+                            const RubyRequestType &type,
+                            const DataBlock &data)
+    { panic("warmupLine(Addr,MachineID,RubyRequestType,DataBlock) "
+            "not implemented"); }
+    void directWarmup(Addr addr, const MachineID &requestor,
+                      RubyRequestType type, const DataBlock &data);
+
     //! Function for enqueuing a prefetch request
     virtual void enqueuePrefetch(const Addr &, const RubyRequestType&)
     { fatal("Prefetches not implemented!");}
@@ -167,6 +190,7 @@ class AbstractController : public ClockedObject, public Consumer
 
     void recvTimingResp(PacketPtr pkt);
     Tick recvAtomic(PacketPtr pkt);
+    Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor);
 
     const AddrRangeList &getAddrRanges() const { return addrRanges; }
 
@@ -178,6 +202,13 @@ class AbstractController : public ClockedObject, public Consumer
     statistics::Histogram& getDelayVCHist(uint32_t index)
     { return *(stats.delayVCHistogram[index]); }
 
+    /**
+     * Whether this controller can only hold a valid copy of the lines it
+     * transitioned on. In that case RubySystem keeps track of the lines the
+     * controller may hold and functional accesses skip it for the others.
+     */
+    bool tracksLineHolders() const { return m_track_line_holders; }
+
     bool respondsTo(Addr addr)
     {
         for (auto &range: addrRanges)
@@ -332,6 +363,14 @@ class AbstractController : public ClockedObject, public Consumer
         m_outTrans.erase(iter);
     }
 
+    /**
+     * Update the RubySystem index of line holders after a transition.
+     *
+     * @param addr address of the line
+     * @param perm access permission of the state the line moved to
+     */
+    void updateLineHolder(Addr addr, AccessPermission perm);
+
     void stallBuffer(MessageBuffer* buf, Addr addr);
     void wakeUpBuffer(MessageBuffer* buf, Addr addr);
     void wakeUpBuffers(Addr addr);
@@ -347,6 +386,7 @@ class AbstractController : public ClockedObject, public Consumer
     // RequestorID used by some components of gem5.
     const RequestorID m_id;
 
+    RubySystem *m_ruby_system;
     Network *m_net_ptr;
     bool m_is_blocking;
     std::map<Addr, MessageBuffer*> m_block_map;
@@ -364,6 +404,7 @@ class AbstractController : public ClockedObject, public Consumer
     Cycles m_recycle_latency;
     const Cycles m_mandatory_queue_latency;
     bool m_waiting_mem_retry;
+    bool m_track_line_holders;
 
     /**
      * Port that forwards requests and receives responses from the
@@ -450,6 +450,17 @@ CacheMemory::recordCacheContents(int cntrl, CacheRecorder* tr) const
             totalBlocks, (float(warmedUpBlocks) / float(totalBlocks)) * 100.0);
 }
 
+void
+CacheMemory::collectLineAddresses(std::set<Addr> &addrs) const
+{
+    for (int i = 0; i < m_cache_num_sets; i++) {
+        for (int j = 0; j < m_cache_assoc; j++) {
+            if (m_cache[i][j] != NULL)
+                addrs.insert(m_cache[i][j]->m_Address);
+        }
+    }
+}
+
 void
 CacheMemory::print(std::ostream& out) const
 {
@@ -42,6 +42,7 @@
 #define __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 
 #include <iostream>
+#include <set>
 #include <unordered_map>
 
 #include "mem/ruby/common/Address.hh"
@@ -73,6 +74,9 @@ class TBETable
     ENTRY *getNullEntry();
     ENTRY *lookup(Addr address);
 
+    // Add the addresses of all the allocated TBEs to addrs
+    void collectAddresses(std::set<Addr> &addrs) const;
+
     // Print cache contents
     void print(std::ostream& out) const;
 
@@ -140,6 +144,13 @@ TBETable<ENTRY>::lookup(Addr address)
   return NULL;
 }
 
+template<class ENTRY>
+inline void
+TBETable<ENTRY>::collectAddresses(std::set<Addr> &addrs) const
+{
+    for (const auto &entry : m_map)
+        addrs.insert(entry.first);
+}
 
 template<class ENTRY>
 inline void
@@ -30,6 +30,7 @@
 #include "mem/ruby/system/CacheRecorder.hh"
 
 #include "debug/RubyCacheTrace.hh"
+#include "mem/ruby/slicc_interface/AbstractController.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
 
@@ -154,6 +155,43 @@ CacheRecorder::enqueueNextFetchRequest()
     }
 }
 
+void
+CacheRecorder::injectCacheContents(
+    const std::vector<AbstractController*> &controllers)
+{
+    uint64_t record_size = sizeof(TraceRecord) + m_block_size_bytes;
+    uint64_t num_records = m_uncompressed_trace_size / record_size;
+    DataBlock data;
+
+    // The trace is sorted from the most to the least recently accessed
+    // block, so go backwards to leave the recent blocks as the MRU ones.
+    for (uint64_t idx = num_records; idx > 0; --idx) {
+        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
+                                                   (idx - 1) * record_size);
+
+        DPRINTF(RubyCacheTrace, "Injecting %s\n", *traceRecord);
+
+        assert(traceRecord->m_cntrl_id < controllers.size());
+        MachineID requestor =
+            controllers[traceRecord->m_cntrl_id]->getMachineID();
+
+        for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
+                rec_bytes_read += RubySystem::getBlockSizeBytes()) {
+            Addr addr = traceRecord->m_data_address + rec_bytes_read;
+            data.setData(traceRecord->m_data + rec_bytes_read, 0,
+                         RubySystem::getBlockSizeBytes());
+
+            for (auto cntrl : controllers) {
+                cntrl->directWarmup(addr, requestor, traceRecord->m_type,
+                                    data);
+            }
+        }
+        m_records_read++;
+    }
+
+    DPRINTF(RubyCacheTrace, "Injected all %d records\n", m_records_read);
+}
+
 void
 CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                          RubyRequestType type, Tick time, DataBlock& data)
@@ -49,6 +49,7 @@ namespace gem5
 namespace ruby
 {
 
+class AbstractController;
 class Sequencer;
 
 /*!
@@ -104,6 +105,17 @@ class CacheRecorder
      */
     void enqueueNextFetchRequest();
 
+    /*!
+     * Function for warming up the caches without simulating any request.
+     * It goes through the recorded contents of the caches, from the least
+     * to the most recently used block, and hands every block to all the
+     * controllers. Each controller then sets up its own state for the block
+     * according to the warmup mapping defined by the protocol. This is only
+     * possible if all the controllers support it.
+     */
+    void injectCacheContents(
+        const std::vector<AbstractController*> &controllers);
+
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
@@ -72,6 +72,7 @@ RubyPort::RubyPort(const Params &p)
       m_isCPUSequencer(p.is_cpu_sequencer)
 {
     assert(m_version != -1);
+    m_ruby_system->registerRubyPort(this);
 
     // create the response ports based on the number of connected ports
     for (size_t i = 0; i < p.port_in_ports_connection_count; ++i) {
@@ -257,6 +258,10 @@ RubyPort::MemResponsePort::recvTimingReq(PacketPtr pkt)
         panic("RubyPort should never see request with the "
               "cacheResponding flag set\n");
 
+    // Anything handed out by any port while in atomic mode is no longer
+    // safe to use once Ruby caches start filling up.
+    ruby_port->m_ruby_system->invalidateBackdoors();
+
     // ruby doesn't support cache maintenance operations at the
     // moment, as a workaround, we respond right away
     if (pkt->req->isCacheMaintenance()) {
@@ -319,6 +324,20 @@ RubyPort::MemResponsePort::recvTimingReq(PacketPtr pkt)
 
 Tick
 RubyPort::MemResponsePort::recvAtomic(PacketPtr pkt)
+{
+    return recvAtomicLogic(pkt, nullptr);
+}
+
+Tick
+RubyPort::MemResponsePort::recvAtomicBackdoor(PacketPtr pkt,
+                                              MemBackdoorPtr &backdoor)
+{
+    return recvAtomicLogic(pkt, &backdoor);
+}
+
+Tick
+RubyPort::MemResponsePort::recvAtomicLogic(PacketPtr pkt,
+                                           MemBackdoorPtr *backdoor)
 {
     RubyPort *ruby_port = static_cast<RubyPort *>(&owner);
     // Only atomic_noncaching mode supported!
@@ -367,9 +386,24 @@ RubyPort::MemResponsePort::recvAtomic(PacketPtr pkt)
                     pkt->getAddr(), (MachineType)mem_interface_type);
     AbstractController *mem_interface =
         rs->m_abstract_controls[mem_interface_type][id.getNum()];
-    Tick latency = mem_interface->recvAtomic(pkt);
-    if (access_backing_store)
+    MemBackdoorPtr mem_backdoor = nullptr;
+    Tick latency;
+    if (backdoor && !access_backing_store)
+        latency = mem_interface->recvAtomicBackdoor(pkt, mem_backdoor);
+    else
+        latency = mem_interface->recvAtomic(pkt);
+    if (access_backing_store) {
         rs->getPhysMem()->access(pkt);
+        if (backdoor)
+            rs->getPhysMem()->getBackdoor(mem_backdoor);
+    }
+
+    // Backdoors only make sense for regular accesses to memory, the rest
+    // (e.g., LL/SC) must keep going through the port.
+    if (backdoor && mem_backdoor && pkt->cmd != MemCmd::MemSyncReq &&
+        !pkt->isLLSC()) {
+        *backdoor = ruby_port->getBackdoor(mem_backdoor, pkt->getAddr());
+    }
     return latency;
 }
 
@@ -521,6 +555,65 @@ RubyPort::ruby_stale_translation_callback(Addr txnId)
     }
 }
 
+MemBackdoorPtr
+RubyPort::getBackdoor(MemBackdoorPtr mem_backdoor, Addr addr)
+{
+    const AddrRange &mem_range = mem_backdoor->range();
+    if (mem_range.interleaved())
+        return nullptr;
+
+    Addr start = mem_range.start();
+    Addr end = mem_range.end();
+    if (!m_ruby_system->getAccessBackingStore()) {
+        const std::set<Addr> &held = m_ruby_system->getHeldLines();
+        Addr line_addr = makeLineAddress(addr);
+        if (held.count(line_addr))
+            return nullptr;
+
+        // Restrict the backdoor to the blocks between the closest held
+        // lines on either side of the accessed one.
+        auto next = held.upper_bound(line_addr);
+        if (next != held.end() && *next < end)
+            end = *next;
+        if (next != held.begin()) {
+            Addr prev = *std::prev(next) + RubySystem::getBlockSizeBytes();
+            if (prev > start)
+                start = prev;
+        }
+    }
+
+    for (const auto &bd : backdoors) {
+        if (bd->range().start() == start && bd->range().end() == end)
+            return bd.get();
+    }
+
+    // Make sure our backdoors go away together with the one they point into.
+    if (memBackdoors.insert(mem_backdoor).second) {
+        mem_backdoor->addInvalidationCallback(
+            [this](const MemBackdoor &backdoor) {
+                memBackdoors.erase(const_cast<MemBackdoorPtr>(&backdoor));
+                invalidateBackdoors();
+            });
+    }
+
+    DPRINTF(RubyPort, "Providing backdoor for [%#x, %#x)\n", start, end);
+    backdoors.emplace_back(new MemBackdoor(AddrRange(start, end),
+        mem_backdoor->ptr() + (start - mem_range.start()),
+        mem_backdoor->flags()));
+    return backdoors.back().get();
+}
+
+void
+RubyPort::invalidateBackdoors()
+{
+    if (!backdoors.empty()) {
+        DPRINTF(RubyPort, "Invalidating %d backdoors\n", backdoors.size());
+        for (auto &bd : backdoors)
+            bd->invalidate();
+        backdoors.clear();
+    }
+}
+
 void
 RubyPort::trySendRetries()
 {
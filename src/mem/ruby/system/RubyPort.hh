@@ -43,8 +43,12 @@
 #define __MEM_RUBY_SYSTEM_RUBYPORT_HH__
 
 #include <cassert>
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
+#include "mem/backdoor.hh"
 #include "mem/ruby/common/MachineID.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/protocol/RequestStatus.hh"
@@ -97,6 +101,8 @@ class RubyPort : public ClockedObject
 
         Tick recvAtomic(PacketPtr pkt);
 
+        Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor);
+
         void recvFunctional(PacketPtr pkt);
 
         AddrRangeList getAddrRanges() const
@@ -105,6 +111,7 @@ class RubyPort : public ClockedObject
         void addToRetryList();
 
       private:
+        Tick recvAtomicLogic(PacketPtr pkt, MemBackdoorPtr *backdoor);
         bool isShadowRomAddress(Addr addr) const;
         bool isPhysMemAddress(PacketPtr pkt) const;
     };
@@ -176,6 +183,12 @@ class RubyPort : public ClockedObject
 
     virtual int functionalWrite(Packet *func_pkt);
 
+    /**
+     * Invalidate all the backdoors handed out by this port. RubySystem does
+     * this for all its ports as soon as any of them sees timing traffic.
+     */
+    void invalidateBackdoors();
+
   protected:
     void trySendRetries();
     void ruby_hit_callback(PacketPtr pkt);
@@ -215,6 +228,20 @@ class RubyPort : public ClockedObject
         retryList.push_back(port);
     }
 
+    /**
+     * Turn a backdoor handed out by the memory behind Ruby into one that
+     * can be given to the requestor. When Ruby does not access the backing
+     * store, the returned backdoor is narrowed down to the region around
+     * addr that contains no line held in a cache or a TBE by any
+     * controller, since accesses through it could otherwise miss the most
+     * recent data.
+     *
+     * @param mem_backdoor Backdoor provided by the memory
+     * @param addr Address of the access that requested the backdoor
+     * @return The backdoor to hand out, or nullptr if there is none
+     */
+    MemBackdoorPtr getBackdoor(MemBackdoorPtr mem_backdoor, Addr addr);
+
     PioRequestPort pioRequestPort;
     PioResponsePort pioResponsePort;
     MemRequestPort memRequestPort;
@@ -231,6 +258,11 @@ class RubyPort : public ClockedObject
     //
     std::vector<MemResponsePort *> retryList;
 
+    /** Backdoors currently handed out to the requestors. */
+    std::vector<std::unique_ptr<MemBackdoor>> backdoors;
+    /** Memory backdoors we installed an invalidation callback on. */
+    std::set<MemBackdoorPtr> memBackdoors;
+
     bool m_isCPUSequencer;
 };
 
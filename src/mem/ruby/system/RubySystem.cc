@@ -43,6 +43,7 @@
 #include <fcntl.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <list>
 
@@ -78,7 +79,7 @@ bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params &p)
     : ClockedObject(p), m_access_backing_store(p.access_backing_store),
-      m_cache_recorder(NULL)
+      m_held_lines_valid(false), m_cache_recorder(NULL)
 {
     m_randomization = p.randomization;
 
@@ -157,6 +158,8 @@ RubySystem::registerRequestorIDs()
 
         // Create helper vectors for each network to iterate over.
         netCntrls[network_id].push_back(cntrl);
+        if (!cntrl->tracksLineHolders())
+            netUntrackedCntrls[network_id].push_back(cntrl);
     }
 
     // Default all other requestor IDs to network 0
@@ -430,18 +433,40 @@ RubySystem::startup()
     // state was checkpointed.
 
     if (m_warmup_enabled) {
-        DPRINTF(RubyCacheTrace, "Starting ruby cache warmup\n");
-        // save the current tick value
-        Tick curtick_original = curTick();
-        // save the event queue head
-        Event* eventq_head = eventq->replaceHead(NULL);
-        // set curTick to 0 and reset Ruby System's clock
-        setCurTick(0);
-        resetClock();
-
-        // Schedule an event to start cache warmup
-        enqueueRubyEvent(curTick());
-        simulate();
+        // Setting up the cache contents directly avoids simulating all the
+        // recorded requests, but every controller must know how to do it.
+        bool direct_warmup = params().direct_cache_warmup;
+        for (auto cntrl : m_abs_cntrl_vec) {
+            if (direct_warmup && !cntrl->supportsDirectWarmup()) {
+                warn("%s does not support direct cache warmup, replaying "
+                     "the cache trace instead\n", cntrl->name());
+                direct_warmup = false;
+            }
+        }
+
+        if (direct_warmup) {
+            DPRINTF(RubyCacheTrace, "Injecting ruby cache contents\n");
+            m_cache_recorder->injectCacheContents(m_abs_cntrl_vec);
+        } else {
+            DPRINTF(RubyCacheTrace, "Starting ruby cache warmup\n");
+            // save the current tick value
+            Tick curtick_original = curTick();
+            // save the event queue head
+            Event* eventq_head = eventq->replaceHead(NULL);
+            // set curTick to 0 and reset Ruby System's clock
+            setCurTick(0);
+            resetClock();
+
+            // Schedule an event to start cache warmup
+            enqueueRubyEvent(curTick());
+            simulate();
+
+            // Restore eventq head
+            eventq->replaceHead(eventq_head);
+            // Restore curTick and Ruby System's clock
+            setCurTick(curtick_original);
+            resetClock();
+        }
 
         delete m_cache_recorder;
         m_cache_recorder = NULL;
@@ -449,12 +474,6 @@ RubySystem::startup()
         if (m_systems_to_warmup == 0) {
             m_warmup_enabled = false;
         }
-
-        // Restore eventq head
-        eventq->replaceHead(eventq_head);
-        // Restore curTick and Ruby System's clock
-        setCurTick(curtick_original);
-        resetClock();
     }
 
     resetStats();
@@ -470,10 +489,96 @@ RubySystem::processRubyEvent()
     }
 }
 
+const std::set<Addr> &
+RubySystem::getHeldLines()
+{
+    if (!m_held_lines_valid) {
+        // Permissions alone don't tell whether a line is dirty: an owned
+        // line may be read only, and busy lines or lines in TBEs may carry
+        // data that is not in memory yet. Leave all of them out.
+        for (auto cntrl : m_abs_cntrl_vec)
+            cntrl->collectHeldLines(m_held_lines);
+        m_held_lines_valid = true;
+
+        DPRINTF(RubySystem, "%d lines held in caches or TBEs\n",
+                m_held_lines.size());
+    }
+    return m_held_lines;
+}
+
+void
+RubySystem::invalidateBackdoors()
+{
+    // Backdoors are only narrowed down, and need to go away, when they
+    // bypass the controllers.
+    if (!m_held_lines_valid)
+        return;
+
+    for (auto port : m_ruby_ports)
+        port->invalidateBackdoors();
+    m_held_lines.clear();
+    m_held_lines_valid = false;
+}
+
+void
+RubySystem::addLineHolder(Addr addr, AbstractController *cntrl)
+{
+    auto &holders = lineHolders[makeLineAddress(addr)];
+    if (std::find(holders.begin(), holders.end(), cntrl) == holders.end())
+        holders.push_back(cntrl);
+}
+
+void
+RubySystem::removeLineHolder(Addr addr, AbstractController *cntrl)
+{
+    auto it = lineHolders.find(makeLineAddress(addr));
+    if (it == lineHolders.end())
+        return;
+
+    auto &holders = it->second;
+    auto holder = std::find(holders.begin(), holders.end(), cntrl);
+    if (holder != holders.end()) {
+        *holder = holders.back();
+        holders.pop_back();
+    }
+    if (holders.empty())
+        lineHolders.erase(it);
+}
+
+void
+RubySystem::getFunctionalCandidates(Addr line_addr, int net_id,
+    std::vector<AbstractController *> &cntrls)
+{
+    cntrls.assign(netUntrackedCntrls[net_id].begin(),
+                  netUntrackedCntrls[net_id].end());
+
+    auto it = lineHolders.find(line_addr);
+    if (it == lineHolders.end())
+        return;
+
+    for (auto cntrl : it->second) {
+        if (requestorToNetwork[cntrl->getRequestorId()] == net_id)
+            cntrls.push_back(cntrl);
+    }
+}
+
+bool
+RubySystem::mayHoldLine(AbstractController *cntrl, Addr line_addr) const
+{
+    if (!cntrl->tracksLineHolders())
+        return true;
+
+    auto it = lineHolders.find(line_addr);
+    return it != lineHolders.end() &&
+        std::find(it->second.begin(), it->second.end(), cntrl) !=
+        it->second.end();
+}
+
 void
 RubySystem::resetStats()
 {
     m_start_cycle = curCycle();
+    m_profiler->resetStats();
     for (auto& network : m_networks) {
         network->resetStats();
     }
@@ -507,9 +612,16 @@ RubySystem::functionalRead(PacketPtr pkt)
     AbstractController *ctrl_rw = nullptr;
     AbstractController *ctrl_backing_store = nullptr;
 
+    // Only look at the controllers that may have the line in a valid state,
+    // the others are known to have it invalid.
+    std::vector<AbstractController *> candidates;
+    getFunctionalCandidates(line_address, request_net_id, candidates);
+    int num_controllers = netCntrls[request_net_id].size();
+    num_invalid = num_controllers - candidates.size();
+
     // In this loop we count the number of controllers that have the given
     // address in read only, read write and busy states.
-    for (auto& cntrl : netCntrls[request_net_id]) {
+    for (auto& cntrl : candidates) {
         access_perm = cntrl-> getAccessPermission(line_address);
         if (access_perm == AccessPermission_Read_Only){
             num_ro++;
@@ -545,7 +657,6 @@ RubySystem::functionalRead(PacketPtr pkt)
     // The reason is because the Backing_Store memory could easily be stale, if
     // there are copies floating around the cache hierarchy, so you want to read
     // it only if it's not in the cache hierarchy at all.
-    int num_controllers = netCntrls[request_net_id].size();
     if (num_invalid == (num_controllers - 1) && num_backing_store == 1) {
         DPRINTF(RubySystem, "only copy in Backing_Store memory, read from it\n");
         ctrl_backing_store->functionalRead(line_address, pkt);
@@ -613,6 +724,10 @@ RubySystem::functionalRead(PacketPtr pkt)
 
     // Build lists of controllers that have line
     for (auto ctrl : m_abs_cntrl_vec) {
+        if (!mayHoldLine(ctrl, line_address)) {
+            ctrl_others.push_back(ctrl);
+            continue;
+        }
         switch(ctrl->getAccessPermission(line_address)) {
             case AccessPermission_Read_Only:
                 ctrl_ro.push_back(ctrl);
@@ -717,11 +832,15 @@ RubySystem::functionalWrite(PacketPtr pkt)
     for (auto& cntrl : netCntrls[request_net_id]) {
         num_functional_writes += cntrl->functionalWriteBuffers(pkt);
 
-        access_perm = cntrl->getAccessPermission(line_addr);
-        if (access_perm != AccessPermission_Invalid &&
-            access_perm != AccessPermission_NotPresent) {
-            num_functional_writes +=
-                cntrl->functionalWrite(line_addr, pkt);
+        // Messages carrying the line may be anywhere, but the controller
+        // state only needs to be updated where the line may be valid.
+        if (mayHoldLine(cntrl, line_addr)) {
+            access_perm = cntrl->getAccessPermission(line_addr);
+            if (access_perm != AccessPermission_Invalid &&
+                access_perm != AccessPermission_NotPresent) {
+                num_functional_writes +=
+                    cntrl->functionalWrite(line_addr, pkt);
+            }
         }
 
         // Also updates requests pending in any sequencer associated
@@ -35,6 +35,7 @@
 #ifndef __MEM_RUBY_SYSTEM_RUBYSYSTEM_HH__
 #define __MEM_RUBY_SYSTEM_RUBYSYSTEM_HH__
 
+#include <set>
 #include <unordered_map>
 
 #include "base/callback.hh"
@@ -59,6 +60,7 @@ namespace ruby
 
 class Network;
 class AbstractController;
+class RubyPort;
 
 class RubySystem : public ClockedObject
 {
@@ -103,6 +105,33 @@ class RubySystem : public ClockedObject
     bool functionalRead(Packet *ptr);
     bool functionalWrite(Packet *ptr);
 
+    /**
+     * Get the line addresses that any controller holds in a cache or a TBE,
+     * i.e., the lines whose most recent copy may not be in memory. The set
+     * is built on first use and kept until invalidateBackdoors() is
+     * called, so it is only meant to be used while Ruby is not processing
+     * timing requests.
+     */
+    const std::set<Addr> &getHeldLines();
+
+    /**
+     * Invalidate the backdoors handed out by all the Ruby ports of the
+     * system, which were narrowed down using getHeldLines(). This must be
+     * done as soon as any port sees timing traffic, since from then on the
+     * caches may hold data that is newer than memory.
+     */
+    void invalidateBackdoors();
+
+    void registerRubyPort(RubyPort *port) { m_ruby_ports.push_back(port); }
+
+    /**
+     * Maintain the index of the controllers that may hold a line in a
+     * valid state. Only controllers that track their line holders (see
+     * AbstractController::tracksLineHolders) are added to it.
+     */
+    void addLineHolder(Addr addr, AbstractController *cntrl);
+    void removeLineHolder(Addr addr, AbstractController *cntrl);
+
     void registerNetwork(Network*);
     void registerAbstractController(AbstractController*);
     void registerMachineID(const MachineID& mach_id, Network* network);
@@ -132,6 +161,20 @@ class RubySystem : public ClockedObject
                                      uint64_t uncompressed_trace_size);
 
     void processRubyEvent();
+
+    /**
+     * Get the controllers of a network that functional accesses to a line
+     * need to look at: the ones that don't track their line holders and
+     * the ones the index says may hold the line.
+     */
+    void getFunctionalCandidates(Addr line_addr, int net_id,
+        std::vector<AbstractController *> &cntrls);
+
+    /**
+     * Whether a controller may hold a line in a valid state according to
+     * the index of line holders.
+     */
+    bool mayHoldLine(AbstractController *cntrl, Addr line_addr) const;
   private:
     // configuration parameters
     static bool m_randomization;
@@ -154,6 +197,16 @@ class RubySystem : public ClockedObject
     std::unordered_map<RequestorID, unsigned> requestorToNetwork;
     std::unordered_map<unsigned, std::vector<AbstractController*>> netCntrls;
 
+    // Controllers that don't track their line holders, per network
+    std::unordered_map<unsigned, std::vector<AbstractController*>>
+        netUntrackedCntrls;
+    // Controllers that may hold each line in a valid state
+    std::unordered_map<Addr, std::vector<AbstractController*>> lineHolders;
+
+    std::vector<RubyPort *> m_ruby_ports;
+    std::set<Addr> m_held_lines;
+    bool m_held_lines_valid;
+
   public:
     Profiler* m_profiler;
     CacheRecorder* m_cache_recorder;
@@ -49,6 +49,11 @@ class RubySystem(ClockedObject):
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
 
+    direct_cache_warmup = Param.Bool(False, "Restore the cache contents from \
+        a checkpoint by setting up the controller states directly instead of \
+        replaying the recorded accesses. Requires a protocol that defines \
+        warmupLine in all of its machines.")
+
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
@@ -56,6 +56,10 @@ class StateDeclAST(DeclAST):
                  self.state_machine)
         self.symtab.newSymbol(t)
 
+        machine = self.symtab.state_machine
+        if machine:
+            machine.addType(t)
+
         # Add all of the states of the type to it
         for state in self.states:
             state.generate(t)
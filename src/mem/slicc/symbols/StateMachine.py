@@ -105,6 +105,7 @@ class StateMachine(Symbol):
         self.objects = []
         self.TBEType   = None
         self.EntryType = None
+        self.StateType = None
         # Python's sets are not sorted so we have to be careful when using
         # this to generate deterministic output.
         self.debug_flags = set()
@@ -170,6 +171,9 @@ class StateMachine(Symbol):
                            "single machine.");
             self.TBEType = type
 
+        elif type_ident == "%s_State" % self.ident:
+            self.StateType = type
+
         elif "interface" in type and "AbstractCacheEntry" == type["interface"]:
             if "main" in type and "false" == type["main"].lower():
                 pass # this isn't the EntryType
@@ -179,6 +183,20 @@ class StateMachine(Symbol):
                                "single machine.");
                 self.EntryType = type
 
+    # Lines a machine never transitioned on are in the default state. If
+    # that state gives no access to the data, the machine can only hold a
+    # valid copy of the lines it transitioned on, so RubySystem can keep
+    # track of them and functional accesses can skip the machine otherwise.
+    def tracksLineHolders(self):
+        if self.StateType is None or "default" not in self.StateType:
+            return False
+
+        default = self.StateType["default"]
+        for state, perm in self.StateType.statePermPairs:
+            if "%s_%s" % (self.StateType.c_ident, state) == default:
+                return perm in ("Invalid", "NotPresent")
+        return False
+
     # Needs to be called before accessing the table
     def buildTable(self):
         assert self.table is None
@@ -224,6 +242,16 @@ class StateMachine(Symbol):
                 in_msg_bufs[buf_name].append(port)
         return port_to_buf_map, in_msg_bufs, msg_bufs
 
+    def getTrackedPort(self, port, port_to_buf_map):
+        '''Return the bit of an in port in the non-empty ports of the
+        controller, or None if its queue does not track it'''
+        # Only the message buffers maintain the non-empty ports
+        if port.pairs["queue_type"].c_ident != "MessageBuffer":
+            return None
+        if port_to_buf_map[port] >= 64:
+            return None
+        return port_to_buf_map[port]
+
     def writeCodeFiles(self, path, includes):
         self.printControllerPython(path)
         self.printControllerHH(path)
@@ -328,6 +356,7 @@ class $c_ident : public AbstractController
     void collateStats();
 
     void recordCacheTrace(int cntrl, CacheRecorder* tr);
+    void collectHeldLines(std::set<Addr> &lines);
     Sequencer* getCPUSequencer() const;
     DMASequencer* getDMASequencer() const;
     GPUCoalescer* getGPUCoalescer() const;
@@ -341,7 +370,16 @@ class $c_ident : public AbstractController
     uint64_t getEventCount(${ident}_Event event);
     bool isPossible(${ident}_State state, ${ident}_Event event);
     uint64_t getTransitionCount(${ident}_State state, ${ident}_Event event);
+''')
+
+        # The protocol can restore cache contents without replaying the
+        # requests if it maps recorded blocks to controller states
+        if "warmupLine" in [ func.c_name for func in self.functions ]:
+            code('''
+    bool supportsDirectWarmup() const { return true; }
+''')
 
+        code('''
 private:
 ''')
 
@@ -495,6 +533,7 @@ void unset_tbe(${{self.TBEType.c_ident}}*& m_tbe_ptr);
         base_include = '''
 #include "base/compiler.hh"
 #include "base/cprintf.hh"
+#include "config/slicc_transition_stats.hh"
 
 '''
 
@@ -542,6 +581,7 @@ void unset_tbe(${{self.TBEType.c_ident}}*& m_tbe_ptr);
             seen_types.add(var.type.ident)
 
         num_in_ports = len(self.in_ports)
+        track_line_holders = "true" if self.tracksLineHolders() else "false"
 
         code('''
 namespace gem5
@@ -573,6 +613,7 @@ $c_ident::$c_ident(const Params &p)
     p.ruby_system->registerAbstractController(this);
 
     m_in_ports = $num_in_ports;
+    m_track_line_holders = $track_line_holders;
 ''')
         code.indent()
 
@@ -694,9 +735,16 @@ $c_ident::init()
             code('${{prefetcher.code}}.setController(this);')
 
         code()
+        port_to_buf_map, in_msg_bufs, msg_bufs = self.getBufferMaps(ident)
         for port in self.in_ports:
-            # Set the queue consumers
-            code('${{port.code}}.setConsumer(this);')
+            # Set the queue consumers. The buffers mark their port in the
+            # non-empty ports of the controller while they hold messages, so
+            # that the wakeup skips the empty ones.
+            tracked_port = self.getTrackedPort(port, port_to_buf_map)
+            if tracked_port is not None:
+                code('${{port.code}}.setConsumer(this, $tracked_port);')
+            else:
+                code('${{port.code}}.setConsumer(this);')
 
         # Initialize the transition profiling
         code()
@@ -826,6 +874,7 @@ $c_ident::regStats()
 {
     AbstractController::regStats();
 
+#if SLICC_TRANSITION_STATS
     // For each type of controllers, one controller of that type is picked
     // to aggregate stats of all controllers of that type. 
     if (m_version == 0) {
@@ -865,6 +914,7 @@ $c_ident::regStats()
             }
         }
     }
+#endif
 
     for (${ident}_Event event = ${ident}_Event_FIRST;
                  event < ${ident}_Event_NUM; ++event) {
@@ -921,6 +971,7 @@ $c_ident::regStats()
 void
 $c_ident::collateStats()
 {
+#if SLICC_TRANSITION_STATS
     for (${ident}_Event event = ${ident}_Event_FIRST;
          event < ${ident}_Event_NUM; ++event) {
         for (unsigned int i = 0; i < m_num_controllers; ++i) {
@@ -949,6 +1000,7 @@ $c_ident::collateStats()
             }
         }
     }
+#endif
 }
 
 void
@@ -1083,6 +1135,26 @@ $c_ident::recordCacheTrace(int cntrl, CacheRecorder* tr)
         code('''
 }
 
+void
+$c_ident::collectHeldLines(std::set<Addr> &lines)
+{
+''')
+        #
+        # Collect the lines held by all associated caches and TBE tables.
+        #
+        code.indent()
+        for param in self.config_parameters:
+            if param.type_ast.type.ident == "CacheMemory":
+                assert(param.pointer)
+                code('m_${{param.ident}}_ptr->collectLineAddresses(lines);')
+        for var in self.objects:
+            if var.type.ident == "TBETable":
+                code('m_${{var.ident}}_ptr->collectAddresses(lines);')
+
+        code.dedent()
+        code('''
+}
+
 // Actions
 ''')
         if self.TBEType != None and self.EntryType != None:
@@ -1265,6 +1337,7 @@ $c_ident::functionalReadBuffers(PacketPtr& pkt, WriteMask &mask)
 
         code('''
 #include "mem/ruby/protocol/Types.hh"
+#include "mem/ruby/profiler/Profiler.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
 ''')
@@ -1285,6 +1358,10 @@ namespace ruby
 void
 ${ident}_Controller::wakeup()
 {
+    // Count the data block copies of the transitions for our Ruby system
+    DataBlock::CountCopies count_copies(
+        m_ruby_system->getProfiler()->getDataBlockCopies());
+
     if (getMemReqQueue() && getMemReqQueue()->isReady(clockEdge())) {
         serviceMemoryQueue();
     }
@@ -1313,6 +1390,11 @@ ${ident}_Controller::wakeup()
         for port in self.in_ports:
             code.indent()
             code('// ${ident}InPort $port')
+            # Only look at the ports whose buffer has messages
+            tracked_port = self.getTrackedPort(port, port_to_buf_map)
+            if tracked_port is not None:
+                code('if (hasPortMessages($tracked_port)) {')
+                code.indent()
             if "rank" in port.pairs:
                 code('m_cur_in_port = ${{port.pairs["rank"]}};')
             else:
@@ -1329,6 +1411,9 @@ ${ident}_Controller::wakeup()
                 rejected[${{port_to_buf_map[port]}}]++;
             }
 ''')
+            if tracked_port is not None:
+                code.dedent()
+                code('}')
             code.dedent()
             code('')
 
@@ -1363,6 +1448,193 @@ ${ident}_Controller::wakeup()
 
         code.write(path, "%s_Wakeup.cc" % self.ident)
 
+    def printTransitionTable(self, code):
+        '''Output the table of the transitions of each state and event,
+        and return the code of the transitions, with the transitions and
+        table entries using each code block'''
+
+        ident = self.ident
+
+        # The request types are checked in the order of their names, and
+        # the transitions keep the ones they check as a mask of bits in
+        # that order
+        request_types = sorted(set(request_type.ident
+                                   for trans in self.transitions
+                                   for request_type in trans.request_types))
+        assert len(request_types) <= 64
+        request_type_bits = dict((request_type, i) for i, request_type
+                                 in enumerate(request_types))
+
+        # This map will allow suppress generating duplicate code
+        cases = OrderedDict()
+
+        # The table entry of each distinct code block and request types,
+        # entry 0 being the invalid transitions
+        entries = OrderedDict()
+        masks = [0]
+        table = []
+
+        for trans in self.transitions:
+            case_string = "%s, %s" % (trans.state.ident, trans.event.ident)
+
+            case = self.symtab.codeFormatter()
+            # Only set next_state if it changes
+            if trans.state != trans.nextState:
+                if trans.nextState.isWildcard():
+                    # When * is encountered as an end state of a transition,
+                    # the next state is determined by calling the
+                    # machine-specific getNextState function. The next state
+                    # is determined before any actions of the transition
+                    # execute, and therefore the next state calculation cannot
+                    # depend on any of the transitionactions.
+                    case('next_state = getNextState(addr); '
+                         'm_curTransitionNextState = next_state;')
+                else:
+                    ns_ident = trans.nextState.ident
+                    case('next_state = ${ident}_State_${ns_ident}; '
+                         'm_curTransitionNextState = next_state;')
+
+            actions = trans.actions
+
+            # Check for resources
+            case_sorter = []
+            res = trans.resources
+            for key,val in res.items():
+                val = '''
+if (!%s.areNSlotsAvailable(%s, clockEdge()))
+    return TransitionResult_ResourceStall;
+''' % (key.code, val)
+                case_sorter.append(val)
+
+            # Emit the code sequences in a sorted order.  This makes the
+            # output deterministic (without this the output order can vary
+            # since Map's keys() on a vector of pointers is not deterministic
+            for c in sorted(case_sorter):
+                case("$c")
+
+            # Check all of the request_types for resource constraints, and
+            # record the access types of this transition. The request types
+            # come from the table entry of the transition, so that the
+            # transitions that only differ by them share their code.
+            mask = 0
+            for request_type in trans.request_types:
+                mask |= 1 << request_type_bits[request_type.ident]
+            if mask:
+                case('''
+for (uint64_t types = request_types; types; types &= types - 1) {
+    if (!checkResourceAvailable(requestTypeOrder[findLsbSet(types)],
+                                addr)) {
+        return TransitionResult_ResourceStall;
+    }
+}
+for (uint64_t types = request_types; types; types &= types - 1)
+    recordRequestType(requestTypeOrder[findLsbSet(types)], addr);
+''')
+
+                # A request type listed more than once is recorded as
+                # many times
+                seen = set()
+                for request_type in trans.request_types:
+                    if request_type.ident in seen:
+                        case('recordRequestType(${ident}_RequestType_'
+                             '${{request_type.ident}}, addr);')
+                    seen.add(request_type.ident)
+
+            # Figure out if we stall
+            stall = False
+            for action in actions:
+                if action.ident == "z_stall":
+                    stall = True
+                    break
+
+            if stall:
+                case('return TransitionResult_ProtocolStall;')
+            else:
+                if self.TBEType != None and self.EntryType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
+                elif self.TBEType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_tbe_ptr, addr);')
+                elif self.EntryType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
+                else:
+                    for action in actions:
+                        case('${{action.ident}}(addr);')
+                case('return TransitionResult_Valid;')
+
+            case = str(case)
+
+            # Look to see if this transition code is unique.
+            if case not in cases:
+                cases[case] = OrderedDict()
+
+            if (case, mask) not in entries:
+                entries[(case, mask)] = len(masks)
+                masks.append(mask)
+            index = entries[(case, mask)]
+            cases[case].setdefault(index, []).append(case_string)
+
+            table.append((trans, index))
+
+        assert len(masks) <= 0xffff
+
+        code('''
+namespace
+{
+
+// The entry of the transition of each state and event in the tables of
+// the transitions, 0 if there is no transition. The transitions running
+// the same code with the same request types share their entry, and the
+// transition code switches on the entries.
+constexpr auto transitionCodes = []
+{
+    std::array<std::array<uint16_t, ${ident}_Event_NUM>,
+               ${ident}_State_NUM> codes{};
+''')
+        code.indent()
+        for trans, index in table:
+            code('codes[${ident}_State_${{trans.state.ident}}]'
+                 '[${ident}_Event_${{trans.event.ident}}] = $index;')
+        code.dedent()
+        code('''
+    return codes;
+}();
+''')
+
+        if request_types:
+            code('''
+
+// The request types whose resources the transitions of each entry check,
+// as a mask of their positions in requestTypeOrder
+constexpr uint64_t transitionRequestTypes[] = {
+''')
+            code.indent()
+            for mask in masks:
+                code('${{hex(mask)}},')
+            code.dedent()
+            code('''
+};
+
+constexpr ${ident}_RequestType requestTypeOrder[] = {
+''')
+            code.indent()
+            for request_type in request_types:
+                code('${ident}_RequestType_${request_type},')
+            code.dedent()
+            code('''
+};
+''')
+
+        code('''
+
+} // anonymous namespace
+
+''')
+
+        return cases, bool(request_types)
+
     def printCSwitch(self, path):
         '''Output switch statement for transition table'''
 
@@ -1372,10 +1644,14 @@ ${ident}_Controller::wakeup()
         code('''
 // ${ident}: ${{self.short}}
 
+#include <array>
 #include <cassert>
+#include <cstdint>
 
+#include "base/bitfield.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
+#include "config/slicc_transition_stats.hh"
 #include "debug/ProtocolTrace.hh"
 #include "debug/RubyGenerated.hh"
 #include "mem/ruby/protocol/${ident}_Controller.hh"
@@ -1384,8 +1660,6 @@ ${ident}_Controller::wakeup()
 #include "mem/ruby/protocol/Types.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
-#define HASH_FUN(state, event)  ((int(state)*${ident}_Event_NUM)+int(event))
-
 #define GET_TRANSITION_COMMENT() (${ident}_transitionComment.str())
 #define CLEAR_TRANSITION_COMMENT() (${ident}_transitionComment.str(""))
 
@@ -1395,6 +1669,12 @@ namespace gem5
 namespace ruby
 {
 
+''')
+        # Build the dense transition table before the code of the
+        # transitions, that switches on the entries of the table
+        cases, has_request_types = self.printTransitionTable(code)
+
+        code('''
 TransitionResult
 ${ident}_Controller::doTransition(${ident}_Event event,
 ''')
@@ -1446,7 +1726,9 @@ TransitionResult result =
 if (result == TransitionResult_Valid) {
     DPRINTF(RubyGenerated, "next_state: %s\\n",
             ${ident}_State_to_string(next_state));
+#if SLICC_TRANSITION_STATS
     countTransition(state, event);
+#endif
 
     DPRINTFR(ProtocolTrace, "%15d %3s %10s%20s %6s>%-6s %#x %s\\n",
              curTick(), m_version, "${ident}",
@@ -1470,6 +1752,10 @@ if (result == TransitionResult_Valid) {
             code('setState(addr, next_state);')
             code('setAccessPermission(addr, next_state);')
 
+        if self.tracksLineHolders():
+            code('updateLineHolder(addr, '
+                 '${ident}_State_to_permission(next_state));')
+
         code('''
 } else if (result == TransitionResult_ResourceStall) {
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %#x %s\\n",
@@ -1513,104 +1799,25 @@ ${ident}_Controller::doTransitionWorker(${ident}_Event event,
 {
     m_curTransitionEvent = event;
     m_curTransitionNextState = next_state;
-    switch(HASH_FUN(state, event)) {
+    int transition = transitionCodes[state][event];
+''')
+        if has_request_types:
+            code('''
+    uint64_t request_types = transitionRequestTypes[transition];
+''')
+        code('''
+    switch (transition) {
 ''')
-
-        # This map will allow suppress generating duplicate code
-        cases = OrderedDict()
-
-        for trans in self.transitions:
-            case_string = "%s_State_%s, %s_Event_%s" % \
-                (self.ident, trans.state.ident, self.ident, trans.event.ident)
-
-            case = self.symtab.codeFormatter()
-            # Only set next_state if it changes
-            if trans.state != trans.nextState:
-                if trans.nextState.isWildcard():
-                    # When * is encountered as an end state of a transition,
-                    # the next state is determined by calling the
-                    # machine-specific getNextState function. The next state
-                    # is determined before any actions of the transition
-                    # execute, and therefore the next state calculation cannot
-                    # depend on any of the transitionactions.
-                    case('next_state = getNextState(addr); '
-                         'm_curTransitionNextState = next_state;')
-                else:
-                    ns_ident = trans.nextState.ident
-                    case('next_state = ${ident}_State_${ns_ident}; '
-                         'm_curTransitionNextState = next_state;')
-
-            actions = trans.actions
-            request_types = trans.request_types
-
-            # Check for resources
-            case_sorter = []
-            res = trans.resources
-            for key,val in res.items():
-                val = '''
-if (!%s.areNSlotsAvailable(%s, clockEdge()))
-    return TransitionResult_ResourceStall;
-''' % (key.code, val)
-                case_sorter.append(val)
-
-            # Check all of the request_types for resource constraints
-            for request_type in request_types:
-                val = '''
-if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
-    return TransitionResult_ResourceStall;
-}
-''' % (self.ident, request_type.ident)
-                case_sorter.append(val)
-
-            # Emit the code sequences in a sorted order.  This makes the
-            # output deterministic (without this the output order can vary
-            # since Map's keys() on a vector of pointers is not deterministic
-            for c in sorted(case_sorter):
-                case("$c")
-
-            # Record access types for this transition
-            for request_type in request_types:
-                case('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
-
-            # Figure out if we stall
-            stall = False
-            for action in actions:
-                if action.ident == "z_stall":
-                    stall = True
-                    break
-
-            if stall:
-                case('return TransitionResult_ProtocolStall;')
-            else:
-                if self.TBEType != None and self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
-                elif self.TBEType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, addr);')
-                elif self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
-                else:
-                    for action in actions:
-                        case('${{action.ident}}(addr);')
-                case('return TransitionResult_Valid;')
-
-            case = str(case)
-
-            # Look to see if this transition code is unique.
-            if case not in cases:
-                cases[case] = []
-
-            cases[case].append(case_string)
 
         # Walk through all of the unique code blocks and spit out the
         # corresponding case statement elements
         for case,transitions in cases.items():
             # Iterative over all the multiple transitions that share
             # the same code
-            for trans in transitions:
-                code('  case HASH_FUN($trans):')
+            for index,names in transitions.items():
+                for name in names:
+                    code('  // $name')
+                code('  case $index:')
             code('    $case\n')
 
         code('''
@@ -42,6 +42,9 @@
 
 #include "mem/snoop_filter.hh"
 
+#include <algorithm>
+
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
@@ -52,12 +55,251 @@ namespace gem5
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
+SnoopFilter::SnoopFilterCache::SnoopFilterCache(unsigned lines,
+                                                unsigned assoc,
+                                                unsigned victims,
+                                                unsigned linesize)
+    : numSets(lines ? lines / assoc : 0), assoc(assoc),
+      lineShift(floorLog2(linesize)), numEntries(0), numErased(0),
+      numVictims(0), useCount(0)
+{
+    if (bounded()) {
+        fatal_if(assoc == 0 || lines % assoc != 0 || !isPowerOf2(numSets),
+                 "Snoop filter of %d lines needs a power of two number of "
+                 "sets of %d ways\n", lines, assoc);
+        fatal_if(victims == 0, "Bounded snoop filter needs at least one "
+                 "victim buffer entry\n");
+        entries.resize(lines, Entry{EmptyAddr, SnoopItem(), 0});
+        this->victims.resize(victims, Entry{EmptyAddr, SnoopItem(), 0});
+    } else {
+        entries.resize(1024, Entry{EmptyAddr, SnoopItem(), 0});
+    }
+}
+
+size_t
+SnoopFilter::SnoopFilterCache::index(Addr line_addr) const
+{
+    if (bounded())
+        return ((line_addr >> lineShift) & (numSets - 1)) * assoc;
+
+    // Fibonacci hashing spreads the consecutive lines of a stream
+    // over the whole table
+    const uint64_t hash = (line_addr >> lineShift) * 0x9e3779b97f4a7c15ULL;
+    return hash >> (64 - floorLog2(entries.size()));
+}
+
+SnoopFilter::SnoopItem*
+SnoopFilter::SnoopFilterCache::find(Addr line_addr)
+{
+    const size_t first = index(line_addr);
+
+    if (bounded()) {
+        for (size_t i = first; i < first + assoc; i++) {
+            if (entries[i].addr == line_addr) {
+                entries[i].lastUse = ++useCount;
+                return &entries[i].item;
+            }
+        }
+        for (auto &e : victims) {
+            if (e.addr == line_addr)
+                return &e.item;
+        }
+        return nullptr;
+    }
+
+    const size_t mask = entries.size() - 1;
+    for (size_t i = first; entries[i].addr != EmptyAddr; i = (i + 1) & mask) {
+        if (entries[i].addr == line_addr)
+            return &entries[i].item;
+    }
+    return nullptr;
+}
+
+bool
+SnoopFilter::SnoopFilterCache::contains(Addr line_addr) const
+{
+    const size_t first = index(line_addr);
+
+    if (bounded()) {
+        for (size_t i = first; i < first + assoc; i++) {
+            if (entries[i].addr == line_addr)
+                return true;
+        }
+        for (const auto &e : victims) {
+            if (e.addr == line_addr)
+                return true;
+        }
+        return false;
+    }
+
+    const size_t mask = entries.size() - 1;
+    for (size_t i = first; entries[i].addr != EmptyAddr; i = (i + 1) & mask) {
+        if (entries[i].addr == line_addr)
+            return true;
+    }
+    return false;
+}
+
+bool
+SnoopFilter::SnoopFilterCache::canAllocate(Addr line_addr) const
+{
+    // an unbounded storage grows as needed
+    if (!bounded())
+        return true;
+
+    // a free way can always be used, and evicting a line needs a line
+    // with no request in flight, and room in the victim buffer if the
+    // line is held above
+    const bool victim_room = numVictims < victims.size();
+    const size_t first = index(line_addr);
+    for (size_t i = first; i < first + assoc; i++) {
+        const Entry &e = entries[i];
+        if (e.addr == EmptyAddr)
+            return true;
+        if (e.item.requested.none() && (victim_room || e.item.holder.none()))
+            return true;
+    }
+    return false;
+}
+
+SnoopFilter::SnoopItem*
+SnoopFilter::SnoopFilterCache::allocate(Addr line_addr, Addr &victim_addr)
+{
+    victim_addr = MaxAddr;
+
+    if (bounded()) {
+        const bool victim_room = numVictims < victims.size();
+        const size_t first = index(line_addr);
+        Entry *way = nullptr;
+        for (size_t i = first; i < first + assoc; i++) {
+            Entry &e = entries[i];
+            if (e.addr == EmptyAddr) {
+                way = &e;
+                break;
+            }
+            // lines with a request in flight have to stay in place
+            // as the request still holds on to them, and lines held
+            // above need a victim buffer entry
+            if (e.item.requested.none() &&
+                (victim_room || e.item.holder.none()) &&
+                (!way || e.lastUse < way->lastUse)) {
+                way = &e;
+            }
+        }
+        assert(way);
+
+        if (way->addr == EmptyAddr) {
+            numEntries++;
+        } else if (way->item.holder.any()) {
+            victim_addr = way->addr;
+            auto victim = std::find_if(victims.begin(), victims.end(),
+                [](const Entry &e) { return e.addr == EmptyAddr; });
+            assert(victim != victims.end());
+            *victim = *way;
+            numVictims++;
+        }
+        *way = Entry{line_addr, SnoopItem(), ++useCount};
+        return &way->item;
+    }
+
+    // keep the load, including the erased entries, below 3/4 and
+    // grow the table if more than half of it is in use
+    if ((numEntries + numErased + 1) * 4 > entries.size() * 3) {
+        rehash(numEntries * 2 >= entries.size() ?
+               entries.size() * 2 : entries.size());
+    }
+
+    const size_t mask = entries.size() - 1;
+    size_t i = index(line_addr);
+    while (entries[i].addr != EmptyAddr && entries[i].addr != ErasedAddr)
+        i = (i + 1) & mask;
+    if (entries[i].addr == ErasedAddr)
+        numErased--;
+    numEntries++;
+    entries[i] = Entry{line_addr, SnoopItem(), 0};
+    return &entries[i].item;
+}
+
+void
+SnoopFilter::SnoopFilterCache::erase(Addr line_addr)
+{
+    const size_t first = index(line_addr);
+
+    if (bounded()) {
+        for (size_t i = first; i < first + assoc; i++) {
+            if (entries[i].addr == line_addr) {
+                entries[i] = Entry{EmptyAddr, SnoopItem(), 0};
+                numEntries--;
+                return;
+            }
+        }
+        for (auto &e : victims) {
+            if (e.addr == line_addr) {
+                e = Entry{EmptyAddr, SnoopItem(), 0};
+                numVictims--;
+                return;
+            }
+        }
+        return;
+    }
+
+    const size_t mask = entries.size() - 1;
+    for (size_t i = first; entries[i].addr != EmptyAddr; i = (i + 1) & mask) {
+        if (entries[i].addr == line_addr) {
+            // the entry has to stay in the probe sequence of the
+            // lines that were inserted after it
+            entries[i] = Entry{ErasedAddr, SnoopItem(), 0};
+            numEntries--;
+            numErased++;
+            return;
+        }
+    }
+}
+
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::SnoopFilterCache::victimLines(std::vector<Addr> &lines) const
+{
+    for (const auto &e : victims) {
+        if (e.addr != EmptyAddr)
+            lines.push_back(e.addr);
+    }
+}
+
+void
+SnoopFilter::SnoopFilterCache::rehash(size_t new_size)
+{
+    std::vector<Entry> old_entries(new_size, Entry{EmptyAddr, SnoopItem(), 0});
+    old_entries.swap(entries);
+    numErased = 0;
+
+    const size_t mask = entries.size() - 1;
+    for (const auto &e : old_entries) {
+        if (e.addr == EmptyAddr || e.addr == ErasedAddr)
+            continue;
+        size_t i = index(e.addr);
+        while (entries[i].addr != EmptyAddr)
+            i = (i + 1) & mask;
+        entries[i] = e;
+    }
+}
+
+SnoopFilter::SnoopFilter(const SnoopFilterParams &p)
+    : SimObject(p),
+      cachedLocations(p.bounded ?
+                      p.max_capacity / p.system->cacheLineSize() : 0,
+                      p.assoc, p.victim_entries,
+                      p.system->cacheLineSize()),
+      linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
+      maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
+      stats(this)
+{
+}
+
+void
+SnoopFilter::eraseIfNullEntry(Addr line_addr, const SnoopItem& sf_item)
 {
-    SnoopItem& sf_item = sf_it->second;
     if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
+        cachedLocations.erase(line_addr);
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
     }
@@ -78,8 +320,9 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(cpu_side_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    reqLookupResult.lineAddr = line_addr;
+    reqLookupResult.item = cachedLocations.find(line_addr);
+    bool is_hit = (reqLookupResult.item != nullptr);
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
@@ -87,12 +330,28 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
     if (!is_hit && !allocate)
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
+    // If no hit in snoop filter create a new element, possibly
+    // evicting another line from a bounded snoop filter
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        panic_if(!cachedLocations.canAllocate(line_addr),
+                 "Snoop filter has no room to track %#llx\n", line_addr);
+        Addr victim_addr;
+        reqLookupResult.item =
+            cachedLocations.allocate(line_addr, victim_addr);
+
+        if (victim_addr != MaxAddr) {
+            // the holders keep the line tracked, in the victim buffer,
+            // until they have evicted it
+            DPRINTF(SnoopFilter, "%s:   evicted %#llx\n", __func__,
+                    victim_addr);
+            stats.evictions++;
+            stats.backInvalidations++;
+            evictedLines.push_back(victim_addr);
+        }
+        if (cachedLocations.bounded())
+            stats.victimOccupancy.sample(cachedLocations.victimSize());
     }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    SnoopItem& sf_item = *reqLookupResult.item;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -159,26 +418,86 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.item) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.lineAddr == line_addr);
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            *reqLookupResult.item = retry_item;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        eraseIfNullEntry(line_addr, *reqLookupResult.item);
+        reqLookupResult.item = nullptr;
+    }
+}
+
+bool
+SnoopFilter::canLookupRequest(const Packet *cpkt,
+                              const ResponsePort &cpu_side_port)
+{
+    // only a miss of a request that allocates in a bounded snoop
+    // filter needs room
+    if (!cachedLocations.bounded() || cpkt->req->isUncacheable() ||
+        !cpu_side_port.isSnooping() || !cpkt->fromCache()) {
+        return true;
+    }
+
+    Addr line_addr = cpkt->getBlockAddr(linesize);
+    if (cpkt->isSecure()) {
+        line_addr |= LineSecure;
+    }
+    if (cachedLocations.contains(line_addr) ||
+        cachedLocations.canAllocate(line_addr)) {
+        return true;
+    }
+
+    DPRINTF(SnoopFilter, "%s: no room for packet %s\n", __func__,
+            cpkt->print());
+    stats.blockedRequests++;
+    return false;
+}
+
+SnoopFilter::SnoopList
+SnoopFilter::takeEvictedLine(Addr &addr, bool &is_secure)
+{
+    while (!evictedLines.empty()) {
+        const Addr line_addr = evictedLines.back();
+        evictedLines.pop_back();
+
+        // the holders may have evicted the line already
+        SnoopItem *sf_item = cachedLocations.find(line_addr);
+        if (!sf_item || sf_item->holder.none())
+            continue;
+
+        addr = line_addr & ~Addr(LineSecure);
+        is_secure = line_addr & LineSecure;
+        return maskToPortList(sf_item->holder);
+    }
+    return SnoopList();
+}
+
+void
+SnoopFilter::retryEvictedLines()
+{
+    std::vector<Addr> victims;
+    cachedLocations.victimLines(victims);
+    for (const Addr line_addr : victims) {
+        if (std::find(evictedLines.begin(), evictedLines.end(),
+                      line_addr) == evictedLines.end()) {
+            evictedLines.push_back(line_addr);
+            stats.retriedBackInvalidations++;
+        }
     }
 }
 
@@ -193,10 +512,12 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    SnoopItem *sf_entry = cachedLocations.find(line_addr);
+    bool is_hit = (sf_entry != nullptr);
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
+    // a bounded snoop filter evicts lines instead
+    panic_if(!is_hit && !cachedLocations.bounded() &&
+             (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
              maxEntryCount);
 
@@ -206,7 +527,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (!is_hit)
         return snoopDown(lookupLatency);
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_entry;
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
@@ -236,7 +557,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         sf_item.holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_item);
     }
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
@@ -266,7 +587,10 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem *sf_entry = cachedLocations.find(line_addr);
+    panic_if(!sf_entry, "SF has no entry for the snoop response %s\n",
+             cpkt->print());
+    SnoopItem& sf_item = *sf_entry;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -313,18 +637,17 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    SnoopItem *sf_entry = cachedLocations.find(line_addr);
 
     // Nothing to do if it is not a hit
-    if (!is_hit)
+    if (!sf_entry)
         return;
 
     // If the snoop response has no sharers the line is passed in
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
+        SnoopItem& sf_item = *sf_entry;
 
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
@@ -332,7 +655,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_item);
     }
 }
 
@@ -355,12 +678,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    SnoopItem *sf_entry = cachedLocations.find(line_addr);
+    if (!sf_entry)
         return;
 
     SnoopMask response_mask = portToMask(cpu_side_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_entry;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -379,7 +702,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~response_mask;
         }
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_item);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -407,8 +730,28 @@ SnoopFilter::SnoopFilterStats::SnoopFilterStats(statistics::Group *parent)
                "holder of the requested data."),
       ADD_STAT(hitMultiSnoops, statistics::units::Count::get(),
                "Number of snoops hitting in the snoop filter with multiple "
-               "(>1) holders of the requested data.")
-{}
+               "(>1) holders of the requested data."),
+      ADD_STAT(evictions, statistics::units::Count::get(),
+               "Number of lines evicted from a bounded snoop filter."),
+      ADD_STAT(backInvalidations, statistics::units::Count::get(),
+               "Number of evicted lines the caches above were asked to "
+               "evict."),
+      ADD_STAT(retriedBackInvalidations, statistics::units::Count::get(),
+               "Number of evicted lines the caches above were asked again "
+               "to evict, as they were still held above."),
+      ADD_STAT(blockedRequests, statistics::units::Count::get(),
+               "Number of requests retried as the snoop filter had no "
+               "room to track their line."),
+      ADD_STAT(victimOccupancy, statistics::units::Count::get(),
+               "Number of lines in the victim buffer, sampled on "
+               "allocation.")
+{
+    evictions.flags(statistics::nozero);
+    backInvalidations.flags(statistics::nozero);
+    retriedBackInvalidations.flags(statistics::nozero);
+    blockedRequests.flags(statistics::nozero);
+    victimOccupancy.init(16).flags(statistics::nozero);
+}
 
 void
 SnoopFilter::regStats()
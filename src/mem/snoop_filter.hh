@@ -44,8 +44,8 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
@@ -95,13 +95,7 @@ class SnoopFilter : public SimObject
 
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
-        linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
-        maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
-        stats(this)
-    {
-    }
+    SnoopFilter (const SnoopFilterParams &p);
 
     /**
      * Init a new snoop filter and tell it about all the cpu_sideports
@@ -200,6 +194,40 @@ class SnoopFilter : public SimObject
      */
     void updateResponse(const Packet *cpkt, const ResponsePort& cpu_side_port);
 
+    /**
+     * Check if a request can be looked up. A bounded snoop filter
+     * cannot track a new line when every line of its set has a
+     * request in flight, or when its victim buffer is full. The
+     * request then has to be retried later, and is counted as
+     * blocked.
+     *
+     * @param cpkt          Pointer to the request packet.
+     * @param cpu_side_port Response port where the request came from.
+     * @return Whether lookupRequest can take the request.
+     */
+    bool canLookupRequest(const Packet *cpkt,
+                          const ResponsePort &cpu_side_port);
+
+    /**
+     * A bounded snoop filter evicts lines to make room for new ones,
+     * and the caches above that hold an evicted line have to drop
+     * it. Get the next evicted line whose holders have to be asked to
+     * evict it, if any. The line stays tracked, in the victim buffer,
+     * until the caches have evicted it.
+     *
+     * @param addr      Set to the address of the evicted line.
+     * @param is_secure Set to whether the evicted line is secure.
+     * @return The ports holding the evicted line, empty if none.
+     */
+    SnoopList takeEvictedLine(Addr &addr, bool &is_secure);
+
+    /**
+     * Ask the holders of all the lines in the victim buffer to evict
+     * them again, through takeEvictedLine. A holder may have kept a
+     * line as it had a request in flight for it.
+     */
+    void retryEvictedLines();
+
     virtual void regStats();
 
   protected:
@@ -220,10 +248,126 @@ class SnoopFilter : public SimObject
         SnoopMask requested;
         SnoopMask holder;
     };
+
     /**
-     * HashMap of SnoopItems indexed by line address
+     * Storage of the SnoopItems indexed by line address. An unbounded
+     * storage is an open-addressing hash table that grows as needed. A
+     * bounded storage is a set-associative array, where allocating in
+     * a full set evicts its least recently used line with no request
+     * in flight. An evicted line that is still held above moves to a
+     * small victim buffer until the holders have evicted it.
      */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+    class SnoopFilterCache
+    {
+      public:
+        /**
+         * @param lines    Number of lines of a bounded storage, zero for
+         *                 an unbounded storage.
+         * @param assoc    Associativity of a bounded storage.
+         * @param victims  Victim buffer entries of a bounded storage.
+         * @param linesize Cache line size.
+         */
+        SnoopFilterCache(unsigned lines, unsigned assoc, unsigned victims,
+                         unsigned linesize);
+
+        /**
+         * Find the item of a line.
+         *
+         * @param line_addr Line address.
+         * @return The item, nullptr if the line is not tracked.
+         */
+        SnoopItem *find(Addr line_addr);
+
+        /**
+         * Check if a line is tracked, without updating the replacement
+         * state.
+         *
+         * @param line_addr Line address.
+         * @return Whether the line is tracked.
+         */
+        bool contains(Addr line_addr) const;
+
+        /**
+         * Check if a line that is not tracked can be allocated.
+         *
+         * @param line_addr Line address.
+         * @return Whether allocate would succeed.
+         */
+        bool canAllocate(Addr line_addr) const;
+
+        /**
+         * Allocate an empty item for a line that is not tracked, which
+         * canAllocate must allow. The returned item stays valid until
+         * the next allocation.
+         *
+         * @param line_addr   Line address.
+         * @param victim_addr Set to the address of the line moved to
+         *                    the victim buffer to make room, or MaxAddr.
+         * @return The new item.
+         */
+        SnoopItem *allocate(Addr line_addr, Addr &victim_addr);
+
+        /**
+         * Stop tracking a line.
+         *
+         * @param line_addr Line address.
+         */
+        void erase(Addr line_addr);
+
+        /** Number of tracked lines. */
+        size_t size() const { return numEntries + numVictims; }
+
+        /** Number of tracked lines in the victim buffer. */
+        size_t victimSize() const { return numVictims; }
+
+        /**
+         * Get the addresses of the lines in the victim buffer.
+         *
+         * @param lines Vector the addresses are appended to.
+         */
+        void victimLines(std::vector<Addr> &lines) const;
+
+        bool bounded() const { return numSets != 0; }
+
+      private:
+        struct Entry
+        {
+            /** Line address, or one of the two markers below */
+            Addr addr;
+            SnoopItem item;
+            /** Last use, for the replacement of a bounded storage */
+            uint64_t lastUse;
+        };
+
+        /** Markers of the never used and erased entries */
+        static const Addr EmptyAddr = MaxAddr;
+        static const Addr ErasedAddr = MaxAddr - 1;
+
+        /** Position of the first entry to look at for a line */
+        size_t index(Addr line_addr) const;
+
+        /** Resize the hash table of an unbounded storage */
+        void rehash(size_t new_size);
+
+        std::vector<Entry> entries;
+
+        /** Evicted lines that are still held above */
+        std::vector<Entry> victims;
+
+        /** Number of sets, zero for an unbounded storage */
+        const unsigned numSets;
+        const unsigned assoc;
+        const unsigned lineShift;
+
+        /** Number of tracked, and erased, lines in the entries */
+        size_t numEntries;
+        size_t numErased;
+
+        /** Number of lines in the victim buffer */
+        size_t numVictims;
+
+        uint64_t useCount;
+    };
 
     /**
      * Simple factory methods for standard return values.
@@ -261,11 +405,17 @@ class SnoopFilter : public SimObject
     /**
      * Removes snoop filter items which have no requestors and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(Addr line_addr, const SnoopItem& sf_item);
 
-    /** Simple hash set of cached addresses. */
+    /** Tracked lines. */
     SnoopFilterCache cachedLocations;
 
+    /**
+     * Evicted lines whose holders have to be asked to evict them, at
+     * most one per victim buffer entry.
+     */
+    std::vector<Addr> evictedLines;
+
     /**
      * A request lookup must be followed by a call to finishRequest to inform
      * the operation's success. If a retry is needed, however, all changes
@@ -274,27 +424,18 @@ class SnoopFilter : public SimObject
      */
     struct ReqLookupResult
     {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /** Item found or allocated by lookupRequest, if any. */
+        SnoopItem *item = nullptr;
+
+        /** Line address of the item. */
+        Addr lineAddr = 0;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
          * in case finishRequest needs to undo changes made in lookupRequest
          * (because of crossbar retry)
          */
-        SnoopItem retryItem;
-
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
-        {
-        }
-        ReqLookupResult() = delete;
+        SnoopItem retryItem{0, 0};
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
@@ -329,6 +470,12 @@ class SnoopFilter : public SimObject
         statistics::Scalar totSnoops;
         statistics::Scalar hitSingleSnoops;
         statistics::Scalar hitMultiSnoops;
+
+        statistics::Scalar evictions;
+        statistics::Scalar backInvalidations;
+        statistics::Scalar retriedBackInvalidations;
+        statistics::Scalar blockedRequests;
+        statistics::Histogram victimOccupancy;
     } stats;
 };
 
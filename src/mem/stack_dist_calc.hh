@@ -39,7 +39,8 @@
 #define __MEM_STACK_DIST_CALC_HH__
 
 #include <limits>
-#include <map>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "base/types.hh"
@@ -49,72 +50,53 @@ namespace gem5
 
 /**
   * The stack distance calculator is a passive object that merely
-  * observes the addresses pass to it. It calculates stack distances
-  * of incoming addresses based on the partial sum hierarchy tree
-  * algorithm described by Alamasi et al.
-  * http://doi.acm.org/10.1145/773039.773043.
+  * observes the addresses pass to it. It calculates the stack
+  * distance of an incoming address as the number of unique addresses
+  * accessed since its previous access.
   *
-  * A tree structure is maintained and updated at each transaction
-  * (unique or non-unique). The tree is implemented as an STL vector
-  * with layers of the form <map> Each layer in this tree is an
-  * ordered map <uint64_t, Node*>. Nodes are structs which take form
-  * of leaf, intermediate and root nodes. For example, in a tree with 3
-  * layers, tree[0][5] gives a leaf node pointer for key=5 tree[1][1]
-  * gives an intermediate node pointer for key=1 tree[2][0] gives the
-  * root node in the tree.
+  * Every access gets a timestamp, and the calculator keeps the time
+  * of the last access to each address (lastAccess). A Fenwick tree
+  * (binary indexed tree) over the timestamps holds a 1 for every time
+  * that is the last access of an address, and a 0 otherwise. The
+  * stack distance of an address is then the number of ones after its
+  * last access time, which is a prefix sum over the tree: both the
+  * lookup and the update of an access take O(log n) time and no
+  * allocation.
   *
-  * At every transaction a hash-map (aiMap) is looked up to check if
-  * the address was already encountered before. Based on this lookup a
-  * transaction can be termed as unique or non-unique.
+  * The timestamps grow with every access, whereas only the last
+  * access of every address matters. When the tree runs out of
+  * timestamps, the last accesses are renumbered in order, and the
+  * tree is rebuilt with twice as many timestamps as there are
+  * addresses. The memory used is thus proportional to the number of
+  * unique addresses, and not to the length of the trace.
   *
   * In addition to the normal stack distance calculation, a feature to
-  * mark an old node in the tree is added. This is useful if it is
-  * required to see the reuse pattern. For example, BackInvalidates
-  * from a lower level (e.g. membus to L2), can be marked (isMarked
-  * flag of Node set to True). Then later if this same address is
-  * accessed (by L1), the value of the isMarked flag would be
-  * True. This would give some insight on how the BackInvalidates
-  * policy of the lower level affect the read/write accesses in an
-  * application.
+  * mark an address is added. This is useful if it is required to see
+  * the reuse pattern. For example, BackInvalidates from a lower level
+  * (e.g. membus to L2), can be marked. Then later if this same
+  * address is accessed (by L1), the mark would be set. This would
+  * give some insight on how the BackInvalidates policy of the lower
+  * level affect the read/write accesses in an application.
   *
   * There are two functions provided to interface with the calculator:
   * 1. pair<uint64_t, bool> calcStackDistAndUpdate(Addr r_address,
   *                                                bool addNewNode)
-  * At every unique transaction a new leaf node is added at tree[0](leaf layer)
-  * and linked to the layer above (if addNewNode is True). The sums of all
-  * the intermediate nodes is updated till the root. The stack-distance is
-  * returned as a Constant representing INFINITY.
-  *
-  * At every non-unique transaction the tree is traversed from the
-  * leaf at the returned index to the root, the old node is deleted
-  * from the tree, and the sums (to the right are collected) and
-  * decremented. The collected sum represets the stack distance of the
-  * found node. If this node was marked then a bool flag set to True
-  * is returned with the stack_distance. During this operation a node
-  * is discarded at the leaf layer always. Moreover during the
-  * traversal upwards using the updateSum() method, if an intermediate
-  * node is found with no children connected to it, then that is
-  * discarded too.
+  * The stack distance of the address is calculated, and its previous
+  * access is removed from the stack. If addNewNode is true, the
+  * address is pushed on the top of the stack. The stack distance of
+  * an address that is not in the stack is a constant representing
+  * INFINITY.
   *
   * The return value of this function is a pair representing the
   * stack_distance and the value of the marked flag.
   *
   * 2. pair<uint64_t , bool> calcStackDist(Addr r_address, bool mark)
   * This is a stripped down version of the above function which is used to
-  * just inspect the tree, and mark a leaf node (if mark flag is set). The
-  * functionality to add a new node is removed.
-  *
-  * At every unique transaction the stack-distance is returned as a constant
-  * representing INFINITY.
+  * just inspect the stack, and mark an address (if mark flag is set).
   *
-  * At every non-unique transaction the tree is traversed from the
-  * leaf at the returned index to the root, and the sums (to the right)
-  * are collected. The collected sum represets the stack distance of
-  * the found node.
-  *
-  * This function does NOT Modify the stack. (No node is added or
-  * deleted).  It is just used to mark a node already created and get
-  * its stack distance.
+  * This function does NOT Modify the stack. (No address is added or
+  * deleted).  It is just used to mark an address already in the stack
+  * and get its stack distance.
   *
   * The return value of this function is a pair representing the stack
   * distance and the value of the marked flag.
@@ -151,14 +133,17 @@ namespace gem5
   * Delete Old Entry |calcStackDistAndUpdate|Writebacks/Cleanevicts|
   * Dist.of Old entry|calcStackDist         |Cleanevicts/Invalidate|
   *
-  * Node Balancing: The tree structure is maintained by an
-  * updateTree() operation called when an intermediate node is
-  * required. The update operation is roughly categorized as a root
-  * update or intermediate layer update. When number of leaf nodes
-  * grow over a power of 2 then a new layer is added at the top of the
-  * tree and a new root node is initialized. The old node at the lower
-  * layer is connected to this.  In an intermediate node update
-  * operation a new intermediate node is added to the required layer.
+  * Sampling: The calculator can approximate the stack distances by
+  * only tracking a spatially hashed sample of the addresses (SHARDS,
+  * Waldspurger et al., FAST'15). An address is sampled if the top
+  * samplingShift bits of its hash are zero, so that one in
+  * 2^samplingShift addresses is sampled. The stack distances of the
+  * sampled addresses are scaled by the inverse of the sampling rate,
+  * and each sampled access stands for 2^samplingShift accesses. If
+  * the number of tracked addresses is bounded, the sampling rate is
+  * halved, and the addresses that are no longer sampled are dropped,
+  * whenever the bound is exceeded. Callers must only pass the
+  * addresses for which sampled() returns true.
   *
   * Debugging: Debugging can be enabled by setting the verifyStack flag
   * true. Debugging is implemented using a dummy stack that behaves in
@@ -169,99 +154,53 @@ namespace gem5
   * pushed down, and the address is pushed at the top of the stack).
   *
   * A printStack(int numOfEntitiesToPrint) is provided to print top n entities
-  * in both (tree and STL based dummy stack).
+  * in both (Fenwick tree and STL based dummy stack).
   */
 class StackDistCalc
 {
 
   private:
 
-    struct Node;
-
-    typedef std::map<uint64_t, Node*> IndexNodeMap;
-    typedef std::map<Addr, uint64_t> AddressIndexMap;
-    typedef std::vector<IndexNodeMap> TreeType;
-
     /**
-     * Gets sum from the node upwards recursively till the root.  This
-     * function is called first by getSumsLeavesToRoot, and then
-     * recursively calls itself.
-     *
-     * @param node pointer to the node which is updated
-     * @param from_left variable which says that the request arrived
-     *        from the left
-     * @param sum_from_below Sum of left and right children below
-     * @param level level in the tree the calling node is located
-     * @param stack_dist stack distance of the node below
-     * @return The stack distance of the current address.
-     *
-     */
-    uint64_t getSum(Node* node, bool from_left, uint64_t sum_from_below,
-                    uint64_t stack_dist, uint64_t level) const;
-
-    /**
-     * Gets the sum from the leaf node specified. This function
-     * is called by calcStackDist.
-     *
-     * @param node pointer to the node which is updated
-     * @return The stack distance of the current address.
+     * Add a value to the entry of a timestamp in the Fenwick tree.
      *
+     * @param time The timestamp
+     * @param value The value to add
      */
-    uint64_t getSumsLeavesToRoot(Node* node) const;
+    void addAccess(uint64_t time, int64_t value);
 
     /**
-     * Updates the nodes upwards recursively till the root.
-     * This function is first called by updateSumsLeavesToRoot,
-     * and then it recursively calls itself.
-     *
-     * @param node pointer to the node which is updated
-     * @param from_left variable which says that the request arrived
-     * from the left
-     * @param sum_from_below Sum of left and right children below
-     * @param level level in the tree the calling node is located
-     * @param stack_dist stack distance of the node below
-     * @param discard_node whether the calling node was discarded or not
-     * @return The stack distance of the current address.
+     * Count the last accesses up to a timestamp, included.
      *
+     * @param time The timestamp
+     * @return The number of last accesses up to the timestamp
      */
-    uint64_t updateSum(Node* node,
-                       bool from_left, uint64_t sum_from_below, uint64_t level,
-                       uint64_t stack_dist, bool discard_node);
+    uint64_t countAccesses(uint64_t time) const;
 
     /**
-     * Updates the leaf nodes and nodes above. This function is
-     * called by the calcStackDistAndUpdate.
-     *
-     * @param node pointer to the node which is updated
-     * @param is_new_leaf is true if this is a newly added node
-     * @return The stack distance of the current address.
+     * Stack distance of an address accessed last at a timestamp, scaled
+     * by the inverse of the sampling rate.
      *
+     * @param time The timestamp of the last access to the address
+     * @return The stack distance of the address
      */
-    uint64_t updateSumsLeavesToRoot(Node* node, bool is_new_leaf);
+    uint64_t
+    stackDist(uint64_t time) const
+    {
+        return (lastAccess.size() - countAccesses(time)) << samplingShift;
+    }
 
     /**
-     * updateTree is a tree balancing operation, which maintains the
-     * binary tree structure.
-     * This method is called whenever index%2 == 0 (i.e. every
-     * alternate cycle) The two main operation are :
-     * OP1. Moving the root node one layer up if index counter
-     *       crosses power of 2
-     * OP2. Addition of intermediate nodes as and when required
-     *      and linking them to their parents in the layer above.
+     * Renumber the last accesses in order, from 0, and rebuild the
+     * Fenwick tree with room for as many new accesses.
      */
-    void updateTree();
+    void compact();
 
     /**
-     * This method is used for verification purposes
-     * It recursively traverses upwards from the given node till
-     * the root to check if the ultimate parent node (root-node) points
-     * to null.
-     *
-     * @param node pointer to the node whose sanity is being checked
-     * @param level the level at which this node is located in the tree
-     *
+     * Halve the sampling rate until the number of tracked addresses is
+     * within the bound, and drop the addresses no longer sampled.
      */
-    void sanityCheckTree(const Node* node, uint64_t level = 0) const;
+    void reduceSampling();
 
     /**
      * Return the counter for address accesses (unique and
@@ -272,15 +211,6 @@ class StackDistCalc
      */
     uint64_t getIndex() const { return index; }
 
-    /**
-     * Query depth of the tree (tree[0] represents leaf layer while
-     * tree[treeDepth] represents the root layer, all layers in
-     * between contain intermediate nodes)
-     *
-     * @return Tree depth
-     */
-    uint64_t getTreeDepth() const { return tree.size() - 1; }
-
     /**
      * Print the last n items on the stack.
      * This method prints top n entries in the tree based implementation as
@@ -305,19 +235,50 @@ class StackDistCalc
                              bool update_stack = false);
 
   public:
-    StackDistCalc(bool verify_stack = false);
-
-    ~StackDistCalc();
+    /**
+     * @param verify_stack Verify the stack distances with a naive stack
+     * @param sampling_shift Log2 of the inverse of the initial sampling
+     *        rate, 0 to track all addresses
+     * @param max_tracked Maximum number of tracked addresses, 0 for no
+     *        bound
+     */
+    StackDistCalc(bool verify_stack = false, unsigned sampling_shift = 0,
+                  uint64_t max_tracked = 0);
 
     /**
      * A convenient way of refering to infinity.
      */
     static constexpr uint64_t Infinity = std::numeric_limits<uint64_t>::max();
 
+    /**
+     * Largest sampling shift, so that the number of accesses a sampled
+     * access stands for fits the count of a histogram sample.
+     */
+    static constexpr unsigned MaxSamplingShift = 30;
+
+    /**
+     * Check whether an address is in the sample of tracked addresses.
+     *
+     * @param r_address The address
+     * @return Whether the address is sampled
+     */
+    bool
+    sampled(const Addr r_address) const
+    {
+        return samplingShift == 0 ||
+            (hashAddr(r_address) >> (64 - samplingShift)) == 0;
+    }
+
+    /**
+     * Number of accesses a sampled access stands for.
+     *
+     * @return The inverse of the sampling rate
+     */
+    uint64_t sampleWeight() const { return 1ULL << samplingShift; }
 
     /**
      * Process the given address. If Mark is true then set the
-     * mark flag of the leaf node.
+     * mark flag of the address.
      * This function returns the stack distance of the incoming
      * address and the previous status of the mark flag.
      *
@@ -330,14 +291,14 @@ class StackDistCalc
 
     /**
      * Process the given address:
-     *  - Lookup the tree for the given address
-     *  - delete old node if found in tree
-     *  - add a new node (if addNewNode flag is set)
+     *  - Lookup the stack for the given address
+     *  - delete old entry if found in the stack
+     *  - push the address (if addNewNode flag is set)
      * This function returns the stack distance of the incoming
      * address and the status of the mark flag.
      *
      * @param r_address The current address to process
-     * @param addNewNode If true, a new node is added to the tree
+     * @param addNewNode If true, the address is pushed on the stack
      * @return The stack distance of the current address and the mark flag.
      */
     std::pair<uint64_t, bool> calcStackDistAndUpdate(const Addr r_address,
@@ -345,67 +306,48 @@ class StackDistCalc
 
   private:
 
-    /**
-     * Node which takes form of Leaf, INode or Root
-     */
-    struct Node
+    /** Hash spreading the addresses uniformly, used for sampling */
+    static uint64_t
+    hashAddr(Addr addr)
     {
-        // Sum of the left children
-        uint64_t sumLeft;
-
-        // Sum of the right children
-        uint64_t sumRight;
-
-        // Flag to indicate that sumLeft has gone from non-zero value to 0
-        bool discardLeft;
-
-        // Flag to indicate that sumRight has gone from non-zero value to 0
-        bool discardRight;
-
-        // Index of the current element in the Map
-        uint64_t nodeIndex;
-
-        // Pointer to the parent
-        Node* parent;
+        uint64_t hash = addr;
+        hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+        return hash ^ (hash >> 31);
+    }
 
-        // Flag to mark the node as the right/left child
-        bool isLeftNode;
+    /** Flag of a lastAccess entry set when the address is marked */
+    static constexpr uint64_t MarkFlag = 1ULL << 63;
 
-        /**
-         * Flag to indicate if this address is marked. Used in case
-         * where stack distance of a touched address is required.
-         */
-        bool isMarked;
-
-        /**
-         * The discard flags are false by default they become true if
-         * the node is reached again in a future lookup.
-         */
-        Node() : sumLeft(0), sumRight(0), discardLeft(false),
-                 discardRight(false), nodeIndex(0),
-                 parent(nullptr), isLeftNode(true), isMarked(false)
-        { }
-    };
+    /** Minimum number of timestamps in the Fenwick tree */
+    static constexpr uint64_t MinTimestamps = 1ULL << 16;
 
     /**
      * Internal counter for address accesses (unique and non-unique)
-     * This counter increments everytime the calcStackDist() method is
-     * called. This counter is used as a key for the hash- map at the
-     * leaf layer. Practically at every call to the calculator this
-     * counter is incremented and a new leaf node is added in the tree
-     * at the leaf layer using this counter value as the key.
+     * This counter increments everytime an address is pushed on the
+     * stack, and gives the timestamp of the access. It is reset to
+     * the number of tracked addresses when the timestamps are
+     * renumbered.
      */
     uint64_t index;
 
-    // Binary tree of partial sums
-    TreeType tree;
+    /**
+     * Time of the last access of each tracked address, the MarkFlag
+     * is set if the address is marked.
+     */
+    std::unordered_map<Addr, uint64_t> lastAccess;
+
+    /**
+     * Fenwick tree over the timestamps, indexed from 1, where a
+     * timestamp counts for 1 if it is the last access of an address.
+     */
+    std::vector<uint64_t> accesses;
 
-    // Hash map which returns last seen index of each address
-    AddressIndexMap aiMap;
+    /** Log2 of the inverse of the sampling rate */
+    unsigned samplingShift;
 
-    // Keeps count of number of the next unique index for each
-    // level in the tree
-    std::vector<uint64_t> nextIndex;
+    /** Maximum number of tracked addresses, 0 if unbounded */
+    const uint64_t maxTracked;
 
     // Dummy Stack for verification
     std::vector<uint64_t> stack;
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "mem/stack_dist_calc.hh"
+
+using namespace gem5;
+
+/**
+ * Compare the Fenwick tree against a naive stack, over enough accesses to
+ * renumber the timestamps several times, with a working set that shrinks
+ * half way, marks, lookups that do not update the stack and removals.
+ */
+TEST(StackDistCalcTest, MatchesNaiveStack)
+{
+    std::mt19937 gen(0);
+    StackDistCalc calc;
+
+    // the top of the naive stack is its back
+    std::vector<Addr> stack;
+    std::unordered_map<Addr, bool> marks;
+
+    const int num_accesses = 300000;
+    for (int i = 0; i < num_accesses; i++) {
+        const unsigned num_lines = i < num_accesses / 2 ? 1000 : 50;
+        const Addr addr = (gen() % num_lines) * 64;
+        const unsigned op = gen() % 10;
+
+        const auto it = std::find(stack.rbegin(), stack.rend(), addr);
+        const bool found = (it != stack.rend());
+        const uint64_t sd = found ? it - stack.rbegin() :
+                                    StackDistCalc::Infinity;
+        const bool marked = found && marks[addr];
+
+        if (op == 0) {
+            // look the address up and mark it
+            const bool mark = gen() % 2;
+            const auto res = calc.calcStackDist(addr, mark);
+            ASSERT_EQ(res.first, sd);
+            ASSERT_EQ(res.second, marked);
+            if (found)
+                marks[addr] = mark;
+        } else {
+            // access the address, or remove it from the stack
+            const bool add = (op != 1);
+            const auto res = calc.calcStackDistAndUpdate(addr, add);
+            ASSERT_EQ(res.first, sd);
+            ASSERT_EQ(res.second, marked);
+            if (found)
+                stack.erase(std::next(it).base());
+            if (add) {
+                stack.push_back(addr);
+                marks[addr] = false;
+            }
+        }
+    }
+}
+
+/**
+ * Sweep over more lines than the calculator may track, so that it lowers
+ * its sampling rate, and check that the scaled stack distances of the
+ * sampled lines approximate the exact one.
+ */
+TEST(StackDistCalcTest, SampledWithinBound)
+{
+    const uint64_t max_tracked = 1000;
+    const unsigned num_lines = 20000;
+    StackDistCalc calc(false, 0, max_tracked);
+
+    uint64_t num_sds = 0;
+    double sum_sds = 0;
+    for (int i = 0; i < 100 * num_lines; i++) {
+        const Addr addr = (i % num_lines) * 64;
+        if (!calc.sampled(addr))
+            continue;
+        const uint64_t sd = calc.calcStackDistAndUpdate(addr).first;
+        if (sd != StackDistCalc::Infinity) {
+            sum_sds += sd;
+            num_sds++;
+        }
+    }
+
+    // every line is accessed once in between two accesses to a line
+    ASSERT_GT(calc.sampleWeight(), 1);
+    ASSERT_GT(num_sds, 0);
+    EXPECT_NEAR(sum_sds / num_sds, num_lines - 1, 0.1 * num_lines);
+
+    std::unordered_set<Addr> sampled;
+    for (unsigned line = 0; line < num_lines; line++) {
+        if (calc.sampled(line * 64))
+            sampled.insert(line * 64);
+    }
+    ASSERT_LE(sampled.size(), max_tracked);
+}
+
+/** The sampling rate can be lowered to the largest sampling shift. */
+TEST(StackDistCalcTest, SampleWeightFitsInt)
+{
+    StackDistCalc calc(false, StackDistCalc::MaxSamplingShift);
+    ASSERT_LE(calc.sampleWeight(),
+              (uint64_t)std::numeric_limits<int>::max());
+}
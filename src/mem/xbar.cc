@@ -144,7 +144,8 @@ BaseXBar::Layer<SrcType, DstType>::Layer(DstType& _port, BaseXBar& _xbar,
                                        const std::string& _name) :
     statistics::Group(&_xbar, _name.c_str()),
     port(_port), xbar(_xbar), _name(xbar.name() + "." + _name), state(IDLE),
-    waitingForPeer(NULL), releaseEvent([this]{ releaseLayer(); }, name()),
+    busyUntil(0), waitingForPeer(NULL),
+    releaseEvent([this]{ releaseLayer(); }, name()),
     ADD_STAT(occupancy, statistics::units::Tick::get(), "Layer occupancy (ticks)"),
     ADD_STAT(utilization, statistics::units::Ratio::get(), "Layer utilization")
 {
@@ -169,7 +170,16 @@ void BaseXBar::Layer<SrcType, DstType>::occupyLayer(Tick until)
 
     // until should never be 0 as express snoops never occupy the layer
     assert(until != 0);
-    xbar.schedule(releaseEvent, until);
+    assert(!releaseEvent.scheduled());
+    busyUntil = until;
+
+    // only spend an event on the release if it has something to do,
+    // a port waiting for a retry or a drain to complete, otherwise
+    // the next use of the layer releases it
+    if ((!waitingForLayer.empty() && waitingForPeer == NULL) ||
+        drainState() == DrainState::Draining) {
+        scheduleRelease();
+    }
 
     // account for the occupied ticks
     occupancy += until - curTick();
@@ -188,6 +198,9 @@ BaseXBar::Layer<SrcType, DstType>::tryTiming(SrcType* src_port)
     // this state again in zero time if the peer does not immediately
     // call the layer when receiving the retry
 
+    // release the layer if its reservation is over
+    checkRelease();
+
     // first we see if the layer is busy, next we check if the
     // destination port is already engaged in a transaction waiting
     // for a retry from the peer
@@ -201,10 +214,18 @@ BaseXBar::Layer<SrcType, DstType>::tryTiming(SrcType* src_port)
         // that transaction to go through, and then the layer to free
         // up)
         waitingForLayer.push_back(src_port);
+
+        // the port is retried when the reservation is over, unless
+        // we are waiting for the peer, in which case the retry from
+        // the peer takes care of it
+        if (waitingForPeer == NULL)
+            scheduleRelease();
         return false;
     }
 
+    // the reservation starts now, and ends once the packet is sent
     state = BUSY;
+    busyUntil = MaxTick;
 
     return true;
 }
@@ -243,6 +264,24 @@ BaseXBar::Layer<SrcType, DstType>::failedTiming(SrcType* src_port,
     occupyLayer(busy_time);
 }
 
+template <typename SrcType, typename DstType>
+void
+BaseXBar::Layer<SrcType, DstType>::retryTiming(SrcType* src_port,
+                                             Tick busy_time)
+{
+    // we should have gone from idle or retry to busy in the tryTiming
+    // test, which also means no one is waiting for the peer
+    assert(state == BUSY);
+    assert(waitingForPeer == NULL);
+
+    // the port gets its retry once the layer is released, after any
+    // port already waiting
+    waitingForLayer.push_back(src_port);
+
+    // occupy the layer accordingly, which schedules the release
+    occupyLayer(busy_time);
+}
+
 template <typename SrcType, typename DstType>
 void
 BaseXBar::Layer<SrcType, DstType>::releaseLayer()
@@ -310,6 +349,9 @@ BaseXBar::Layer<SrcType, DstType>::recvRetry()
     // something to this port
     assert(waitingForPeer != NULL);
 
+    // release the layer if its reservation is over
+    checkRelease();
+
     // add the port where the failed packet originated to the front of
     // the waiting ports for the layer, this allows us to call retry
     // on the port immediately if the crossbar layer is idle
@@ -324,6 +366,7 @@ BaseXBar::Layer<SrcType, DstType>::recvRetry()
         retryWaiting();
     } else {
         assert(state == BUSY);
+        scheduleRelease();
     }
 }
 
@@ -590,8 +633,11 @@ BaseXBar::Layer<SrcType, DstType>::drain()
     //We should check that we're not "doing" anything, and that noone is
     //waiting. We might be idle but have someone waiting if the device we
     //contacted for a retry didn't actually retry.
+    checkRelease();
     if (state != IDLE) {
         DPRINTF(Drain, "Crossbar not drained\n");
+        // the release event signals the end of the drain
+        scheduleRelease();
         return DrainState::Draining;
     } else {
         return DrainState::Drained;
@@ -46,6 +46,7 @@
 #ifndef __MEM_XBAR_HH__
 #define __MEM_XBAR_HH__
 
+#include <algorithm>
 #include <deque>
 #include <unordered_map>
 
@@ -149,6 +150,24 @@ class BaseXBar : public ClockedObject
          */
         void failedTiming(SrcType* src_port, Tick busy_time);
 
+        /**
+         * Deal with the crossbar itself not being able to take a
+         * packet yet, by adding the source port to the retry list and
+         * occupying the layer until it is retried.
+         *
+         * @param src_port Source port
+         * @param busy_time Time until the port is retried
+         */
+        void retryTiming(SrcType* src_port, Tick busy_time);
+
+        /**
+         * Reserve the layer until a given tick. The layer only
+         * schedules an event for the end of the reservation if a port
+         * is waiting for it, or if the layer is draining. Otherwise
+         * the layer is released when it is next used.
+         *
+         * @param until Tick at which the layer is free again
+         */
         void occupyLayer(Tick until);
 
         /**
@@ -199,11 +218,22 @@ class BaseXBar : public ClockedObject
          * in questions calls sendTiming and returns control to the
          * layer, or goes to a busy state if the port does not
          * immediately react to the retry by calling sendTiming.
+         *
+         * Rather than scheduling an event at the end of every packet,
+         * the busy state is a reservation until busyUntil, and the
+         * release event is only scheduled if there is a port to retry
+         * or a drain to complete.
          */
         enum State { IDLE, BUSY, RETRY };
 
         State state;
 
+        /**
+         * End of the current reservation of a busy layer. MaxTick
+         * while the layer has accepted a packet that is not yet sent.
+         */
+        Tick busyUntil;
+
         /**
          * A deque of ports that retry should be called on because
          * the original send was delayed due to a busy layer.
@@ -224,6 +254,34 @@ class BaseXBar : public ClockedObject
         void releaseLayer();
         EventFunctionWrapper releaseEvent;
 
+        /**
+         * Go back to idle if the reservation is over and no one is
+         * waiting for the release event to retry them.
+         */
+        void
+        checkRelease()
+        {
+            if (state == BUSY && curTick() >= busyUntil &&
+                !releaseEvent.scheduled()) {
+                assert(waitingForLayer.empty() || waitingForPeer != NULL);
+                state = IDLE;
+            }
+        }
+
+        /**
+         * Make sure the release event happens at the end of the
+         * current reservation, if the layer is busy and the packet
+         * occupying it has been sent.
+         */
+        void
+        scheduleRelease()
+        {
+            if (state == BUSY && busyUntil != MaxTick &&
+                !releaseEvent.scheduled()) {
+                xbar.schedule(releaseEvent, std::max(busyUntil, curTick()));
+            }
+        }
+
         /**
          * Stats for occupancy and utilization. These stats capture
          * the time the layer spends in the busy state and are thus only
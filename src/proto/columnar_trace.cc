@@ -0,0 +1,460 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of streams for packet traces in a columnar format.
+ */
+
+#include "proto/columnar_trace.hh"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+void
+putVarint(std::vector<uint8_t> &buf, uint64_t value)
+{
+    while (value >= 0x80) {
+        buf.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    buf.push_back(uint8_t(value));
+}
+
+/** Store the difference of two values, zigzag encoded */
+void
+putDelta(std::vector<uint8_t> &buf, uint64_t value, uint64_t prev)
+{
+    const int64_t delta = int64_t(value - prev);
+    putVarint(buf, (uint64_t(delta) << 1) ^ uint64_t(delta >> 63));
+}
+
+void
+putString(std::vector<uint8_t> &buf, const std::string &str)
+{
+    putVarint(buf, str.size());
+    buf.insert(buf.end(), str.begin(), str.end());
+}
+
+void
+put32(uint8_t *buf, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        buf[i] = uint8_t(value >> (8 * i));
+}
+
+uint32_t
+get32(const uint8_t *buf)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= uint32_t(buf[i]) << (8 * i);
+    return value;
+}
+
+/**
+ * Decode a varint from a buffer.
+ *
+ * @param pos Position in the buffer, moved past the varint
+ * @param end End of the buffer
+ * @param value The decoded value
+ * @return False if the buffer ends before the varint
+ */
+bool
+getVarint(const uint8_t *&pos, const uint8_t *end, uint64_t &value)
+{
+    value = 0;
+    for (unsigned shift = 0; pos != end && shift < 64; shift += 7) {
+        const uint8_t byte = *pos++;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+uint64_t
+undoDelta(uint64_t zigzag, uint64_t prev)
+{
+    const int64_t delta = int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1);
+    return prev + uint64_t(delta);
+}
+
+/** Decode a varint from a stream, return false at the end of the stream */
+bool
+readVarint(std::istream &stream, uint64_t &value)
+{
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        const int byte = stream.get();
+        if (byte == std::char_traits<char>::eof())
+            return false;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool
+readString(std::istream &stream, std::string &str)
+{
+    uint64_t size;
+    if (!readVarint(stream, size))
+        return false;
+    str.resize(size);
+    stream.read(str.data(), size);
+    return stream.good();
+}
+
+} // anonymous namespace
+
+ColumnarTraceOutputStream::ColumnarTraceOutputStream(
+        const std::string &filename, bool compress) :
+    fileName(filename),
+    fileStream(filename.c_str(),
+               std::ios::out | std::ios::binary | std::ios::trunc),
+    compressBlocks(compress), headerWritten(false),
+    closing(false), failed(false)
+{
+    if (!fileStream.good())
+        panic("Could not open %s for writing\n", filename);
+
+    // Write the magic number and the version to the file
+    uint8_t version_bytes[4];
+    put32(version_bytes, version);
+    fileStream.write(magic, sizeof(magic));
+    fileStream.write((const char *)version_bytes, sizeof(version_bytes));
+
+    records.reserve(RecordsPerBlock);
+    writer = std::thread([this]() { processBlocks(); });
+}
+
+ColumnarTraceOutputStream::~ColumnarTraceOutputStream()
+{
+    if (!records.empty())
+        flushBlock();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    blockPending.notify_one();
+    writer.join();
+
+    if (failed)
+        warn("Could not write all of the trace to %s\n", fileName);
+    fileStream.close();
+}
+
+void
+ColumnarTraceOutputStream::writeHeader(const PacketTraceHeader &header)
+{
+    panic_if(headerWritten || !records.empty(),
+             "The header of %s must be written first, and once\n", fileName);
+
+    std::vector<uint8_t> buf;
+    putString(buf, header.objId);
+    putVarint(buf, header.tickFreq);
+    putVarint(buf, header.idStrings.size());
+    for (const auto &[id, str] : header.idStrings) {
+        putVarint(buf, id);
+        putString(buf, str);
+    }
+
+    // No block is pending yet, so the file is not shared
+    fileStream.write((const char *)buf.data(), buf.size());
+    headerWritten = true;
+}
+
+void
+ColumnarTraceOutputStream::write(const PacketTraceRecord &record)
+{
+    assert(headerWritten);
+    records.push_back(record);
+    if (records.size() == RecordsPerBlock)
+        flushBlock();
+}
+
+void
+ColumnarTraceOutputStream::flushBlock()
+{
+    // Encode the columns, each field as a difference to the field of
+    // the previous record when the values are correlated
+    EncodedBlock block;
+    block.numRecords = records.size();
+    block.columns.reserve(records.size() * 12);
+
+    Tick prev_tick = 0;
+    for (const auto &record : records) {
+        putDelta(block.columns, record.tick, prev_tick);
+        prev_tick = record.tick;
+    }
+    for (const auto &record : records)
+        putVarint(block.columns, record.cmd);
+    Addr prev_addr = 0;
+    for (const auto &record : records) {
+        putDelta(block.columns, record.addr, prev_addr);
+        prev_addr = record.addr;
+    }
+    for (const auto &record : records)
+        putVarint(block.columns, record.size);
+    for (const auto &record : records)
+        putVarint(block.columns, record.flags);
+    uint64_t prev_id = 0;
+    for (const auto &record : records) {
+        putDelta(block.columns, record.pktId, prev_id);
+        prev_id = record.pktId;
+    }
+    Addr prev_pc = 0;
+    for (const auto &record : records) {
+        putDelta(block.columns, record.pc, prev_pc);
+        prev_pc = record.pc;
+    }
+    records.clear();
+
+    // Hand the block to the background thread, waiting for it to catch
+    // up if too many blocks are pending
+    std::unique_lock<std::mutex> lock(mutex);
+    blockTaken.wait(lock, [this]() {
+        return pending.size() < MaxPendingBlocks;
+    });
+    panic_if(failed, "Could not write to %s\n", fileName);
+    pending.push_back(std::move(block));
+    lock.unlock();
+    blockPending.notify_one();
+}
+
+void
+ColumnarTraceOutputStream::processBlocks()
+{
+    std::vector<uint8_t> compressed;
+    while (true) {
+        EncodedBlock block;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            blockPending.wait(lock, [this]() {
+                return !pending.empty() || closing;
+            });
+            if (pending.empty())
+                return;
+            block = std::move(pending.front());
+            pending.pop_front();
+        }
+        blockTaken.notify_one();
+
+        // Only keep the compressed block if compression helps
+        const uint8_t *data = block.columns.data();
+        uLongf size = block.columns.size();
+        uint8_t is_compressed = 0;
+        if (compressBlocks) {
+            uLongf compressed_size = compressBound(block.columns.size());
+            compressed.resize(compressed_size);
+            if (compress2(compressed.data(), &compressed_size,
+                          block.columns.data(), block.columns.size(),
+                          Z_BEST_SPEED) == Z_OK &&
+                compressed_size < size) {
+                data = compressed.data();
+                size = compressed_size;
+                is_compressed = 1;
+            }
+        }
+
+        uint8_t header[BlockHeaderSize];
+        put32(header, block.numRecords);
+        put32(header + 4, block.columns.size());
+        put32(header + 8, size);
+        header[12] = is_compressed;
+        fileStream.write((const char *)header, sizeof(header));
+        fileStream.write((const char *)data, size);
+
+        if (!fileStream.good()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            failed = true;
+        }
+    }
+}
+
+ColumnarTraceInputStream::ColumnarTraceInputStream(
+        const std::string &filename) :
+    fileStream(filename.c_str(), std::ios::in | std::ios::binary),
+    fileName(filename), nextRecord(0)
+{
+    if (!fileStream.good())
+        panic("Could not open %s for reading\n", filename);
+
+    char magic_check[sizeof(magic)];
+    uint8_t version_bytes[4];
+    fileStream.read(magic_check, sizeof(magic_check));
+    fileStream.read((char *)version_bytes, sizeof(version_bytes));
+    if (!fileStream.good() ||
+        std::memcmp(magic_check, magic, sizeof(magic)) != 0) {
+        panic("Input file %s is not a valid gem5 columnar trace.\n",
+              filename);
+    }
+    if (get32(version_bytes) != version) {
+        panic("Input file %s has an unsupported columnar trace version "
+              "%d.\n", filename, get32(version_bytes));
+    }
+
+    uint64_t num_ids;
+    if (!readString(fileStream, _header.objId) ||
+        !readVarint(fileStream, _header.tickFreq) ||
+        !readVarint(fileStream, num_ids)) {
+        panic("Failed to read the header of %s\n", filename);
+    }
+    for (uint64_t i = 0; i < num_ids; i++) {
+        uint64_t id;
+        std::string str;
+        if (!readVarint(fileStream, id) || !readString(fileStream, str))
+            panic("Failed to read the header of %s\n", filename);
+        _header.idStrings.emplace_back(id, std::move(str));
+    }
+
+    firstBlock = fileStream.tellg();
+}
+
+bool
+ColumnarTraceInputStream::isColumnarTrace(const std::string &filename)
+{
+    std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+    char magic_check[sizeof(magic)];
+    stream.read(magic_check, sizeof(magic_check));
+    return stream.good() &&
+        std::memcmp(magic_check, magic, sizeof(magic)) == 0;
+}
+
+bool
+ColumnarTraceInputStream::read(PacketTraceRecord &record)
+{
+    // Skip to the next non-empty block
+    while (nextRecord == records.size()) {
+        if (!readBlock())
+            return false;
+    }
+    record = records[nextRecord++];
+    return true;
+}
+
+void
+ColumnarTraceInputStream::reset()
+{
+    // Seek to the first block and clear any flags
+    fileStream.clear();
+    fileStream.seekg(firstBlock);
+    records.clear();
+    nextRecord = 0;
+}
+
+bool
+ColumnarTraceInputStream::readBlock()
+{
+    uint8_t header[BlockHeaderSize];
+    fileStream.read((char *)header, sizeof(header));
+    if (fileStream.gcount() == 0)
+        return false;
+    panic_if(fileStream.gcount() != sizeof(header),
+             "Truncated block header in %s\n", fileName);
+
+    const uint32_t num_records = get32(header);
+    const uint32_t columns_size = get32(header + 4);
+    const uint32_t stored_size = get32(header + 8);
+    const bool is_compressed = header[12];
+
+    fileBuffer.resize(stored_size);
+    fileStream.read((char *)fileBuffer.data(), stored_size);
+    panic_if(fileStream.gcount() != stored_size, "Truncated block in %s\n",
+             fileName);
+
+    const uint8_t *pos = fileBuffer.data();
+    if (is_compressed) {
+        columnBuffer.resize(columns_size);
+        uLongf size = columns_size;
+        panic_if(uncompress(columnBuffer.data(), &size, fileBuffer.data(),
+                            stored_size) != Z_OK || size != columns_size,
+                 "Failed to decompress a block of %s\n", fileName);
+        pos = columnBuffer.data();
+    } else {
+        panic_if(stored_size != columns_size, "Corrupted block in %s\n",
+                 fileName);
+    }
+    const uint8_t *end = pos + columns_size;
+
+    // Decode the columns, in the order they were encoded
+    records.resize(num_records);
+    bool valid = true;
+    uint64_t value = 0;
+    uint64_t prev = 0;
+    for (auto &record : records) {
+        valid &= getVarint(pos, end, value);
+        record.tick = prev = undoDelta(value, prev);
+    }
+    for (auto &record : records) {
+        valid &= getVarint(pos, end, value);
+        record.cmd = value;
+    }
+    prev = 0;
+    for (auto &record : records) {
+        valid &= getVarint(pos, end, value);
+        record.addr = prev = undoDelta(value, prev);
+    }
+    for (auto &record : records) {
+        valid &= getVarint(pos, end, value);
+        record.size = value;
+    }
+    for (auto &record : records) {
+        valid &= getVarint(pos, end, value);
+        record.flags = value;
+    }
+    prev = 0;
+    for (auto &record : records) {
+        valid &= getVarint(pos, end, value);
+        record.pktId = prev = undoDelta(value, prev);
+    }
+    prev = 0;
+    for (auto &record : records) {
+        valid &= getVarint(pos, end, value);
+        record.pc = prev = undoDelta(value, prev);
+    }
+    panic_if(!valid || pos != end, "Corrupted block in %s\n", fileName);
+
+    nextRecord = 0;
+    return true;
+}
+
+} // namespace gem5
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of streams for packet traces in a columnar format.
+ */
+
+#ifndef __PROTO_COLUMNAR_TRACE_HH__
+#define __PROTO_COLUMNAR_TRACE_HH__
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/**
+ * Header of a packet trace: the object that captured the trace, the
+ * tick frequency of the packet time stamps, and the names of the
+ * requestor ids.
+ */
+struct PacketTraceHeader
+{
+    std::string objId;
+    uint64_t tickFreq = 0;
+    std::vector<std::pair<uint32_t, std::string>> idStrings;
+};
+
+/**
+ * A packet of a trace, with the same fields as the protobuf Packet
+ * message. The optional fields are 0 when they are not set.
+ */
+struct PacketTraceRecord
+{
+    Tick tick = 0;
+    uint32_t cmd = 0;
+    Addr addr = 0;
+    uint32_t size = 0;
+    uint32_t flags = 0;
+    uint64_t pktId = 0;
+    Addr pc = 0;
+};
+
+/**
+ * A columnar trace stores the packets in blocks of up to RecordsPerBlock
+ * records. Within a block, each field is stored as a column, and the
+ * columns are stored one after the other. The ticks, addresses, packet
+ * ids and PCs are stored as differences to the field of the previous
+ * record of the block, and all values are LEB128 varints (zigzag
+ * encoded when signed). Each block is optionally compressed with zlib
+ * on its own, so that blocks can be decoded independently.
+ *
+ * The file starts with a magic number, the format version, and the
+ * header of the trace. Each block starts with its number of records,
+ * the size of its columns, its size in the file, and whether it is
+ * compressed, all as little-endian 32-bit values.
+ */
+class ColumnarTraceStream
+{
+  public:
+    /** Maximum number of records in a block */
+    static constexpr size_t RecordsPerBlock = 4096;
+
+  protected:
+    /** Magic number at the start of a columnar trace */
+    static constexpr char magic[8] = {'g', '5', 'c', 'o', 'l', 't', 'r',
+                                      'c'};
+
+    /** Version of the format */
+    static constexpr uint32_t version = 1;
+
+    /** Size of the header of a block */
+    static constexpr size_t BlockHeaderSize = 13;
+
+    ColumnarTraceStream() = default;
+
+    ColumnarTraceStream(const ColumnarTraceStream &) = delete;
+    ColumnarTraceStream &operator=(const ColumnarTraceStream &) = delete;
+};
+
+/**
+ * An output stream of a columnar packet trace. The records are encoded
+ * as they are written, and each full block is handed to a background
+ * thread, that compresses it and writes it to the file. The number of
+ * blocks waiting for the background thread is bounded, so that a slow
+ * disk throttles the writer instead of buffering the whole trace.
+ */
+class ColumnarTraceOutputStream : public ColumnarTraceStream
+{
+  public:
+    /**
+     * Create an output stream for a given file name.
+     *
+     * @param filename Path to the file to create or truncate
+     * @param compress Whether to compress the blocks
+     */
+    ColumnarTraceOutputStream(const std::string &filename, bool compress);
+
+    /**
+     * Destruct the output stream, after writing all the blocks.
+     */
+    ~ColumnarTraceOutputStream();
+
+    /**
+     * Write the header of the trace. It must be written before any
+     * record.
+     *
+     * @param header The header
+     */
+    void writeHeader(const PacketTraceHeader &header);
+
+    /**
+     * Write a record to the stream.
+     *
+     * @param record The record
+     */
+    void write(const PacketTraceRecord &record);
+
+  private:
+    /** Encode the pending records in a block for the background thread */
+    void flushBlock();
+
+    /** Main loop of the background thread */
+    void processBlocks();
+
+    /** Maximum number of blocks waiting for the background thread */
+    static constexpr size_t MaxPendingBlocks = 16;
+
+    /** The columns of a block, before compression */
+    struct EncodedBlock
+    {
+        uint32_t numRecords;
+        std::vector<uint8_t> columns;
+    };
+
+    const std::string fileName;
+
+    std::ofstream fileStream;
+
+    /** Whether to compress the blocks */
+    const bool compressBlocks;
+
+    /** Whether the header of the trace was written */
+    bool headerWritten;
+
+    /** Records of the block being filled */
+    std::vector<PacketTraceRecord> records;
+
+    /** Encoded blocks waiting to be compressed and written */
+    std::deque<EncodedBlock> pending;
+
+    std::mutex mutex;
+
+    /** Signaled when a block is pending, or when closing */
+    std::condition_variable blockPending;
+
+    /** Signaled when the background thread takes a block */
+    std::condition_variable blockTaken;
+
+    /** Set when the stream is destructed */
+    bool closing;
+
+    /** Set by the background thread if the file cannot be written */
+    bool failed;
+
+    std::thread writer;
+};
+
+/**
+ * An input stream of a columnar packet trace. It decodes a whole block
+ * at a time, and returns its records one by one.
+ */
+class ColumnarTraceInputStream : public ColumnarTraceStream
+{
+  public:
+    /**
+     * Create an input stream for a given file name, and read the header
+     * of the trace.
+     *
+     * @param filename Path to the file to read from
+     */
+    ColumnarTraceInputStream(const std::string &filename);
+
+    /**
+     * Check whether a file is a columnar trace.
+     *
+     * @param filename Path to the file
+     * @return True if the file starts with the magic number
+     */
+    static bool isColumnarTrace(const std::string &filename);
+
+    /** The header of the trace */
+    const PacketTraceHeader &header() const { return _header; }
+
+    /**
+     * Read a record from the stream.
+     *
+     * @param record Record read from the stream
+     * @return True if a record was read, false at the end of the trace
+     */
+    bool read(PacketTraceRecord &record);
+
+    /**
+     * Reset the input stream to the first record of the trace.
+     */
+    void reset();
+
+  private:
+    /**
+     * Read and decode the next block.
+     *
+     * @return False at the end of the trace
+     */
+    bool readBlock();
+
+    std::ifstream fileStream;
+
+    /** Hold on to the file name for error messages */
+    const std::string fileName;
+
+    PacketTraceHeader _header;
+
+    /** Position of the first block in the file */
+    std::streampos firstBlock;
+
+    /** Records of the current block */
+    std::vector<PacketTraceRecord> records;
+
+    /** Index of the next record to read in the current block */
+    size_t nextRecord;
+
+    /** Buffers for the block read from the file, and its columns */
+    std::vector<uint8_t> fileBuffer;
+    std::vector<uint8_t> columnBuffer;
+};
+
+} // namespace gem5
+
+#endif //__PROTO_COLUMNAR_TRACE_HH__
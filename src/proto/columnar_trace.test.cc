@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "proto/columnar_trace.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** A temporary file, deleted when going out of scope */
+class TempFile
+{
+  public:
+    TempFile()
+    {
+        char name[] = "columnar-trace-XXXXXX";
+        const int fd = mkstemp(name);
+        EXPECT_NE(-1, fd);
+        close(fd);
+        fileName = name;
+    }
+
+    ~TempFile() { unlink(fileName.c_str()); }
+
+    const std::string &name() const { return fileName; }
+
+  private:
+    std::string fileName;
+};
+
+PacketTraceHeader
+makeHeader()
+{
+    PacketTraceHeader header;
+    header.objId = "system.monitor";
+    header.tickFreq = 1000000000000ULL;
+    header.idStrings = {{0, "writebacks"}, {5, "system.cpu.inst"},
+                        {0xffff, ""}};
+    return header;
+}
+
+/**
+ * Write records to a trace, then read them back, twice to check that
+ * resetting the stream starts over from the first record.
+ */
+void
+roundTrip(const std::vector<PacketTraceRecord> &records, bool compress)
+{
+    TempFile file;
+    const PacketTraceHeader header = makeHeader();
+    {
+        ColumnarTraceOutputStream out(file.name(), compress);
+        out.writeHeader(header);
+        for (const auto &record : records)
+            out.write(record);
+    }
+
+    ASSERT_TRUE(ColumnarTraceInputStream::isColumnarTrace(file.name()));
+    ColumnarTraceInputStream in(file.name());
+    EXPECT_EQ(in.header().objId, header.objId);
+    EXPECT_EQ(in.header().tickFreq, header.tickFreq);
+    EXPECT_EQ(in.header().idStrings, header.idStrings);
+
+    for (int pass = 0; pass < 2; pass++) {
+        PacketTraceRecord record;
+        for (size_t i = 0; i < records.size(); i++) {
+            ASSERT_TRUE(in.read(record));
+            EXPECT_EQ(record.tick, records[i].tick);
+            EXPECT_EQ(record.cmd, records[i].cmd);
+            EXPECT_EQ(record.addr, records[i].addr);
+            EXPECT_EQ(record.size, records[i].size);
+            EXPECT_EQ(record.flags, records[i].flags);
+            EXPECT_EQ(record.pktId, records[i].pktId);
+            EXPECT_EQ(record.pc, records[i].pc);
+        }
+        EXPECT_FALSE(in.read(record));
+        in.reset();
+    }
+}
+
+} // anonymous namespace
+
+/** A trace without records only holds its header. */
+TEST(ColumnarTraceTest, Empty)
+{
+    roundTrip({}, false);
+    roundTrip({}, true);
+}
+
+/**
+ * Packets of a memory trace, over several blocks and a partial one. The
+ * fields take arbitrary values, so that the deltas to the previous
+ * record are large and of both signs.
+ */
+TEST(ColumnarTraceTest, Packets)
+{
+    std::mt19937_64 gen(0);
+    std::vector<PacketTraceRecord> records(
+        2 * ColumnarTraceStream::RecordsPerBlock + 123);
+    Tick tick = 0;
+    for (auto &record : records) {
+        tick += gen() % 1000;
+        record.tick = tick;
+        record.cmd = gen() % 2 ? 1 : 4;
+        record.addr = gen() % 4 ? (gen() & ~0x3fULL) : gen();
+        record.size = gen() % 4 ? 64 : gen() % 0x100000000ULL;
+        record.flags = gen() % 0x100000000ULL;
+        record.pktId = gen() % 2 ? 0 : gen();
+        record.pc = gen() % 2 ? 0 : gen();
+    }
+
+    roundTrip(records, false);
+    roundTrip(records, true);
+}
+
+/**
+ * Instruction fetches, as read by the TraceCPU: sequential PCs with an
+ * occasional branch, fetched at the address of the PC.
+ */
+TEST(ColumnarTraceTest, InstructionRecords)
+{
+    std::mt19937_64 gen(0);
+    std::vector<PacketTraceRecord> records(
+        ColumnarTraceStream::RecordsPerBlock + 1);
+    Tick tick = 0;
+    Addr pc = 0x400000;
+    for (auto &record : records) {
+        tick += 500 * (1 + gen() % 4);
+        pc = gen() % 8 ? pc + 4 : 0x400000 + (gen() % 0x10000) * 4;
+        record.tick = tick;
+        record.cmd = 1;
+        record.addr = pc;
+        record.size = 4;
+        record.flags = 0x100;
+        record.pc = pc;
+    }
+
+    roundTrip(records, false);
+    roundTrip(records, true);
+}
+
+/** Files that do not start with the magic number are not columnar. */
+TEST(ColumnarTraceTest, NotColumnar)
+{
+    TempFile file;
+    {
+        std::ofstream out(file.name(), std::ios::binary);
+        out << "gem5 protobuf trace";
+    }
+    EXPECT_FALSE(ColumnarTraceInputStream::isColumnarTrace(file.name()));
+    EXPECT_FALSE(ColumnarTraceInputStream::isColumnarTrace(
+        file.name() + ".missing"));
+}
@@ -37,6 +37,11 @@
 
 #include "proto/protoio.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <string>
 
 #include "base/logging.hh"
@@ -102,7 +107,7 @@ ProtoOutputStream::write(const Message& msg)
 
 ProtoInputStream::ProtoInputStream(const std::string& filename) :
     fileStream(filename.c_str(), std::ios::in | std::ios::binary),
-    fileName(filename), useGzip(false),
+    fileName(filename), useGzip(false), mappedFile(NULL), mappedSize(0),
     wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
 {
     if (!fileStream.good())
@@ -117,9 +122,32 @@ ProtoInputStream::ProtoInputStream(const std::string& filename) :
     fileStream.clear();
     fileStream.seekg(0, std::ifstream::beg);
 
+    if (!useGzip)
+        mapFile();
+
     createStreams();
 }
 
+void
+ProtoInputStream::mapFile()
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    // Fall back to the file stream if the file cannot be mapped
+    off_t size = lseek(fd, 0, SEEK_END);
+    if (size > 0) {
+        void* addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            madvise(addr, size, MADV_SEQUENTIAL);
+            mappedFile = static_cast<const char*>(addr);
+            mappedSize = size;
+        }
+    }
+    close(fd);
+}
+
 void
 ProtoInputStream::createStreams()
 {
@@ -130,12 +158,27 @@ ProtoInputStream::createStreams()
     // Wrap the input file in a zero copy stream, that in turn is
     // wrapped in a gzip stream if the filename ends with .gz. The
     // latter stream is in turn wrapped in a coded stream
-    wrappedFileStream = new io::IstreamInputStream(&fileStream);
-    if (useGzip) {
-        gzipStream = new io::GzipInputStream(wrappedFileStream);
-        zeroCopyStream = gzipStream;
+    if (mappedFile != NULL) {
+        // An array stream covers at most 2 GiB, so a larger file is
+        // covered by several of them
+        for (size_t offset = 0; offset < mappedSize;
+             offset += mappedChunkSize) {
+            size_t size = std::min(mappedChunkSize, mappedSize - offset);
+            mappedChunks.emplace_back(
+                new io::ArrayInputStream(mappedFile + offset, size));
+            mappedChunkPtrs.push_back(mappedChunks.back().get());
+        }
+        mappedStream.reset(new io::ConcatenatingInputStream(
+            mappedChunkPtrs.data(), mappedChunkPtrs.size()));
+        zeroCopyStream = mappedStream.get();
     } else {
-        zeroCopyStream = wrappedFileStream;
+        wrappedFileStream = new io::IstreamInputStream(&fileStream);
+        if (useGzip) {
+            gzipStream = new io::GzipInputStream(wrappedFileStream);
+            zeroCopyStream = gzipStream;
+        } else {
+            zeroCopyStream = wrappedFileStream;
+        }
     }
 
     uint32_t magic_check;
@@ -157,6 +200,10 @@ ProtoInputStream::destroyStreams()
     delete wrappedFileStream;
     wrappedFileStream = NULL;
 
+    mappedStream.reset();
+    mappedChunkPtrs.clear();
+    mappedChunks.clear();
+
     zeroCopyStream = NULL;
 }
 
@@ -164,6 +211,8 @@ ProtoInputStream::destroyStreams()
 ProtoInputStream::~ProtoInputStream()
 {
     destroyStreams();
+    if (mappedFile != NULL)
+        munmap(const_cast<char*>(mappedFile), mappedSize);
     fileStream.close();
 }
 
@@ -49,7 +49,13 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
 
+#include <atomic>
+#include <cassert>
+#include <chrono>
 #include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
 
 /**
  * A ProtoStream provides the shared functionality of the input and
@@ -143,8 +149,9 @@ class ProtoInputStream : public ProtoStream
   public:
 
     /**
-     * Create an input stream for a given file name. If the filename
-     * ends with .gz then the file will be decompressed accordingly.
+     * Create an input stream for a given file name. If the file is
+     * compressed with gzip, it is decompressed accordingly, otherwise
+     * it is mapped in memory.
      *
      * @param filename Path to the file to read from
      */
@@ -181,6 +188,15 @@ class ProtoInputStream : public ProtoStream
      */
     void destroyStreams();
 
+    /**
+     * Map an uncompressed file in memory, so that the messages are
+     * parsed in place instead of being copied out of the file stream.
+     */
+    void mapFile();
+
+    /// Largest part of the mapped file a single array stream covers
+    static constexpr size_t mappedChunkSize = 1 << 30;
+
     /// Underlying file input stream
     std::ifstream fileStream;
 
@@ -190,6 +206,23 @@ class ProtoInputStream : public ProtoStream
     /// Boolean flag to remember whether we use gzip or not
     bool useGzip;
 
+    /// The file mapped in memory, or NULL if it is not mapped
+    const char* mappedFile;
+
+    /// Size of the mapped file
+    size_t mappedSize;
+
+    /// Array streams covering the mapped file, in order
+    std::vector<std::unique_ptr<google::protobuf::io::ArrayInputStream>>
+        mappedChunks;
+
+    /// Array of the array streams, as the concatenating stream needs it
+    std::vector<google::protobuf::io::ZeroCopyInputStream*> mappedChunkPtrs;
+
+    /// Stream over the array streams of the mapped file
+    std::unique_ptr<google::protobuf::io::ConcatenatingInputStream>
+        mappedStream;
+
     /// Zero Copy stream wrapping the STL input stream
     google::protobuf::io::IstreamInputStream* wrappedFileStream;
 
@@ -201,4 +234,133 @@ class ProtoInputStream : public ProtoStream
 
 };
 
+/**
+ * A ProtoReadAhead parses the messages of a ProtoInputStream in a
+ * background thread, ahead of the reader, so that the decompression and
+ * parsing of the trace overlap with the simulation. The parsed messages
+ * are kept in a bounded single-producer single-consumer ring, which the
+ * two threads synchronise on without locks.
+ *
+ * The input stream must not be used while the read-ahead is started.
+ *
+ * @tparam Message Type of the messages to read
+ */
+template <class Message>
+class ProtoReadAhead
+{
+
+  public:
+
+    /**
+     * Create a read-ahead for a stream, without starting it.
+     *
+     * @param stream Stream to read the messages from
+     * @param capacity Number of messages to read ahead, rounded up to a
+     *                 power of two
+     */
+    ProtoReadAhead(ProtoInputStream& stream, size_t capacity) :
+        stream(stream), head(0), tail(0), done(false), stopping(false)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        ring.resize(size);
+    }
+
+    ~ProtoReadAhead() { stop(); }
+
+    /**
+     * Start reading ahead from the current position of the stream.
+     */
+    void
+    start()
+    {
+        assert(!reader.joinable());
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        done.store(false, std::memory_order_relaxed);
+        stopping.store(false, std::memory_order_relaxed);
+        reader = std::thread([this]() { readMessages(); });
+    }
+
+    /**
+     * Stop reading ahead, and drop the messages read ahead. The stream
+     * is left after the last message read ahead.
+     */
+    void
+    stop()
+    {
+        if (reader.joinable()) {
+            stopping.store(true, std::memory_order_relaxed);
+            reader.join();
+        }
+    }
+
+    /**
+     * Read a message, waiting for the background thread if it is not
+     * ahead of the reader.
+     *
+     * @param msg Message read from the stream
+     * @return True if a message was read, false at the end of the stream
+     */
+    bool
+    read(Message& msg)
+    {
+        assert(reader.joinable());
+        const size_t pos = head.load(std::memory_order_relaxed);
+        while (pos == tail.load(std::memory_order_acquire)) {
+            // The end of the stream is set after the last message
+            if (done.load(std::memory_order_acquire) &&
+                pos == tail.load(std::memory_order_acquire))
+                return false;
+            std::this_thread::yield();
+        }
+        msg.Swap(&ring[pos & (ring.size() - 1)]);
+        head.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+
+    /** Main loop of the background thread */
+    void
+    readMessages()
+    {
+        while (!stopping.load(std::memory_order_relaxed)) {
+            const size_t pos = tail.load(std::memory_order_relaxed);
+            if (pos - head.load(std::memory_order_acquire) == ring.size()) {
+                // The reader is behind, which is the common case, so
+                // sleep rather than spin
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                continue;
+            }
+            if (!stream.read(ring[pos & (ring.size() - 1)])) {
+                done.store(true, std::memory_order_release);
+                return;
+            }
+            tail.store(pos + 1, std::memory_order_release);
+        }
+    }
+
+    ProtoInputStream& stream;
+
+    /// Messages read ahead, indexed by their position modulo the size
+    std::vector<Message> ring;
+
+    /// Position of the next message to read, written by the reader
+    std::atomic<size_t> head;
+
+    /// Position of the next message to parse, written by the thread
+    std::atomic<size_t> tail;
+
+    /// Set by the thread at the end of the stream
+    std::atomic<bool> done;
+
+    /// Set to stop the thread
+    std::atomic<bool> stopping;
+
+    std::thread reader;
+
+};
+
 #endif //__PROTO_PROTOIO_HH
@@ -0,0 +1,50 @@
+# Copyright (c) 2026 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Runs configs/dram/sweep.py with every FR-FCFS decision of the DRAM
+controller checked against a scan of the whole queue. The simulation
+panics if the two ever disagree.
+"""
+
+from testlib import *
+
+configs = {
+    'random-rd' : ['--mode', 'DRAM', '--rd_perc', '100'],
+    'random-mixed' : ['--mode', 'DRAM', '--rd_perc', '50', '-r', '2'],
+    'rotate-mixed' : ['--mode', 'DRAM_ROTATE', '--rd_perc', '70', '-r', '2'],
+}
+
+for name, args in configs.items():
+    gem5_verify_config(
+        name='test-dram-sweep-frfcfs-' + name,
+        fixtures=(),
+        verifiers=(),
+        config=joinpath(config.base_dir, 'configs', 'dram', 'sweep.py'),
+        config_args=['--check-frfcfs-index'] + args,
+        valid_isas=(constants.null_tag,),
+        valid_hosts=constants.supported_hosts,
+    )
@@ -0,0 +1,134 @@
+# Copyright (c) 2026 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Drive two identical DRAM controllers with the same traffic, separated by
+idle periods of many refresh intervals, one refreshing its ranks eagerly
+and the other with lazy_refresh. The refresh time, power state times and
+energy of every rank must match at the end.
+"""
+
+import argparse
+import sys
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument("--ranks", type=int, default=2,
+                    help="Ranks per channel")
+args = parser.parse_args()
+
+system = System()
+system.clk_domain = SrcClockDomain(clock = '2.0GHz',
+                                   voltage_domain =
+                                   VoltageDomain(voltage = '1V'))
+
+mem_size = 512 * 1024 * 1024
+system.mem_ranges = [AddrRange(0, size = mem_size),
+                     AddrRange(mem_size, size = mem_size)]
+system.mmap_using_noreserve = True
+
+def make_ctrl(mem_range, lazy_refresh):
+    intf = DDR4_2400_8x8(range = mem_range,
+                         ranks_per_channel = args.ranks,
+                         lazy_refresh = lazy_refresh)
+    intf.null = True
+    return MemCtrl(dram = intf)
+
+# each controller gets its own bus, so that their traffic does not
+# interfere
+system.eager_ctrl = make_ctrl(system.mem_ranges[0], False)
+system.lazy_ctrl = make_ctrl(system.mem_ranges[1], True)
+system.eager_bus = IOXBar(width = 32)
+system.lazy_bus = IOXBar(width = 32)
+system.eager_tgen = PyTrafficGen()
+system.lazy_tgen = PyTrafficGen()
+
+system.eager_ctrl.port = system.eager_bus.mem_side_ports
+system.lazy_ctrl.port = system.lazy_bus.mem_side_ports
+system.eager_tgen.port = system.eager_bus.cpu_side_ports
+system.lazy_tgen.port = system.lazy_bus.cpu_side_ports
+system.system_port = system.eager_bus.cpu_side_ports
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+# each busy period goes through 512kB, which covers the 128kB that
+# every rank gets in turn, and the idle periods cover many refresh
+# intervals, started at different points of the interval
+busy = 40000000
+idle = 100000000
+itt = 5000
+
+# the generators draw from the same random number generator, so their
+# traffic only matches if they only read or only write
+def traffic(i):
+    for read_percent, idle_time in [(100, idle), (0, idle + 3333333),
+                                    (100, idle)]:
+        yield tgens[i].createLinear(busy, starts[i],
+                                    starts[i] + mem_size - 1,
+                                    64, itt, itt, read_percent, 0)
+        yield tgens[i].createIdle(idle_time)
+    yield tgens[i].createIdle(10 * idle)
+
+tgens = [system.eager_tgen, system.lazy_tgen]
+starts = [0, mem_size]
+for i in range(len(tgens)):
+    tgens[i].start(traffic(i))
+
+m5.simulate(3 * (busy + idle) + 3333333 + idle // 2)
+
+# bring the stats of the lazy ranks up to date
+m5.stats.dump()
+
+ctrls = {"eager": system.eager_ctrl, "lazy": system.lazy_ctrl}
+def rank_stat(name, rank, stat):
+    return ctrls[name].dram.resolveStat("rank%d.%s" % (rank, stat)).value
+
+failed = False
+for rank in range(args.ranks):
+    for stat in ["actEnergy", "preEnergy", "readEnergy", "writeEnergy",
+                 "refreshEnergy", "actBackEnergy", "preBackEnergy",
+                 "totalEnergy", "totalIdleTime", "pwrStateTime"]:
+        eager = rank_stat("eager", rank, stat)
+        lazy = rank_stat("lazy", rank, stat)
+        if not isinstance(eager, list):
+            eager, lazy = [eager], [lazy]
+        for e, l in zip(eager, lazy):
+            if abs(e - l) > 1e-9 * abs(e):
+                print("rank%d.%s differs: %s eager, %s lazy" %
+                      (rank, stat, e, l))
+                failed = True
+
+    if rank_stat("eager", rank, "refreshEnergy") == 0:
+        print("rank%d was never refreshed" % rank)
+        failed = True
+
+if failed:
+    sys.exit(1)
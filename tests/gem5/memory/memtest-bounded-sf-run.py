@@ -0,0 +1,94 @@
+# Copyright (c) 2026 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Run the memory testers on top of a bounded snoop filter that is much
+smaller than the caches above it, so that it keeps evicting lines and
+asking the caches to evict them. The testers check the data they read,
+which fails if a cache is not invalidated or its writeback is lost.
+"""
+
+import argparse
+import sys
+
+import m5
+from m5.objects import *
+m5.util.addToPath('../../../configs/')
+from common.Caches import *
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument("--atomic", action="store_true",
+                    help="Use atomic instead of timing accesses")
+parser.add_argument("--victim-entries", type=int, default=4,
+                    help="Victim buffer entries of the snoop filter")
+args = parser.parse_args()
+
+nb_cores = 8
+cpus = [MemTest(max_loads = 1e5, progress_interval = 1e4)
+        for i in range(nb_cores) ]
+
+system = System(cpu = cpus,
+                physmem = SimpleMemory(),
+                membus = SystemXBar())
+system.voltage_domain = VoltageDomain()
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+system.cpu_clk_domain = SrcClockDomain(clock = '2GHz',
+                                       voltage_domain = system.voltage_domain)
+
+# the snoop filter tracks 128 lines, far fewer than the L1 caches hold
+system.toL2Bus = L2XBar(clk_domain = system.cpu_clk_domain)
+system.toL2Bus.snoop_filter.bounded = True
+system.toL2Bus.snoop_filter.max_capacity = '8kB'
+system.toL2Bus.snoop_filter.assoc = 4
+system.toL2Bus.snoop_filter.victim_entries = args.victim_entries
+
+system.l2c = L2Cache(clk_domain = system.cpu_clk_domain, size='64kB', assoc=8)
+system.l2c.cpu_side = system.toL2Bus.mem_side_ports
+system.l2c.mem_side = system.membus.cpu_side_ports
+
+for cpu in cpus:
+    cpu.clk_domain = system.cpu_clk_domain
+    cpu.l1c = L1Cache(size = '32kB', assoc = 4)
+    cpu.l1c.cpu_side = cpu.port
+    cpu.l1c.mem_side = system.toL2Bus.cpu_side_ports
+
+system.system_port = system.membus.cpu_side_ports
+system.physmem.port = system.membus.mem_side_ports
+
+root = Root( full_system = False, system = system )
+root.system.mem_mode = 'atomic' if args.atomic else 'timing'
+
+m5.instantiate()
+exit_event = m5.simulate()
+if exit_event.getCause() != "maximum number of loads reached":
+    sys.exit(1)
+
+# make sure the caches were asked to evict lines
+back_invals = system.toL2Bus.snoop_filter.resolveStat("backInvalidations")
+if back_invals.value == 0:
+    print("The snoop filter did not evict any line held above")
+    sys.exit(1)
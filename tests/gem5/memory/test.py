@@ -67,6 +67,34 @@ gem5_verify_config(
     valid_isas=(constants.null_tag,),
 )
 
+for name, args in [('timing', []),
+                   ('atomic', ['--atomic']),
+                   ('one-victim', ['--victim-entries', '1'])]:
+    gem5_verify_config(
+        name='memtest_bounded_snoop_filter_' + name,
+        verifiers=(), # No need for verfiers this will return non-zero on fail
+        config=joinpath(getcwd(), 'memtest-bounded-sf-run.py'),
+        config_args = args,
+        valid_isas=(constants.null_tag,),
+    )
+
+for ranks in [1, 2]:
+    gem5_verify_config(
+        name='dram_lazy_refresh_%d_ranks' % ranks,
+        verifiers=(), # No need for verfiers this will return non-zero on fail
+        config=joinpath(getcwd(), 'lazy-refresh-run.py'),
+        config_args = ['--ranks', str(ranks)],
+        valid_isas=(constants.null_tag,),
+    )
+
+gem5_verify_config(
+    name='multi_channel_mem_ctrl',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(config.base_dir, 'configs', 'dram', 'multi_channel.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
+
 null_tests = [
     ('garnet_synth_traffic', None, ['--sim-cycles', '5000000']),
     ('memcheck', None, ['--maxtick', '2000000000', '--prefetchers']),
@@ -85,6 +113,9 @@ null_tests = [
          '--num-cpus=4']),
     ('ruby_random_test', None, ['--maxloads', '5000']),
     ('ruby_direct_test', None, ['--requests', '50000']),
+    ('multi_stream_tgen', None, []),
+    ('multi_stream_tgen-linear', 'multi_stream_tgen',
+        ['--pattern', 'linear', '--period', '1']),
 ]
 
 for test_name, basename_noext, args in null_tests:
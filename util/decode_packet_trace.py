@@ -35,22 +35,122 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-# This script is used to dump protobuf packet traces to ASCII
-# format.
+# This script is used to dump protobuf and columnar packet traces to
+# ASCII format.
 
 import os
 import protolib
+import struct
 import subprocess
 import sys
+import zlib
 
 util_dir = os.path.dirname(os.path.realpath(__file__))
-# Make sure the proto definitions are up to date.
-subprocess.check_call(['make', '--quiet', '-C', util_dir, 'packet_pb2.py'])
-import packet_pb2
+
+def cmd_char(cmd):
+    # ReadReq is 1 and WriteReq is 4 in src/mem/packet.hh Command enum
+    return 'r' if cmd == 1 else ('w' if cmd == 4 else 'u')
+
+def get_varint(buf, pos):
+    """
+    Decode a LEB128 varint from a buffer, and return it with the
+    position after it.
+    """
+    value = 0
+    shift = 0
+    while True:
+        byte = buf[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+def read_varint(in_file):
+    """
+    Decode a LEB128 varint from a file.
+    """
+    value = 0
+    shift = 0
+    while True:
+        byte = in_file.read(1)
+        if not byte:
+            raise EOFError("Truncated trace header")
+        value |= (byte[0] & 0x7f) << shift
+        if not byte[0] & 0x80:
+            return value
+        shift += 7
+
+def read_string(in_file):
+    return in_file.read(read_varint(in_file)).decode()
+
+def decode_columnar(trace_in, ascii_out):
+    """
+    Decode a columnar trace, see src/proto/columnar_trace.hh, after its
+    magic number. The fields that the packets do not set are 0, so the
+    packet id and PC are only written when they are not.
+    """
+    version, = struct.unpack('<I', trace_in.read(4))
+    if version != 1:
+        print("Unsupported columnar trace version", version)
+        exit(-1)
+
+    print("Parsing packet header")
+
+    print("Object id:", read_string(trace_in))
+    print("Tick frequency:", read_varint(trace_in))
+    for i in range(read_varint(trace_in)):
+        key = read_varint(trace_in)
+        print('Master id %d: %s' % (key, read_string(trace_in)))
+
+    print("Parsing packets")
+
+    num_packets = 0
+    while True:
+        header = trace_in.read(13)
+        if not header:
+            break
+        num_records, columns_size, stored_size, compressed = \
+            struct.unpack('<IIIB', header)
+        columns = trace_in.read(stored_size)
+        if compressed:
+            columns = zlib.decompress(columns)
+        if len(columns) != columns_size:
+            print("Corrupted block after packet", num_packets)
+            exit(-1)
+
+        # The columns are, in order: tick, cmd, addr, size, flags, pkt_id
+        # and pc, with the tick, addr, pkt_id and pc stored as zigzag
+        # deltas to the previous record
+        pos = 0
+        fields = []
+        for delta in [True, False, True, False, False, True, True]:
+            values = []
+            prev = 0
+            for i in range(num_records):
+                value, pos = get_varint(columns, pos)
+                if delta:
+                    value = (value >> 1) ^ -(value & 1)
+                    value = prev = (prev + value) & (2**64 - 1)
+                values.append(value)
+            fields.append(values)
+
+        for tick, cmd, addr, size, flags, pkt_id, pc in zip(*fields):
+            if pkt_id:
+                ascii_out.write('%s,' % (pkt_id))
+            ascii_out.write('%s,%s,%s,%s,%s' % (cmd_char(cmd), addr, size,
+                            flags, tick))
+            if pc:
+                ascii_out.write(',%s\n' % (pc))
+            else:
+                ascii_out.write('\n')
+        num_packets += num_records
+
+    print("Parsed packets:", num_packets)
 
 def main():
     if len(sys.argv) != 3:
-        print("Usage: ", sys.argv[0], " <protobuf input> <ASCII output>")
+        print("Usage: ", sys.argv[0], " <trace input> <ASCII output>")
         exit(-1)
 
     # Open the file in read mode
@@ -63,12 +163,23 @@ def main():
         exit(-1)
 
     # Read the magic number in 4-byte Little Endian
-    magic_number = proto_in.read(4).decode()
+    magic_number = proto_in.read(4)
+
+    if magic_number == b"g5co" and proto_in.read(4) == b"ltrc":
+        decode_columnar(proto_in, ascii_out)
+        ascii_out.close()
+        proto_in.close()
+        return
 
-    if magic_number != "gem5":
+    if magic_number != b"gem5":
         print("Unrecognized file", sys.argv[1])
         exit(-1)
 
+    # Make sure the proto definitions are up to date.
+    subprocess.check_call(['make', '--quiet', '-C', util_dir,
+                           'packet_pb2.py'])
+    import packet_pb2
+
     print("Parsing packet header")
 
     # Add the packet header
@@ -89,8 +200,7 @@ def main():
     # Decode the packet messages until we hit the end of the file
     while protolib.decodeMessage(proto_in, packet):
         num_packets += 1
-        # ReadReq is 1 and WriteReq is 4 in src/mem/packet.hh Command enum
-        cmd = 'r' if packet.cmd == 1 else ('w' if packet.cmd == 4 else 'u')
+        cmd = cmd_char(packet.cmd)
         if packet.HasField('pkt_id'):
             ascii_out.write('%s,' % (packet.pkt_id))
         if packet.HasField('flags'):